@@ -27,6 +27,7 @@
 
 /* Keyple Cpp Example */
 #include "CalypsoConstants.h"
+#include "TimestampedCardReaderEvent.h"
 
 using namespace calypsonet::terminal::calypso::card;
 using namespace calypsonet::terminal::calypso::transaction;
@@ -60,7 +61,14 @@ void CardReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> ev
         /* Read the current time used later to compute the transaction time */
         const unsigned long long timeStamp = System::currentTimeMillis();
 
+        /* Timestamps available if the observer is placed behind a TimestampingCardReaderObserver */
+        auto timestampedEvent = std::dynamic_pointer_cast<TimestampedCardReaderEvent>(event);
+
         try {
+            if (timestampedEvent) {
+                timestampedEvent->markSelectionResultParseStart();
+            }
+
             /* The selection matched, get the resulting CalypsoCard */
             auto calypsoCard =
                 std::dynamic_pointer_cast<CalypsoCard>(
@@ -69,6 +77,10 @@ void CardReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> ev
                             event->getScheduledCardSelectionsResponse())
                         ->getActiveSmartCard());
 
+            if (timestampedEvent) {
+                timestampedEvent->markSelectionResultParseEnd();
+            }
+
             /*
              * Create a transaction manager, open a Secure Session, read Environment, Event Log and
              * Contract List.
@@ -108,6 +120,10 @@ void CardReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> ev
                           System::currentTimeMillis() - timeStamp,
                           ANSI_RESET);
 
+            if (timestampedEvent) {
+                timestampedEvent->logTimestamps(*mLogger);
+            }
+
         } catch (const Exception& e) {
             mLogger->error("%Transaction failed with exception: %%\n",
                            ANSI_RED,
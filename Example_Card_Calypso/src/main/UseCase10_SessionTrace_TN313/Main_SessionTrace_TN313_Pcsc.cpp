@@ -37,6 +37,8 @@
 #include "CalypsoConstants.h"
 #include "CardReaderObserver.h"
 #include "ConfigurationUtil.h"
+#include "DebouncingCardReaderObserver.h"
+#include "TimestampingCardReaderObserver.h"
 
 using namespace calypsonet::terminal::reader;
 using namespace keyple::card::calypso;
@@ -231,11 +233,19 @@ int main(int argc, char **argv)
                         .assignDefaultKif(WriteAccessLevel::DEBIT, 0x30)
                         .setControlSamResource(samReader, calypsoSam);
 
-    /* Create and add a card observer for this reader */
+    /*
+     * Create and add a card observer for this reader, behind a debouncing stage dropping a card
+     * bouncing at the edge of the field (its removal and its re-insertion, so that the session is
+     * not replayed) and a timestamping stage providing the observer with the latency of each event.
+     */
     auto cardReaderObserver =
         std::make_shared<CardReaderObserver>(cardReader, cardSelectionManager, cardSecuritySetting);
     observable->setReaderObservationExceptionHandler(cardReaderObserver);
-    observable->addObserver(cardReaderObserver);
+    observable->addObserver(
+        std::make_shared<TimestampingCardReaderObserver>(
+            std::make_shared<DebouncingCardReaderObserver>(cardReaderObserver,
+                                                           observable,
+                                                           cardSelectionManager)));
     observable->startCardDetection(ObservableCardReader::DetectionMode::REPEATING);
 
 
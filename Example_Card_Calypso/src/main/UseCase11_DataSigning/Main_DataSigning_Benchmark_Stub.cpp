@@ -0,0 +1,257 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Core Resource */
+#include "CardResourceProfileConfigurator.h"
+#include "CardResourceServiceProvider.h"
+#include "PluginsConfigurator.h"
+
+/* Keyple Cpp Example */
+#include "CardResourceAllocator.h"
+#include "ConfigurationUtil.h"
+#include "InstrumentedStubPluginFactory.h"
+#include "InstrumentedStubReader.h"
+#include "ParallelSigningEngine.h"
+#include "SamLatencyModel.h"
+#include "StubSmartCardFactory.h"
+
+using namespace keyple::card::calypso;
+using namespace keyple::core::service;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * <h1>Use Case Calypso 11 – Calypso Card data signing benchmark (Stub)</h1>
+ *
+ * <p>We measure here the signing throughput of the ParallelSigningEngine according to the batch
+ * size, the payload size and the number of SAMs, without any physical SAM. The same sweep being
+ * run on each version of the libraries, the tables output can be compared across versions.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a plugin with several instrumented stub SAM readers, each containing a stub SAM
+ *       answering the signature commands, the readers taking the processing time of a physical
+ *       SAM for each APDU exchanged (SamLatencyModel).
+ *   <li>For each batch size, payload size and number of SAMs, configure the card resource service
+ *       with the first SAM readers, and sign the same payloads with all the SAMs.
+ *   <li>Output a table of the signatures and bytes signed per second, the speedup compared to a
+ *       single SAM with the same batch and payload sizes, and the batches stolen between the SAMs.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ */
+class Main_DataSigning_Benchmark_Stub {};
+const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_DataSigning_Benchmark_Stub));
+
+static const std::string PLUGIN_NAME = "Instrumented stub plugin";
+static const std::string SAM_RESOURCE = "SAM_RESOURCE";
+static const std::string SAM_READER_NAME_PREFIX = "SAM_READER_";
+static const uint8_t KIF_BASIC = 0xEC;
+static const uint8_t KVC_BASIC = 0x85;
+
+static const std::vector<int> BATCH_SIZES = {1, 8, 32, 64};
+static const std::vector<int> PAYLOAD_SIZES = {16, 64, 192};
+static const std::vector<int> SAM_COUNTS = {1, 2, 4, 8};
+static const int PAYLOAD_COUNT = 512;
+
+/* PSO Compute Signature APDU, out of the payload: header, operation mode, KIF, KVC and Le */
+static const size_t PSO_COMMAND_OVERHEAD_BYTE_COUNT = 9;
+
+/* PSO Compute Signature response: 8-byte signature and status word */
+static const size_t PSO_RESPONSE_BYTE_COUNT = 10;
+
+/**
+ * Reader configurator used by the card resource service to set up the SAM readers.
+ */
+class ReaderConfigurator : public ReaderConfiguratorSpi {
+public:
+    /**
+     * {@inheritDoc}
+     */
+    void setupReader(std::shared_ptr<CardReader> reader) override
+    {
+        std::dynamic_pointer_cast<ConfigurableCardReader>(reader)
+            ->activateProtocol(ConfigurationUtil::SAM_PROTOCOL, ConfigurationUtil::SAM_PROTOCOL);
+    }
+};
+
+/**
+ * Returns payloads of the provided size, each one unique.
+ */
+static std::vector<std::vector<uint8_t>> createPayloads(const int count, const int size)
+{
+    std::vector<std::vector<uint8_t>> payloads;
+
+    for (int i = 0; i < count; i++) {
+        std::vector<uint8_t> payload(size, 0x5A);
+        payload[0] = static_cast<uint8_t>(i >> 8);
+        payload[1 % size] = static_cast<uint8_t>(i);
+        payloads.push_back(payload);
+    }
+
+    return payloads;
+}
+
+/**
+ * Signs the payloads with the provided number of SAMs and batch size.
+ *
+ * @return The signatures per second.
+ */
+static double run(std::shared_ptr<Plugin> plugin,
+                  const int samCount,
+                  const int batchSize,
+                  const std::vector<std::vector<uint8_t>>& payloads,
+                  uint64_t& stolenBatchCount)
+{
+    /* Create a SAM resource profile on the first SAM readers */
+    std::shared_ptr<CalypsoSamSelection> samSelection =
+        CalypsoExtensionService::getInstance()->createSamSelection();
+    samSelection->filterByProductType(CalypsoSam::ProductType::SAM_C1);
+
+    std::shared_ptr<CardResourceService> cardResourceService =
+        CardResourceServiceProvider::getService();
+
+    cardResourceService->getConfigurator()
+        ->withPlugins(PluginsConfigurator::builder()
+                          ->addPlugin(plugin, std::make_shared<ReaderConfigurator>())
+                           .build())
+         .withCardResourceProfiles(
+             {CardResourceProfileConfigurator::builder(
+                  SAM_RESOURCE,
+                  CalypsoExtensionService::getInstance()->createSamResourceProfileExtension(
+                      samSelection))
+                  ->withReaderNameRegex(SAM_READER_NAME_PREFIX +
+                                        "[0-" +
+                                        std::to_string(samCount - 1) +
+                                        "]")
+                   .build()})
+         .configure();
+    cardResourceService->start();
+
+    double signaturesPerSecond;
+    {
+        ParallelSigningEngine parallelSigningEngine(
+            std::make_shared<CardResourceAllocator>(cardResourceService),
+            SAM_RESOURCE,
+            CalypsoExtensionService::getInstance()->createSamSecuritySetting(),
+            KIF_BASIC,
+            KVC_BASIC,
+            batchSize);
+
+        parallelSigningEngine.sign(payloads);
+
+        signaturesPerSecond = parallelSigningEngine.getSignaturesPerSecond();
+        stolenBatchCount = parallelSigningEngine.getStolenBatchCount();
+    }
+
+    cardResourceService->stop();
+
+    return signaturesPerSecond;
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /*
+     * Register a plugin with a stub SAM in each SAM reader, the readers taking the time of a
+     * physical SAM for each exchange
+     */
+    const int maxSamCount = *std::max_element(SAM_COUNTS.begin(), SAM_COUNTS.end());
+    std::vector<std::shared_ptr<InstrumentedStubReader>> readers;
+    for (int i = 0; i < maxSamCount; i++) {
+        readers.push_back(
+            std::make_shared<InstrumentedStubReader>(SAM_READER_NAME_PREFIX + std::to_string(i),
+                                                     false,
+                                                     StubSmartCardFactory::createStubSignatureSam(),
+                                                     std::make_shared<SamLatencyModel>()));
+    }
+    std::shared_ptr<Plugin> plugin =
+        smartCardService->registerPlugin(
+            std::make_shared<InstrumentedStubPluginFactory>(PLUGIN_NAME, readers));
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(CalypsoExtensionService::getInstance());
+
+    const SamLatencyModel samLatencyModel;
+
+    logger->info("=============== " \
+                 "UseCase Calypso #11: data signing benchmark " \
+                 "==================\n");
+    logger->info("= % payloads per run\n", PAYLOAD_COUNT);
+    for (const int payloadSize : PAYLOAD_SIZES) {
+        logger->info("= simulated PSO Compute Signature APDU of a %-byte payload: % us\n",
+                     payloadSize,
+                     samLatencyModel.getLatencyUs(1,
+                                                  PSO_COMMAND_OVERHEAD_BYTE_COUNT +
+                                                  payloadSize +
+                                                  PSO_RESPONSE_BYTE_COUNT));
+    }
+    logger->info("batch size | payload size | SAMs | signatures/s | bytes/s | speedup | " \
+                 "stolen batches\n");
+
+    for (const int batchSize : BATCH_SIZES) {
+        for (const int payloadSize : PAYLOAD_SIZES) {
+            const std::vector<std::vector<uint8_t>> payloads =
+                createPayloads(PAYLOAD_COUNT, payloadSize);
+
+            double singleSamSignaturesPerSecond = 0;
+            for (const int samCount : SAM_COUNTS) {
+                uint64_t stolenBatchCount;
+                const double signaturesPerSecond =
+                    run(plugin, samCount, batchSize, payloads, stolenBatchCount);
+
+                if (singleSamSignaturesPerSecond == 0) {
+                    singleSamSignaturesPerSecond = signaturesPerSecond;
+                }
+
+                logger->info("% | % | % | % | % | % | %\n",
+                             batchSize,
+                             payloadSize,
+                             samCount,
+                             static_cast<uint64_t>(signaturesPerSecond),
+                             static_cast<uint64_t>(signaturesPerSecond * payloadSize),
+                             signaturesPerSecond / singleSamSignaturesPerSecond,
+                             stolenBatchCount);
+            }
+        }
+    }
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
@@ -10,6 +10,9 @@
  * SPDX-License-Identifier: EPL-2.0                                                               *
  **************************************************************************************************/
 
+#include <fstream>
+#include <vector>
+
 /* Calypsonet Terminal Reader */
 #include "CardReader.h"
 #include "ConfigurableCardReader.h"
@@ -41,8 +44,15 @@
 #include "CardResourceServiceProvider.h"
 
 /* Keyple Cpp Example */
+#include "BatchSigner.h"
+#include "BatchVerifier.h"
 #include "CalypsoConstants.h"
+#include "CardResourceAllocator.h"
+#include "CardResourceServiceMetrics.h"
+#include "CardResourceServiceStarter.h"
 #include "ConfigurationUtil.h"
+#include "ParallelSigningEngine.h"
+#include "TraceableFileSigner.h"
 
 using namespace keyple::card::calypso;
 using namespace keyple::core::service;
@@ -63,12 +73,26 @@ using namespace keyple::plugin::pcsc;
  *
  * <ul>
  *   <li>Sets up the card resource service to provide a Calypso SAM (C1).
- *   <li>The card resource service is configured and started to observe the connection/disconnection
- *       of readers and the insertion/removal of cards.
+ *   <li>The card resource service is configured and started in the background to observe the
+ *       connection/disconnection of readers and the insertion/removal of cards, the requests for a
+ *       SAM resource waiting for the readiness of the SAM profile.
  *   <li>A command line menu allows you to take and release a SAM resource and select a signature
  *       process.
  *   <li>The log and console printouts show the operation of the card resource service and the
  *       signature processes results.
+ *   <li>The batch signature generation signs a file of payloads (created with generated payloads if
+ *       missing) to a file of signatures, several signatures being computed per exchange with the
+ *       SAM, and logs the signatures per second.
+ *   <li>The parallel signature generation signs generated payloads with all the SAM resources
+ *       available, and logs the signatures per second.
+ *   <li>The file signature generation signs a whole file (e.g. daily transactions, created with
+ *       generated transactions if missing) with traceable signatures, streamed by chunks through
+ *       the SAM, to a manifest of signatures.
+ *   <li>The audit replay verifies a file of signatures (created from the files of the batch
+ *       signature generation if missing) with all the SAM resources available, several
+ *       verifications being performed per exchange, to a file of the failing signatures only, and
+ *       logs the verifications per second.
+ *   <li>The metrics of the SAM allocations are logged periodically and on exit.
  * </ul>
  *
  * All results are logged with slf4j.
@@ -82,6 +106,8 @@ const std::unique_ptr<Logger> logger =
 
 static const std::string SAM_RESOURCE = "SAM_RESOURCE";
 static const std::string READER_NAME_REGEX = ".*Ident.*";
+static const long ALLOCATION_TIMEOUT_MS = 10000;
+static const long METRICS_DUMP_PERIOD_MS = 30000;
 static const uint8_t KIF_BASIC = 0xEC;
 static const uint8_t KVC_BASIC = 0x85;
 static const std::string KIF_BASIC_STR = HexUtil::toHex(KIF_BASIC);
@@ -91,6 +117,15 @@ static const uint8_t KVC_TRACEABLE = 0x19;
 static const std::string KIF_TRACEABLE_STR = HexUtil::toHex(KIF_TRACEABLE);
 static const std::string KVC_TRACEABLE_STR = HexUtil::toHex(KVC_TRACEABLE);
 static const std::string DATA_TO_SIGN = "00112233445566778899AABBCCDDEEFF";
+static const std::vector<uint8_t> DATA_TO_SIGN_BYTES = HexUtil::toByteArray(DATA_TO_SIGN);
+static const std::string PAYLOADS_FILE_NAME = "payloads.txt";
+static const std::string SIGNATURES_FILE_NAME = "signatures.txt";
+static const int GENERATED_PAYLOAD_COUNT = 1000;
+static const std::string TRANSACTIONS_FILE_NAME = "transactions.dat";
+static const int GENERATED_TRANSACTION_COUNT = 100000;
+static const std::string MANIFEST_FILE_NAME = "transactions.ktsm";
+static const std::string AUDIT_FILE_NAME = "audit.txt";
+static const std::string AUDIT_FAILURES_FILE_NAME = "audit_failures.txt";
 
 /**
  * Reader configurator used by the card resource service to set up the SAM reader with the
@@ -157,6 +192,102 @@ public:
     }
 };
 
+/**
+ * Returns payloads derived from DATA_TO_SIGN.
+ */
+static std::vector<std::vector<uint8_t>> createPayloads()
+{
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<uint8_t> payload = DATA_TO_SIGN_BYTES;
+
+    for (int i = 0; i < GENERATED_PAYLOAD_COUNT; i++) {
+        /* Make each payload unique, as a journal entry would be */
+        payload[0] = static_cast<uint8_t>(i >> 8);
+        payload[1] = static_cast<uint8_t>(i);
+        payloads.push_back(payload);
+    }
+
+    return payloads;
+}
+
+/**
+ * Creates a file of payloads derived from DATA_TO_SIGN if it does not exist yet.
+ */
+static void createPayloadsFileIfMissing()
+{
+    if (std::ifstream(PAYLOADS_FILE_NAME).good()) {
+        return;
+    }
+
+    std::ofstream payloadsFile(PAYLOADS_FILE_NAME);
+
+    for (const auto& payload : createPayloads()) {
+        payloadsFile << HexUtil::toHex(payload) << '\n';
+    }
+
+    logger->info("File '%' created with % payloads\n", PAYLOADS_FILE_NAME, GENERATED_PAYLOAD_COUNT);
+}
+
+/**
+ * Creates a binary file of transactions derived from DATA_TO_SIGN if it does not exist yet.
+ */
+static void createTransactionsFileIfMissing()
+{
+    if (std::ifstream(TRANSACTIONS_FILE_NAME).good()) {
+        return;
+    }
+
+    std::ofstream transactionsFile(TRANSACTIONS_FILE_NAME, std::ios::binary);
+    std::vector<uint8_t> transaction = DATA_TO_SIGN_BYTES;
+
+    for (int i = 0; i < GENERATED_TRANSACTION_COUNT; i++) {
+        /* Make each transaction unique */
+        transaction[0] = static_cast<uint8_t>(i >> 16);
+        transaction[1] = static_cast<uint8_t>(i >> 8);
+        transaction[2] = static_cast<uint8_t>(i);
+        transactionsFile.write(reinterpret_cast<const char*>(transaction.data()),
+                               transaction.size());
+    }
+
+    logger->info("File '%' created with % transactions of % bytes\n",
+                 TRANSACTIONS_FILE_NAME,
+                 GENERATED_TRANSACTION_COUNT,
+                 transaction.size());
+}
+
+/**
+ * Creates the audit file from the files of payloads and signatures if it does not exist yet.
+ *
+ * @return False if the audit file is missing and cannot be created.
+ */
+static bool createAuditFileIfMissing()
+{
+    if (std::ifstream(AUDIT_FILE_NAME).good()) {
+        return true;
+    }
+
+    std::ifstream payloadsFile(PAYLOADS_FILE_NAME);
+    std::ifstream signaturesFile(SIGNATURES_FILE_NAME);
+    if (!payloadsFile.is_open() || !signaturesFile.is_open()) {
+        return false;
+    }
+
+    std::ofstream auditFile(AUDIT_FILE_NAME);
+    std::string payload;
+    std::string signature;
+    int count = 0;
+
+    while (std::getline(payloadsFile, payload) && std::getline(signaturesFile, signature)) {
+        auditFile << "B " << KIF_BASIC_STR << ' ' << KVC_BASIC_STR << ' '
+                  << payload << ' ' << signature << '\n';
+        count++;
+    }
+
+    logger->info("File '%' created with % signatures\n", AUDIT_FILE_NAME, count);
+
+    return true;
+}
+
 static char getInput()
 {
     std::cout << "Options:" << std::endl;
@@ -164,6 +295,10 @@ static char getInput()
     std::cout << "    '2': Release a SAM resource" << std::endl;
     std::cout << "    '3': Basic signature generation and verification" << std::endl;
     std::cout << "    '4': Traceable signature generation and verification" << std::endl;
+    std::cout << "    '5': Batch signature generation of a file of payloads" << std::endl;
+    std::cout << "    '6': Parallel signature generation with all the SAM resources" << std::endl;
+    std::cout << "    '7': Traceable signature generation of a file of transactions" << std::endl;
+    std::cout << "    '8': Audit replay of a file of signatures" << std::endl;
     std::cout << "    'q': quit" << std::endl;
     std::cout << "Select an option: " << std::endl;
 
@@ -202,10 +337,12 @@ int main()
 
     std::shared_ptr<SamTransactionManager> samTransactionManager = nullptr;
 
-    /* Configure the card resource  */
+    /*
+     * Configure the card resource service in non-blocking allocation mode, the blocking allocation
+     * is provided by a CardResourceAllocator waking the waiters as soon as a SAM is released.
+     */
     cardResourceService->getConfigurator()
-                       ->withBlockingAllocationMode(100, 10000)
-                        .withPlugins(PluginsConfigurator::builder()
+                       ->withPlugins(PluginsConfigurator::builder()
                                         ->addPluginWithMonitoring(
                                               plugin,
                                               std::make_shared<ReaderConfigurator>(),
@@ -220,13 +357,24 @@ int main()
                                  .build()})
                         .configure();
 
-    cardResourceService->start();
+    /* Collect the metrics of the SAM allocations, logged periodically */
+    auto cardResourceServiceMetrics = std::make_shared<CardResourceServiceMetrics>();
+    cardResourceServiceMetrics->startPeriodicDump(METRICS_DUMP_PERIOD_MS);
+
+    auto cardResourceAllocator =
+        std::make_shared<CardResourceAllocator>(cardResourceService, cardResourceServiceMetrics);
+
+    /* Start the service in the background, the SAM selection not delaying the menu */
+    CardResourceServiceStarter cardResourceServiceStarter(cardResourceService,
+                                                          cardResourceAllocator,
+                                                          {plugin},
+                                                          {SAM_RESOURCE});
+    cardResourceServiceStarter.startAsync();
 
     std::shared_ptr<SamSecuritySetting> samSecuritySetting =
         CalypsoExtensionService::getInstance()->createSamSecuritySetting();
 
     bool isSignatureValid;
-    std::string signatureHex;
 
     bool loop = true;
     std::shared_ptr<CardResource> cardResource = nullptr;
@@ -234,7 +382,13 @@ int main()
         char c = getInput();
         switch (c) {
         case '1':
-            cardResource = cardResourceService->getCardResource(SAM_RESOURCE);
+            if (!cardResourceServiceStarter.waitForProfileReadiness(SAM_RESOURCE,
+                                                                    ALLOCATION_TIMEOUT_MS)) {
+                logger->info("SAM resource is not ready\n");
+                break;
+            }
+            cardResource =
+                cardResourceAllocator->getCardResource(SAM_RESOURCE, ALLOCATION_TIMEOUT_MS);
             if (cardResource != nullptr) {
                 logger->info("A SAM resource is available: reader %, smart card %\n",
                              cardResource->getReader()->getName(),
@@ -247,7 +401,7 @@ int main()
         case '2':
             if (cardResource != nullptr) {
                 logger->info("Release SAM resource.\n");
-                cardResourceService->releaseCardResource(cardResource);
+                cardResourceAllocator->releaseCardResource(cardResource);
             } else {
                 logger->error("SAM resource is not available\n");
             }
@@ -273,25 +427,25 @@ int main()
 
             std::shared_ptr<BasicSignatureComputationData> basicSignatureComputationData =
                 CalypsoExtensionService::getInstance()->createBasicSignatureComputationData();
-            basicSignatureComputationData->setData(HexUtil::toByteArray(DATA_TO_SIGN),
-                                                   KIF_BASIC,
-                                                   KVC_BASIC);
+            basicSignatureComputationData->setData(DATA_TO_SIGN_BYTES, KIF_BASIC, KVC_BASIC);
             samTransactionManager->prepareComputeSignature(basicSignatureComputationData);
             samTransactionManager->processCommands();
-            signatureHex = HexUtil::toHex(basicSignatureComputationData->getSignature());
 
-            logger->info("signature='%'\n", signatureHex);
+            /* The signature is verified as returned, the hexadecimal form being only logged */
+            const std::vector<uint8_t>& signature = basicSignatureComputationData->getSignature();
+
+            logger->info("signature='%'\n", HexUtil::toHex(signature));
 
             logger->info("Verifying: data='%', signature='%' with the key %/%\n",
                          DATA_TO_SIGN,
-                         signatureHex,
+                         HexUtil::toHex(signature),
                          KIF_BASIC_STR,
                          KVC_BASIC_STR);
 
             std::shared_ptr<BasicSignatureVerificationData> basicSignatureVerificationData =
                 CalypsoExtensionService::getInstance()->createBasicSignatureVerificationData();
-            basicSignatureVerificationData->setData(HexUtil::toByteArray(DATA_TO_SIGN),
-                                                    HexUtil::toByteArray(signatureHex),
+            basicSignatureVerificationData->setData(DATA_TO_SIGN_BYTES,
+                                                    signature,
                                                     KIF_BASIC,
                                                     KVC_BASIC);
             samTransactionManager->prepareVerifySignature(basicSignatureVerificationData);
@@ -323,29 +477,32 @@ int main()
 
             std::shared_ptr<TraceableSignatureComputationData> traceableSignatureComputationData =
                 CalypsoExtensionService::getInstance()->createTraceableSignatureComputationData();
-            traceableSignatureComputationData->setData(HexUtil::toByteArray(DATA_TO_SIGN),
+            traceableSignatureComputationData->setData(DATA_TO_SIGN_BYTES,
                                                        KIF_TRACEABLE,
                                                        KVC_TRACEABLE)
                                                .withSamTraceabilityMode(0, true);
             samTransactionManager->prepareComputeSignature(traceableSignatureComputationData);
             samTransactionManager->processCommands();
-            signatureHex = HexUtil::toHex(traceableSignatureComputationData->getSignature());
-            const std::string signedDataHex =
-                HexUtil::toHex(traceableSignatureComputationData->getSignedData());
 
-            logger->info("signature='%'\n", signatureHex);
-            logger->info("signed data='%'\n", signedDataHex);
+            /* The signature and the signed data are verified as returned */
+            const std::vector<uint8_t>& signature =
+                traceableSignatureComputationData->getSignature();
+            const std::vector<uint8_t>& signedData =
+                traceableSignatureComputationData->getSignedData();
+
+            logger->info("signature='%'\n", HexUtil::toHex(signature));
+            logger->info("signed data='%'\n", HexUtil::toHex(signedData));
 
             logger->info("Verifying: data='%', signature='%' with the key %/%\n",
-                         signedDataHex,
-                         signatureHex,
+                         HexUtil::toHex(signedData),
+                         HexUtil::toHex(signature),
                          KIF_TRACEABLE_STR,
                          KVC_TRACEABLE_STR);
 
             std::shared_ptr<TraceableSignatureVerificationData> traceableSignatureVerificationData =
                 CalypsoExtensionService::getInstance()->createTraceableSignatureVerificationData();
-            traceableSignatureVerificationData->setData(HexUtil::toByteArray(signedDataHex),
-                                                        HexUtil::toByteArray(signatureHex),
+            traceableSignatureVerificationData->setData(signedData,
+                                                        signature,
                                                         KIF_TRACEABLE,
                                                         KVC_TRACEABLE)
                                                .withSamTraceabilityMode(0, true, false);
@@ -357,6 +514,115 @@ int main()
             }
             break;
 
+        case '5':
+            {
+            if (cardResource == nullptr) {
+                logger->error("No SAM resource.\n");
+                break;
+            }
+
+            createPayloadsFileIfMissing();
+
+            BatchSigner batchSigner(
+                cardResource->getReader(),
+                std::dynamic_pointer_cast<CalypsoSam>(cardResource->getSmartCard()),
+                samSecuritySetting,
+                KIF_BASIC,
+                KVC_BASIC);
+
+            logger->info("Signing: file='%' with the key %/% to file='%'\n",
+                         PAYLOADS_FILE_NAME,
+                         KIF_BASIC_STR,
+                         KVC_BASIC_STR,
+                         SIGNATURES_FILE_NAME);
+
+            batchSigner.signFile(PAYLOADS_FILE_NAME, SIGNATURES_FILE_NAME);
+            batchSigner.logStatistics();
+            }
+            break;
+
+        case '6':
+            {
+            if (!cardResourceServiceStarter.waitForProfileReadiness(SAM_RESOURCE,
+                                                                    ALLOCATION_TIMEOUT_MS)) {
+                logger->info("SAM resource is not ready\n");
+                break;
+            }
+
+            /* The SAM resources are leased until the end of the signature generation */
+            ParallelSigningEngine parallelSigningEngine(cardResourceAllocator,
+                                                        SAM_RESOURCE,
+                                                        samSecuritySetting,
+                                                        KIF_BASIC,
+                                                        KVC_BASIC);
+
+            logger->info("Signing: % payloads with the key %/% on % SAMs\n",
+                         GENERATED_PAYLOAD_COUNT,
+                         KIF_BASIC_STR,
+                         KVC_BASIC_STR,
+                         parallelSigningEngine.getSamCount());
+
+            parallelSigningEngine.sign(createPayloads());
+            parallelSigningEngine.logStatistics();
+            }
+            break;
+
+        case '7':
+            {
+            if (cardResource == nullptr) {
+                logger->error("No SAM resource.\n");
+                break;
+            }
+
+            createTransactionsFileIfMissing();
+
+            TraceableFileSigner traceableFileSigner(
+                cardResource->getReader(),
+                std::dynamic_pointer_cast<CalypsoSam>(cardResource->getSmartCard()),
+                samSecuritySetting,
+                KIF_TRACEABLE,
+                KVC_TRACEABLE);
+
+            logger->info("Signing: file='%' with the key %/% to manifest='%'\n",
+                         TRANSACTIONS_FILE_NAME,
+                         KIF_TRACEABLE_STR,
+                         KVC_TRACEABLE_STR,
+                         MANIFEST_FILE_NAME);
+
+            traceableFileSigner.signFile(TRANSACTIONS_FILE_NAME, MANIFEST_FILE_NAME);
+            traceableFileSigner.logStatistics();
+            }
+            break;
+
+        case '8':
+            {
+            if (!createAuditFileIfMissing()) {
+                logger->error("File '%' not found, generate the signatures first.\n",
+                              AUDIT_FILE_NAME);
+                break;
+            }
+
+            if (!cardResourceServiceStarter.waitForProfileReadiness(SAM_RESOURCE,
+                                                                    ALLOCATION_TIMEOUT_MS)) {
+                logger->info("SAM resource is not ready\n");
+                break;
+            }
+
+            /* The SAM resources are leased until the end of the audit replay */
+            BatchVerifier batchVerifier(cardResourceAllocator, SAM_RESOURCE, samSecuritySetting);
+
+            logger->info("Verifying: file='%' on % SAMs to file='%'\n",
+                         AUDIT_FILE_NAME,
+                         batchVerifier.getSamCount(),
+                         AUDIT_FAILURES_FILE_NAME);
+
+            const uint64_t failureCount =
+                batchVerifier.verifyFile(AUDIT_FILE_NAME, AUDIT_FAILURES_FILE_NAME);
+            logger->info("Invalid signatures: %\n", failureCount);
+            batchVerifier.logStatistics();
+            }
+            break;
+
         case 'q':
             loop = false;
             break;
@@ -366,6 +632,10 @@ int main()
         }
     }
 
+    cardResourceServiceStarter.logStartupTimes();
+    cardResourceServiceMetrics->stopPeriodicDump();
+    cardResourceServiceMetrics->logSnapshot();
+
     /* Unregister plugin */
     smartCardService->unregisterPlugin(plugin->getName());
 
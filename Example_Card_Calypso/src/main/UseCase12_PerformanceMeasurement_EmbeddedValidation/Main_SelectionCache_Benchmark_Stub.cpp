@@ -0,0 +1,303 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Core Util */
+#include "IllegalStateException.h"
+#include "LoggerFactory.h"
+
+/* Keyple Cpp Example */
+#include "CalypsoConstants.h"
+#include "CardSelectionCache.h"
+#include "ConfigurationUtil.h"
+#include "InstrumentedStubPluginFactory.h"
+#include "InstrumentedStubReader.h"
+#include "StubSmartCardFactory.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::calypso;
+using namespace keyple::core::service;
+using namespace keyple::core::util::cpp;
+using namespace keyple::core::util::cpp::exception;
+
+/**
+ * <h1>Use Case Calypso 12 – Selection cache for repeat taps benchmark (Stub)</h1>
+ *
+ * <p>We measure here the card APDUs saved by the CardSelectionCache at a validation gate where
+ * the same card is often tapped again within seconds, without any physical card or SAM.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a plugin with an instrumented stub card reader, counting the APDUs exchanged with
+ *       the cards, and a stub SAM reader.
+ *   <li>For each rate of repeat taps, draw a sequence of taps of new cards and of the previous card
+ *       again, and validate each tap: read the environment and the last event for a non-secure
+ *       decision, then append an event in a secure session.
+ *   <li>Validate the taps without cache (the records read by the selection) and with the cache (the
+ *       records read after an AID only selection when missing from the cache). The entry of a card
+ *       is invalidated before the session and put again after its closing.
+ *   <li>Output a table of the card APDUs per tap exchanged by the reader and of the time modelled
+ *       for a contactless reader, with the hit rate and the time saved per tap, the APDUs saved
+ *       being checked against the reads saved by the cache.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ */
+class Main_SelectionCache_Benchmark_Stub {};
+static const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_SelectionCache_Benchmark_Stub));
+
+static const std::string PLUGIN_NAME = "Instrumented stub plugin";
+static const std::string CARD_READER_NAME = "Stub card reader";
+static const std::string SAM_READER_NAME = "Stub SAM reader";
+
+static const std::vector<double> REPEAT_TAP_RATES = {0.0, 0.1, 0.3, 0.5};
+static const int TAP_COUNT = 500;
+
+/* Contactless exchange of a card APDU */
+static const long APDU_LATENCY_US = 3000;
+
+/* Records read for the non-secure decision */
+static const std::vector<CardSelectionCache::RecordId> RECORD_IDS = {
+    {CalypsoConstants::SFI_ENVIRONMENT_AND_HOLDER, CalypsoConstants::RECORD_NUMBER_1},
+    {CalypsoConstants::SFI_EVENT_LOG, CalypsoConstants::RECORD_NUMBER_1}};
+
+/**
+ * Draws the cards tapped, each tap being a new card or, at the provided rate, the previous card
+ * again.
+ */
+static std::vector<std::shared_ptr<StubSmartCard>> drawTaps(std::mt19937& random,
+                                                            const double repeatTapRate)
+{
+    std::bernoulli_distribution isRepeatTap(repeatTapRate);
+    static uint32_t serialNumber = 0;
+
+    std::vector<std::shared_ptr<StubSmartCard>> taps;
+    for (int i = 0; i < TAP_COUNT; i++) {
+        if (taps.empty() || !isRepeatTap(random)) {
+            taps.push_back(StubSmartCardFactory::createStubGateCard(++serialNumber));
+        } else {
+            taps.push_back(taps.back());
+        }
+    }
+
+    return taps;
+}
+
+/**
+ * Creates a card selection manager selecting the Calypso AID, reading the records if requested.
+ */
+static std::shared_ptr<CardSelectionManager> createCardSelectionManager(const bool readRecords)
+{
+    std::shared_ptr<CardSelectionManager> cardSelectionManager =
+        SmartCardServiceProvider::getService()->createCardSelectionManager();
+
+    std::shared_ptr<CalypsoCardSelection> cardSelection =
+        CalypsoExtensionService::getInstance()->createCardSelection();
+    cardSelection->filterByDfName(CalypsoConstants::AID);
+    if (readRecords) {
+        for (const auto& recordId : RECORD_IDS) {
+            cardSelection->prepareReadRecord(recordId.first, recordId.second);
+        }
+    }
+    cardSelectionManager->prepareSelection(cardSelection);
+
+    return cardSelectionManager;
+}
+
+/**
+ * Takes the records from the card image.
+ */
+static CardSelectionCache::Records getRecords(std::shared_ptr<CalypsoCard> calypsoCard)
+{
+    CardSelectionCache::Records records;
+    for (const auto& recordId : RECORD_IDS) {
+        records[recordId] =
+            calypsoCard->getFileBySfi(recordId.first)->getData()->getContent(recordId.second);
+    }
+
+    return records;
+}
+
+/**
+ * Validates the taps, with the cache if not null, and returns the card APDUs exchanged by the
+ * reader.
+ */
+static uint64_t validate(std::shared_ptr<CardReader> cardReader,
+                         std::shared_ptr<InstrumentedStubReader> stubReader,
+                         std::shared_ptr<CardSecuritySetting> cardSecuritySetting,
+                         const std::vector<std::shared_ptr<StubSmartCard>>& taps,
+                         CardSelectionCache* cardSelectionCache)
+{
+    std::shared_ptr<CardSelectionManager> cardSelectionManager =
+        createCardSelectionManager(cardSelectionCache == nullptr);
+    const std::vector<uint8_t> eventRecord(CalypsoConstants::RECORD_SIZE, 0x5A);
+
+    const uint64_t previousApduCount = stubReader->getApduCount();
+
+    for (const auto& card : taps) {
+        stubReader->removeCard();
+        stubReader->insertCard(card);
+
+        const std::shared_ptr<CardSelectionResult> selectionResult =
+            cardSelectionManager->processCardSelectionScenario(cardReader);
+        auto calypsoCard =
+            std::dynamic_pointer_cast<CalypsoCard>(selectionResult->getActiveSmartCard());
+        if (calypsoCard == nullptr) {
+            throw IllegalStateException("The selection of the application '" +
+                                        CalypsoConstants::AID +
+                                        "' failed.");
+        }
+
+        std::shared_ptr<CardTransactionManager> cardTransaction =
+            CalypsoExtensionService::getInstance()->createCardTransaction(cardReader,
+                                                                          calypsoCard,
+                                                                          cardSecuritySetting);
+
+        /* Records for the non-secure decision, read from the card on a cache miss */
+        CardSelectionCache::Records records;
+        if (cardSelectionCache == nullptr || !cardSelectionCache->get(calypsoCard, records)) {
+            if (cardSelectionCache != nullptr) {
+                for (const auto& recordId : RECORD_IDS) {
+                    cardTransaction->prepareReadRecord(recordId.first, recordId.second);
+                }
+                cardTransaction->processCommands();
+            }
+
+            records = getRecords(calypsoCard);
+        }
+
+        /* TODO Place here the non-secure analysis of the environment and of the last event */
+        for (const auto& record : records) {
+            if (record.second.size() != CalypsoConstants::RECORD_SIZE) {
+                throw IllegalStateException("Unexpected record size for the non-secure decision.");
+            }
+        }
+
+        /* The entry is invalidated before the write and put again once the session is closed */
+        if (cardSelectionCache != nullptr) {
+            cardSelectionCache->invalidate(calypsoCard);
+        }
+
+        cardTransaction->processOpening(WriteAccessLevel::DEBIT);
+        cardTransaction->prepareAppendRecord(CalypsoConstants::SFI_EVENT_LOG, eventRecord);
+        cardTransaction->processClosing();
+
+        if (cardSelectionCache != nullptr) {
+            cardSelectionCache->put(calypsoCard);
+        }
+    }
+
+    return stubReader->getApduCount() - previousApduCount;
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register a plugin with an empty card reader, counting the APDUs exchanged, and a SAM reader */
+    std::shared_ptr<InstrumentedStubReader> stubReader =
+        std::make_shared<InstrumentedStubReader>(CARD_READER_NAME, true, nullptr);
+    std::shared_ptr<Plugin> plugin =
+        smartCardService->registerPlugin(
+            std::make_shared<InstrumentedStubPluginFactory>(
+                PLUGIN_NAME,
+                std::vector<std::shared_ptr<InstrumentedStubReader>>{
+                    stubReader,
+                    std::make_shared<InstrumentedStubReader>(
+                        SAM_READER_NAME, false, StubSmartCardFactory::createStubSessionSam())}));
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(CalypsoExtensionService::getInstance());
+
+    std::shared_ptr<CardReader> cardReader = plugin->getReader(CARD_READER_NAME);
+    std::dynamic_pointer_cast<ConfigurableCardReader>(cardReader)
+        ->activateProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL,
+                           ConfigurationUtil::ISO_CARD_PROTOCOL);
+
+    std::shared_ptr<CardReader> samReader = plugin->getReader(SAM_READER_NAME);
+    std::dynamic_pointer_cast<ConfigurableCardReader>(samReader)
+        ->activateProtocol(ConfigurationUtil::SAM_PROTOCOL, ConfigurationUtil::SAM_PROTOCOL);
+
+    std::shared_ptr<CardSecuritySetting> cardSecuritySetting =
+        CalypsoExtensionService::getInstance()->createCardSecuritySetting();
+    cardSecuritySetting->setControlSamResource(samReader, ConfigurationUtil::getSam(samReader));
+
+    logger->info("=============== " \
+                 "UseCase Calypso #12: selection cache for repeat taps " \
+                 "===============\n");
+    logger->info("= #### % taps per rate, % us per card APDU\n", TAP_COUNT, APDU_LATENCY_US);
+    logger->info("| repeat taps | hit rate | APDUs/tap no cache | APDUs/tap cache | " \
+                 "us/tap no cache | us/tap cache | us saved/tap |\n");
+
+    std::mt19937 random(1);
+    for (const double repeatTapRate : REPEAT_TAP_RATES) {
+        const std::vector<std::shared_ptr<StubSmartCard>> taps = drawTaps(random, repeatTapRate);
+
+        CardSelectionCache cardSelectionCache(RECORD_IDS);
+
+        const uint64_t apduCount =
+            validate(cardReader, stubReader, cardSecuritySetting, taps, nullptr);
+        const uint64_t cachedApduCount =
+            validate(cardReader, stubReader, cardSecuritySetting, taps, &cardSelectionCache);
+
+        /* Each hit must save exactly the reads of its records, a miss costing no extra APDU */
+        if (apduCount - cachedApduCount != cardSelectionCache.getSavedReadCount()) {
+            throw IllegalStateException("APDUs saved (" +
+                                        std::to_string(apduCount - cachedApduCount) +
+                                        ") differ from the reads saved by the cache (" +
+                                        std::to_string(cardSelectionCache.getSavedReadCount()) +
+                                        ")");
+        }
+
+        const double apduCountPerTap = static_cast<double>(apduCount) / taps.size();
+        const double cachedApduCountPerTap = static_cast<double>(cachedApduCount) / taps.size();
+
+        logger->info("| % | % | % | % | % | % | % |\n",
+                     repeatTapRate,
+                     cardSelectionCache.getHitRate(),
+                     apduCountPerTap,
+                     cachedApduCountPerTap,
+                     static_cast<long>(apduCountPerTap * APDU_LATENCY_US),
+                     static_cast<long>(cachedApduCountPerTap * APDU_LATENCY_US),
+                     static_cast<long>((apduCountPerTap - cachedApduCountPerTap) *
+                                       APDU_LATENCY_US));
+
+        cardSelectionCache.logStatistics();
+    }
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
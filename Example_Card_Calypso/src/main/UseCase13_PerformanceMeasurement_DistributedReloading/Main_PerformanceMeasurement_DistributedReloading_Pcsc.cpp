@@ -44,6 +44,8 @@
 
 /* Keyple Cpp Example */
 #include "CalypsoConstants.h"
+#include "CardResourceLease.h"
+#include "CardResourcePool.h"
 #include "ConfigurationUtil.h"
 
 using namespace calypsonet::terminal::reader;
@@ -84,6 +86,7 @@ static const std::string samReaderRegex =
 static const std::string cardAid = "315449432E49434131";
 static const int counterIncrement = 10;
 static const std::string logLevel = "INFO";
+static const long SAM_ALLOCATION_TIMEOUT_MS = 1000;
 static const std::vector<uint8_t> newContractListRecord =
     HexUtil::toByteArray("00112233445566778899AABBCCDDEEFF00112233445566778899AABBCC");
 static const std::vector<uint8_t> newContractRecord =
@@ -140,29 +143,27 @@ int main()
         .prepareReadRecord(CalypsoConstants::SFI_CONTRACT_LIST, CalypsoConstants::RECORD_NUMBER_1);
     cardSelectionManager->prepareSelection(selection);
 
-    /* Configure the card resource service for the targeted SAM. */
-    ConfigurationUtil::setupCardResourceService(plugin,
-                                                samReaderRegex, CalypsoConstants::SAM_PROFILE_NAME);
-
     /*
-     * Create security settings that reference the same SAM profile requested from the card resource
-     * service.
+     * Configure the card resource service with one profile per SAM reader, the transactions being
+     * spread over all the installed SAMs by a pool. The SAMs are selected once by the setup and
+     * stay leased to the pool, no SAM selection being needed by the transactions. A lease is
+     * invalidated if its SAM is removed, the service monitoring the SAM readers.
      */
-    std::shared_ptr<CardResource> samResource =
-        CardResourceServiceProvider::getService()
-            ->getCardResource(CalypsoConstants::SAM_PROFILE_NAME);
-
-    if (samResource == nullptr) {
-        throw IllegalStateException("No SAM resource available.");
+    std::shared_ptr<CardResourceService> cardResourceService =
+        CardResourceServiceProvider::getService();
+    std::vector<std::shared_ptr<CardResourceLease>> samResourceLeases;
+    for (const auto& samResource :
+             ConfigurationUtil::setupCardResourceServiceForEachReader(
+                 plugin, samReaderRegex, CalypsoConstants::SAM_PROFILE_NAME)) {
+        samResourceLeases.push_back(
+            std::make_shared<CardResourceLease>(cardResourceService,
+                                                samResource.first,
+                                                samResource.second));
     }
 
-    logger->info("Calypso SAM = %\n", samResource->getSmartCard());
-
-    std::shared_ptr<CardSecuritySetting> cardSecuritySetting =
-        CalypsoExtensionService::getInstance()->createCardSecuritySetting();
-    cardSecuritySetting->setControlSamResource(
-        samResource->getReader(),
-        std::dynamic_pointer_cast<CalypsoSam>(samResource->getSmartCard()));
+    auto samResourcePool =
+        std::make_shared<CardResourcePool>(samResourceLeases,
+                                           CardResourcePool::AllocationPolicy::ROUND_ROBIN);
 
     while (true) {
         logger->info("%########################################################%\n", YELLOW, RESET);
@@ -177,7 +178,27 @@ int main()
         }
 
         if (cardReader->isCardPresent()) {
+            std::shared_ptr<CardResource> samResource = nullptr;
+
             try {
+                /*
+                 * Create security settings that reference a SAM taken from the pool for the
+                 * transaction. The SAM is taken before the transaction time is measured, the
+                 * waiting for a SAM not being part of the card processing.
+                 */
+                samResource = samResourcePool->getCardResource(SAM_ALLOCATION_TIMEOUT_MS);
+                if (samResource == nullptr) {
+                    throw IllegalStateException("No SAM resource available.");
+                }
+
+                logger->info("Calypso SAM = %\n", samResource->getSmartCard());
+
+                std::shared_ptr<CardSecuritySetting> cardSecuritySetting =
+                    CalypsoExtensionService::getInstance()->createCardSecuritySetting();
+                cardSecuritySetting->setControlSamResource(
+                    samResource->getReader(),
+                    std::dynamic_pointer_cast<CalypsoSam>(samResource->getSmartCard()));
+
                 logger->info("Starting reloading transaction...\n");
                 logger->info("Select application with AID = '%'\n", cardAid);
 
@@ -285,8 +306,14 @@ int main()
                               e.getMessage(),
                               RESET);
             }
+
+            if (samResource != nullptr) {
+                samResourcePool->releaseCardResource(samResource);
+            }
         }
     }
 
+    samResourcePool->logUtilisation();
+
     logger->info("Exiting the program on user's request.\n");
 }
@@ -0,0 +1,356 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Core Util */
+#include "IllegalStateException.h"
+#include "LoggerFactory.h"
+
+/* Keyple Cpp Example */
+#include "CalypsoConstants.h"
+#include "ConfigurationUtil.h"
+#include "InstrumentedStubPluginFactory.h"
+#include "InstrumentedStubReader.h"
+#include "SamAccessScheduler.h"
+#include "SamLatencyModel.h"
+#include "StubSmartCardFactory.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::calypso;
+using namespace keyple::core::service;
+using namespace keyple::core::util::cpp;
+using namespace keyple::core::util::cpp::exception;
+
+/**
+ * <h1>Use Case Calypso 14 – Scheduling of the accesses to a SAM shared by several readers (Stub)</h1>
+ *
+ * <p>We demonstrate here the scheduling of the accesses to a single SAM shared by an entry gate
+ * reader (high priority, one secure session per validation, with a latency budget) and ticket
+ * office readers (low priority, several secure sessions per transaction).
+ *
+ * <p>All the readers run real Calypso secure sessions on stub cards, with the same stub SAM given
+ * to setControlSamResource through the scheduler. The stub SAM takes the time of a physical SAM
+ * for each exchange.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>The gate reader runs a validation (a secure session appending an event) at a fixed
+ *       period.
+ *   <li>The ticket office readers run transactions back to back (saturation), each transaction
+ *       made of several secure sessions.
+ *   <li>First policy (first come, first served): all the readers have the same priority and hold
+ *       the SAM for their whole transaction.
+ *   <li>Second policy (prioritized): the gate reader has the HIGH priority, its validation being
+ *       rejected after waiting the latency budget if the SAM is still not granted, and the office
+ *       readers yield the SAM between two sessions. The budget bounds the waiting, not the
+ *       grant: a rejected validation has to be presented again.
+ *   <li>For an increasing number of office readers, output the waiting time and validation time
+ *       percentiles (p50, p99, max) of the granted gate validations, the number of them granted
+ *       beyond the budget and the office throughput, then the number of rejected validations on
+ *       a separate line (they are not part of the percentiles).
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ *
+ * @since 2.0.0
+ */
+class Main_SharedSamScheduling_Stub {};
+const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_SharedSamScheduling_Stub));
+
+static const std::string PLUGIN_NAME = "Instrumented stub plugin";
+static const std::string SAM_READER_NAME = "Stub SAM reader";
+static const std::string GATE_READER_NAME = "Stub gate reader";
+static const std::string OFFICE_READER_NAME_PREFIX = "Stub office reader ";
+
+static const int RUN_DURATION_MS = 3000;
+static const int GATE_PERIOD_MS = 150;
+static const int GATE_LATENCY_BUDGET_MS = 60;
+static const int OFFICE_SESSION_COUNT = 3;
+static const std::vector<int> OFFICE_READER_COUNTS = {0, 1, 2, 4};
+
+/* Buffer size indicator of the stub cards (430 bytes) */
+static const uint8_t BUFFER_SIZE_INDICATOR = 0x0A;
+
+/**
+ * Results of one run.
+ */
+struct RunResult {
+    std::vector<long long> gateWaitingTimesUs;
+    std::vector<long long> gateValidationTimesUs;
+    int overBudgetCount;
+    int rejectionCount;
+    long long officeTransactionsPerSecond;
+};
+
+/**
+ * Returns the p-th percentile (nearest rank) of the provided values, 0 if empty.
+ */
+static long long percentile(std::vector<long long> values, const int p)
+{
+    if (values.empty()) {
+        return 0;
+    }
+
+    std::sort(values.begin(), values.end());
+    const size_t rank = (p * values.size() + 99) / 100;
+
+    return values[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Selects the card present in the reader and creates its transaction manager, the SAM being
+ * provided by the scheduler.
+ */
+static std::shared_ptr<CardTransactionManager> createCardTransaction(
+    std::shared_ptr<CardReader> cardReader,
+    SamAccessScheduler& scheduler,
+    std::shared_ptr<CalypsoSam> calypsoSam)
+{
+    std::shared_ptr<CalypsoExtensionService> calypsoCardService =
+        CalypsoExtensionService::getInstance();
+
+    std::dynamic_pointer_cast<ConfigurableCardReader>(cardReader)
+        ->activateProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL,
+                           ConfigurationUtil::ISO_CARD_PROTOCOL);
+
+    std::shared_ptr<CardSelectionManager> cardSelectionManager =
+        SmartCardServiceProvider::getService()->createCardSelectionManager();
+    std::shared_ptr<CalypsoCardSelection> cardSelection = calypsoCardService->createCardSelection();
+    cardSelection->acceptInvalidatedCard()
+                  .filterByDfName(CalypsoConstants::AID);
+    cardSelectionManager->prepareSelection(cardSelection);
+
+    std::shared_ptr<CalypsoCard> calypsoCard =
+        std::dynamic_pointer_cast<CalypsoCard>(
+            cardSelectionManager->processCardSelectionScenario(cardReader)->getActiveSmartCard());
+    if (calypsoCard == nullptr) {
+        throw IllegalStateException("The selection of the application '" +
+                                    CalypsoConstants::AID +
+                                    "' failed.");
+    }
+
+    std::shared_ptr<CardSecuritySetting> cardSecuritySetting =
+        calypsoCardService->createCardSecuritySetting();
+    cardSecuritySetting->setControlSamResource(scheduler.getSamReader(), calypsoSam);
+
+    return calypsoCardService->createCardTransaction(cardReader, calypsoCard, cardSecuritySetting);
+}
+
+/**
+ * Runs a secure session appending an event.
+ */
+static void runSession(std::shared_ptr<CardTransactionManager> cardTransaction)
+{
+    cardTransaction->processOpening(WriteAccessLevel::DEBIT);
+    cardTransaction->prepareAppendRecord(
+        CalypsoConstants::SFI_EVENT_LOG,
+        std::vector<uint8_t>(CalypsoConstants::RECORD_SIZE, 0x5A));
+    cardTransaction->processClosing();
+}
+
+/**
+ * Runs the gate reader and the provided number of office readers against the SAM.
+ */
+static RunResult run(std::shared_ptr<Plugin> plugin,
+                     std::shared_ptr<CardReader> samReader,
+                     std::shared_ptr<CalypsoSam> calypsoSam,
+                     const int officeReaderCount,
+                     const bool isPrioritized)
+{
+    const std::chrono::milliseconds gateLatencyBudget(GATE_LATENCY_BUDGET_MS);
+    SamAccessScheduler scheduler(samReader, gateLatencyBudget);
+    const SamAccessScheduler::Priority gatePriority =
+        isPrioritized ? SamAccessScheduler::Priority::HIGH : SamAccessScheduler::Priority::LOW;
+    std::atomic<bool> isRunning(true);
+    std::atomic<int> officeTransactionCount(0);
+
+    /* Ticket office readers: back to back transactions */
+    std::vector<std::thread> officeReaders;
+    for (int i = 0; i < officeReaderCount; i++) {
+        std::shared_ptr<CardTransactionManager> cardTransaction =
+            createCardTransaction(plugin->getReader(OFFICE_READER_NAME_PREFIX + std::to_string(i)),
+                                  scheduler,
+                                  calypsoSam);
+
+        officeReaders.emplace_back([&, cardTransaction]() {
+            while (isRunning) {
+                SamAccessScheduler::Access access(scheduler, SamAccessScheduler::Priority::LOW);
+                for (int session = 0; session < OFFICE_SESSION_COUNT; session++) {
+                    runSession(cardTransaction);
+                    if (isPrioritized) {
+                        access.yield();
+                    }
+                }
+                officeTransactionCount++;
+            }
+        });
+    }
+
+    /* Gate reader: periodic validations, in the main thread */
+    std::shared_ptr<CardTransactionManager> gateTransaction =
+        createCardTransaction(plugin->getReader(GATE_READER_NAME), scheduler, calypsoSam);
+
+    RunResult result;
+    result.overBudgetCount = 0;
+    result.rejectionCount = 0;
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::milliseconds(RUN_DURATION_MS);
+    auto next = start;
+    while (next < end) {
+        std::this_thread::sleep_until(next);
+        const auto validationStart = std::chrono::steady_clock::now();
+
+        std::unique_ptr<SamAccessScheduler::Access> access;
+        try {
+            access.reset(new SamAccessScheduler::Access(scheduler, gatePriority));
+        } catch (const IllegalStateException& e) {
+            /* The validation is rejected, the passenger presents the card again */
+            (void)e;
+        }
+
+        /* A rejected validation has no waiting time to sample, it is only counted */
+        if (access != nullptr) {
+            runSession(gateTransaction);
+            result.gateWaitingTimesUs.push_back(access->getWaitingTime().count());
+            if (access->getWaitingTime() > gateLatencyBudget) {
+                result.overBudgetCount++;
+            }
+            access.reset();
+            result.gateValidationTimesUs.push_back(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - validationStart).count());
+        } else {
+            result.rejectionCount++;
+        }
+
+        next += std::chrono::milliseconds(GATE_PERIOD_MS);
+    }
+
+    isRunning = false;
+    for (auto& officeReader : officeReaders) {
+        officeReader.join();
+    }
+
+    /* The gate may have been delayed beyond the run duration */
+    const long long elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    result.officeTransactionsPerSecond = officeTransactionCount * 1000LL / elapsedMs;
+
+    return result;
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /*
+     * Register a plugin with the gate and office card readers and the SAM reader, the stub SAM
+     * taking the time of a physical SAM for each exchange
+     */
+    std::vector<std::shared_ptr<InstrumentedStubReader>> readers;
+    readers.push_back(
+        std::make_shared<InstrumentedStubReader>(SAM_READER_NAME,
+                                                 false,
+                                                 StubSmartCardFactory::createStubSessionSam(),
+                                                 std::make_shared<SamLatencyModel>()));
+    readers.push_back(
+        std::make_shared<InstrumentedStubReader>(
+            GATE_READER_NAME,
+            true,
+            StubSmartCardFactory::createStubSessionCard(BUFFER_SIZE_INDICATOR)));
+    const int maxOfficeReaderCount =
+        *std::max_element(OFFICE_READER_COUNTS.begin(), OFFICE_READER_COUNTS.end());
+    for (int i = 0; i < maxOfficeReaderCount; i++) {
+        readers.push_back(
+            std::make_shared<InstrumentedStubReader>(
+                OFFICE_READER_NAME_PREFIX + std::to_string(i),
+                true,
+                StubSmartCardFactory::createStubSessionCard(BUFFER_SIZE_INDICATOR)));
+    }
+    std::shared_ptr<Plugin> plugin =
+        smartCardService->registerPlugin(
+            std::make_shared<InstrumentedStubPluginFactory>(PLUGIN_NAME, readers));
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(CalypsoExtensionService::getInstance());
+
+    std::shared_ptr<CardReader> samReader = plugin->getReader(SAM_READER_NAME);
+    std::dynamic_pointer_cast<ConfigurableCardReader>(samReader)
+        ->activateProtocol(ConfigurationUtil::SAM_PROTOCOL, ConfigurationUtil::SAM_PROTOCOL);
+    std::shared_ptr<CalypsoSam> calypsoSam = ConfigurationUtil::getSam(samReader);
+
+    logger->info("=============== " \
+                 "UseCase Calypso #14: scheduling of the accesses to a shared SAM " \
+                 "===============\n");
+    logger->info("= Gate: one session every % ms, latency budget % ms\n",
+                 GATE_PERIOD_MS,
+                 GATE_LATENCY_BUDGET_MS);
+    logger->info("= Office: % sessions per transaction\n", OFFICE_SESSION_COUNT);
+
+    for (const bool isPrioritized : {false, true}) {
+        logger->info("= #### Policy: %\n",
+                     isPrioritized ? "prioritized" : "first come, first served");
+
+        for (const int officeReaderCount : OFFICE_READER_COUNTS) {
+            const RunResult result =
+                run(plugin, samReader, calypsoSam, officeReaderCount, isPrioritized);
+
+            logger->info("Office readers: %, gate wait p50: % us, p99: % us, max: % us, " \
+                         "gate validation p50: % us, p99: % us, granted beyond budget: %/%, " \
+                         "office transactions/s: %\n",
+                         officeReaderCount,
+                         percentile(result.gateWaitingTimesUs, 50),
+                         percentile(result.gateWaitingTimesUs, 99),
+                         percentile(result.gateWaitingTimesUs, 100),
+                         percentile(result.gateValidationTimesUs, 50),
+                         percentile(result.gateValidationTimesUs, 99),
+                         result.overBudgetCount,
+                         result.gateWaitingTimesUs.size(),
+                         result.officeTransactionsPerSecond);
+            logger->info("Office readers: %, gate validations rejected after the budget: %/%\n",
+                         officeReaderCount,
+                         result.rejectionCount,
+                         result.gateWaitingTimesUs.size() + result.rejectionCount);
+        }
+    }
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
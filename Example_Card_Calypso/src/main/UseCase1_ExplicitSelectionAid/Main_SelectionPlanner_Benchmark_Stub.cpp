@@ -0,0 +1,255 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <random>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Core Util */
+#include "IllegalStateException.h"
+#include "LoggerFactory.h"
+
+/* Keyple Cpp Example */
+#include "CalypsoConstants.h"
+#include "ConfigurationUtil.h"
+#include "InstrumentedStubPluginFactory.h"
+#include "InstrumentedStubReader.h"
+#include "SelectionPlanner.h"
+#include "StubSmartCardFactory.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::calypso;
+using namespace keyple::core::service;
+using namespace keyple::core::util::cpp;
+using namespace keyple::core::util::cpp::exception;
+
+/**
+ * <h1>Use Case Calypso 1 – Selection planner for a mixed card fleet benchmark (Stub)</h1>
+ *
+ * <p>We measure here the selection APDUs per tap of a single reader accepting several Calypso
+ * applications and card protocols, with the selection cases ordered by the SelectionPlanner,
+ * without any physical card.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a plugin with an instrumented stub card reader, counting the APDUs exchanged and
+ *       accepting the ISO 14443-4 and Innovatron protocols.
+ *   <li>Accept the Calypso AID, the Keyple test AID prefix, the Calypso standard AID and the rev1
+ *       cards, with the frequencies observed so far.
+ *   <li>Tap a fleet whose mix changes halfway (the cards of the Calypso AID replacing the others),
+ *       including cards of no accepted application, and select each card with a planner keeping
+ *       its initial order, a planner adapting its order, and a planner also merging the AIDs
+ *       prefixed by the Keyple test AID prefix.
+ *   <li>Output a table of the APDUs per tap exchanged by the reader and of the time modelled for a
+ *       contactless reader of each planner, before and after the change of the fleet, and the
+ *       statistics of each planner with its expected APDUs per tap.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ */
+class Main_SelectionPlanner_Benchmark_Stub {};
+static const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_SelectionPlanner_Benchmark_Stub));
+
+static const std::string PLUGIN_NAME = "Instrumented stub plugin";
+static const std::string CARD_READER_NAME = "Stub card reader";
+
+/* Accepted applications other than the Calypso AID and the Keyple test AID prefix */
+static const std::string AID_CALYPSO_STANDARD = "A0000004040125090101";
+
+/* DF Names of the cards of the Keyple test kit other than the Calypso AID, and of no application */
+static const std::string DF_NAME_KEYPLE_OTHER = "315449432E49434133";
+static const std::string DF_NAME_UNKNOWN = "D2760000850101";
+
+/* Cards of the fleet: Calypso AID, other Keyple test, Calypso standard, rev1, unknown */
+static const std::vector<std::string> CARD_NAMES =
+    {"Calypso AID", "Keyple other", "Calypso standard", "Rev1", "Unknown"};
+static const std::vector<double> FIRST_PHASE_SHARES = {0.05, 0.10, 0.65, 0.15, 0.05};
+static const std::vector<double> SECOND_PHASE_SHARES = {0.60, 0.10, 0.10, 0.15, 0.05};
+static const int PHASE_TAP_COUNT = 1000;
+
+/* Contactless exchange of a selection APDU with its FCI */
+static const long APDU_LATENCY_US = 3000;
+
+/**
+ * Draws the cards tapped during a phase.
+ */
+static std::vector<size_t> drawTaps(std::mt19937& random, const std::vector<double>& shares)
+{
+    std::discrete_distribution<size_t> distribution(shares.begin(), shares.end());
+
+    std::vector<size_t> taps;
+    for (int i = 0; i < PHASE_TAP_COUNT; i++) {
+        taps.push_back(distribution(random));
+    }
+
+    return taps;
+}
+
+/**
+ * Taps the cards, checks the application matched and returns the APDUs per tap exchanged by the
+ * reader.
+ */
+static double tap(std::shared_ptr<CardReader> cardReader,
+                  std::shared_ptr<InstrumentedStubReader> stubReader,
+                  const std::vector<std::shared_ptr<StubSmartCard>>& cards,
+                  const std::vector<std::string>& applicationNames,
+                  SelectionPlanner& selectionPlanner,
+                  const std::vector<size_t>& taps)
+{
+    const uint64_t previousApduCount = stubReader->getApduCount();
+
+    std::string applicationName;
+    for (const size_t card : taps) {
+        stubReader->removeCard();
+        stubReader->insertCard(cards[card]);
+
+        selectionPlanner.selectCard(cardReader, applicationName);
+        if (applicationName != applicationNames[card]) {
+            throw IllegalStateException("Unexpected application for the card " +
+                                        CARD_NAMES[card] +
+                                        ": '" +
+                                        applicationName +
+                                        "'");
+        }
+    }
+
+    return static_cast<double>(stubReader->getApduCount() - previousApduCount) / taps.size();
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register a plugin with an empty card reader, counting the APDUs exchanged */
+    std::shared_ptr<InstrumentedStubReader> stubReader =
+        std::make_shared<InstrumentedStubReader>(CARD_READER_NAME, true, nullptr);
+    std::shared_ptr<Plugin> plugin =
+        smartCardService->registerPlugin(
+            std::make_shared<InstrumentedStubPluginFactory>(
+                PLUGIN_NAME, std::vector<std::shared_ptr<InstrumentedStubReader>>{stubReader}));
+
+    std::shared_ptr<CardReader> cardReader = plugin->getReader(CARD_READER_NAME);
+    std::dynamic_pointer_cast<ConfigurableCardReader>(cardReader)
+        ->activateProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL,
+                           ConfigurationUtil::ISO_CARD_PROTOCOL);
+    std::dynamic_pointer_cast<ConfigurableCardReader>(cardReader)
+        ->activateProtocol(ConfigurationUtil::INNOVATRON_CARD_PROTOCOL,
+                           ConfigurationUtil::INNOVATRON_CARD_PROTOCOL);
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(CalypsoExtensionService::getInstance());
+
+    /* The stub cards answer the selection of any accepted AID */
+    const std::vector<std::string> aids =
+        {CalypsoConstants::AID, ConfigurationUtil::AID_KEYPLE_PREFIX, AID_CALYPSO_STANDARD};
+    const std::vector<std::shared_ptr<StubSmartCard>> cards = {
+        StubSmartCardFactory::createStubFleetCard(CalypsoConstants::AID, aids),
+        StubSmartCardFactory::createStubFleetCard(DF_NAME_KEYPLE_OTHER, aids),
+        StubSmartCardFactory::createStubFleetCard(AID_CALYPSO_STANDARD, aids),
+        StubSmartCardFactory::createStubRev1Card(),
+        StubSmartCardFactory::createStubFleetCard(DF_NAME_UNKNOWN, aids)};
+
+    /* Application expected for each card */
+    const std::vector<std::string> applicationNames =
+        {"Calypso", "Keyple", "Calypso standard", "Rev1", ""};
+
+    std::mt19937 random(1);
+    const std::vector<size_t> firstPhaseTaps = drawTaps(random, FIRST_PHASE_SHARES);
+    const std::vector<size_t> secondPhaseTaps = drawTaps(random, SECOND_PHASE_SHARES);
+
+    logger->info("=============== " \
+                 "UseCase Calypso #1: selection planner for a mixed card fleet " \
+                 "===============\n");
+    logger->info("= #### % taps per phase, % us per selection APDU\n",
+                 PHASE_TAP_COUNT,
+                 APDU_LATENCY_US);
+    logger->info("| planner           | APDUs/tap 1 | APDUs/tap 2 | us/tap 1 | us/tap 2 |\n");
+
+    const std::vector<std::string> plannerNames = {"initial order", "adaptive", "adaptive+merge"};
+    std::vector<std::unique_ptr<SelectionPlanner>> selectionPlanners;
+    selectionPlanners.emplace_back(new SelectionPlanner(0));
+    selectionPlanners.emplace_back(new SelectionPlanner());
+    selectionPlanners.emplace_back(
+        new SelectionPlanner(SelectionPlanner::DEFAULT_REPLAN_INTERVAL,
+                             SelectionPlanner::DEFAULT_DECAY,
+                             true));
+
+    for (size_t p = 0; p < selectionPlanners.size(); p++) {
+        SelectionPlanner& selectionPlanner = *selectionPlanners[p];
+
+        /* The frequencies observed so far, those of the first phase */
+        selectionPlanner.addApplication(applicationNames[0],
+                                        ConfigurationUtil::ISO_CARD_PROTOCOL,
+                                        CalypsoConstants::AID,
+                                        FIRST_PHASE_SHARES[0]);
+        selectionPlanner.addApplication(applicationNames[1],
+                                        ConfigurationUtil::ISO_CARD_PROTOCOL,
+                                        ConfigurationUtil::AID_KEYPLE_PREFIX,
+                                        FIRST_PHASE_SHARES[1]);
+        selectionPlanner.addApplication(applicationNames[2],
+                                        ConfigurationUtil::ISO_CARD_PROTOCOL,
+                                        AID_CALYPSO_STANDARD,
+                                        FIRST_PHASE_SHARES[2]);
+        selectionPlanner.addApplication(applicationNames[3],
+                                        ConfigurationUtil::INNOVATRON_CARD_PROTOCOL,
+                                        "",
+                                        FIRST_PHASE_SHARES[3]);
+
+        const double firstPhaseApduCount = tap(cardReader,
+                                               stubReader,
+                                               cards,
+                                               applicationNames,
+                                               selectionPlanner,
+                                               firstPhaseTaps);
+        const double secondPhaseApduCount = tap(cardReader,
+                                                stubReader,
+                                                cards,
+                                                applicationNames,
+                                                selectionPlanner,
+                                                secondPhaseTaps);
+
+        logger->info("| % | % | % | % | % |\n",
+                     plannerNames[p],
+                     firstPhaseApduCount,
+                     secondPhaseApduCount,
+                     static_cast<long>(firstPhaseApduCount * APDU_LATENCY_US),
+                     static_cast<long>(secondPhaseApduCount * APDU_LATENCY_US));
+    }
+
+    for (size_t p = 0; p < selectionPlanners.size(); p++) {
+        logger->info("= #### Planner: %\n", plannerNames[p]);
+        selectionPlanners[p]->logStatistics();
+    }
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
@@ -24,6 +24,7 @@
 
 /* Keyple Cpp Examples */
 #include "CalypsoConstants.h"
+#include "TimestampedCardReaderEvent.h"
 
 /* Keyple Core Service */
 #include "ObservableReader.h"
@@ -43,12 +44,22 @@ void CardReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> ev
     switch (event->getType()) {
     case CardReaderEvent::Type::CARD_MATCHED:
         {
+        /* Timestamps available if the observer is placed behind a TimestampingCardReaderObserver */
+        auto timestampedEvent = std::dynamic_pointer_cast<TimestampedCardReaderEvent>(event);
+        if (timestampedEvent) {
+            timestampedEvent->markSelectionResultParseStart();
+        }
+
         auto calypsoCard =
             std::dynamic_pointer_cast<CalypsoCard>(
                 mCardSelectionManager->parseScheduledCardSelectionsResponse(
                                           event->getScheduledCardSelectionsResponse())
                                     ->getActiveSmartCard());
 
+        if (timestampedEvent) {
+            timestampedEvent->markSelectionResultParseEnd();
+        }
+
         mLogger->info("Observer notification: card selection was successful and produced the smart" \
                      " card = %\n",
                      calypsoCard);
@@ -59,6 +70,10 @@ void CardReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> ev
                      StringUtils::format("%02X", CalypsoConstants::SFI_ENVIRONMENT_AND_HOLDER),
                      calypsoCard->getFileBySfi(CalypsoConstants::SFI_ENVIRONMENT_AND_HOLDER));
 
+        if (timestampedEvent) {
+            timestampedEvent->logTimestamps(*mLogger);
+        }
+
         mLogger->info("= #### End of the card processing\n");
         }
         break;
@@ -37,6 +37,8 @@
 #include "CalypsoConstants.h"
 #include "CardReaderObserver.h"
 #include "ConfigurationUtil.h"
+#include "DebouncingCardReaderObserver.h"
+#include "TimestampingCardReaderObserver.h"
 
 using namespace calypsonet::terminal::reader;
 using namespace keyple::card::calypso;
@@ -130,11 +132,19 @@ int main()
         ObservableCardReader::DetectionMode::REPEATING,
         ObservableCardReader::NotificationMode::MATCHED_ONLY);
 
-    /* Create and add an observer for this reader */
+    /*
+     * Create and add an observer for this reader, behind a debouncing stage dropping a card
+     * bouncing at the edge of the field (its removal and its re-insertion) and a timestamping
+     * stage providing the observer with the latency of each event.
+     */
     auto cardReaderObserver =
         std::make_shared<CardReaderObserver>(cardReader, cardSelectionManager);
     observable->setReaderObservationExceptionHandler(cardReaderObserver);
-    observable->addObserver(cardReaderObserver);
+    observable->addObserver(
+        std::make_shared<TimestampingCardReaderObserver>(
+            std::make_shared<DebouncingCardReaderObserver>(cardReaderObserver,
+                                                           observable,
+                                                           cardSelectionManager)));
     observable->startCardDetection(ObservableCardReader::DetectionMode::REPEATING);
 
     logger->info("= #### Wait for a card. The default AID based selection to be processed as soon" \
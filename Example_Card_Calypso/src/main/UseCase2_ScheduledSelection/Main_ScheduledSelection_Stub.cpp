@@ -40,7 +40,9 @@
 #include "CalypsoConstants.h"
 #include "CardReaderObserver.h"
 #include "ConfigurationUtil.h"
+#include "DebouncingCardReaderObserver.h"
 #include "StubSmartCardFactory.h"
+#include "TimestampingCardReaderObserver.h"
 
 using namespace calypsonet::terminal::reader;
 using namespace keyple::card::calypso;
@@ -72,6 +74,11 @@ using namespace keyple::plugin::stub;
  *         <li>Output collected card data (FCI and ATR).
  *         <li>Close the physical channel.
  *       </ul>
+ *   <li>Simulate a card held at the edge of the field (quick removals/insertions), each
+ *       re-insertion being processed and the removals followed by a re-insertion being dropped by
+ *       the debouncing observer placed in front of the reader observer, and output its statistics.
+ *   <li>Output the latencies measured between the card insertion and the processing of the
+ *       selection by the reader observer.
  * </ul>
  *
  * All results are logged with slf4j.
@@ -148,10 +155,20 @@ int main()
         ObservableCardReader::DetectionMode::REPEATING,
         ObservableCardReader::NotificationMode::MATCHED_ONLY);
 
-    /* Create and add an observer for this reader */
+    /*
+     * Create and add an observer for this reader, behind a debouncing stage dropping a card
+     * bouncing at the edge of the field (its removal and its re-insertion) and a timestamping
+     * stage providing the observer with the latency of each event.
+     */
     auto cardReaderObserver = std::make_shared<CardReaderObserver>(cardReader,cardSelectionManager);
+    auto debouncingObserver =
+        std::make_shared<DebouncingCardReaderObserver>(cardReaderObserver,
+                                                       observableReader,
+                                                       cardSelectionManager);
+    auto timestampingObserver =
+        std::make_shared<TimestampingCardReaderObserver>(debouncingObserver);
     observableReader->setReaderObservationExceptionHandler(cardReaderObserver);
-    observableReader->addObserver(cardReaderObserver);
+    observableReader->addObserver(timestampingObserver);
     observableReader->startCardDetection(ObservableCardReader::DetectionMode::REPEATING);
 
     logger->info("= #### Wait for a card. The default AID based selection to be processed as soon" \
@@ -161,6 +178,7 @@ int main()
     Thread::sleep(100);
 
     logger->info("Insert stub card\n");
+    timestampingObserver->markCardDetection();
     std::dynamic_pointer_cast<StubReader>(
         plugin->getReaderExtension(typeid(StubReader), CARD_READER_NAME))
             ->insertCard(StubSmartCardFactory::getStubCard());
@@ -169,9 +187,25 @@ int main()
     Thread::sleep(1000);
 
     logger->info("Remove stub card\n");
-    std::dynamic_pointer_cast<StubReader>(
-        plugin->getReaderExtension(typeid(StubReader), CARD_READER_NAME))
-            ->removeCard();
+    auto stubReader =
+        std::dynamic_pointer_cast<StubReader>(
+            plugin->getReaderExtension(typeid(StubReader), CARD_READER_NAME));
+    stubReader->removeCard();
+
+    /* Simulate a card held at the edge of the field: quick insertions/removals */
+    logger->info("Bounce stub card\n");
+    for (int i = 0; i < 3; i++) {
+        Thread::sleep(100);
+        stubReader->insertCard(StubSmartCardFactory::getStubCard());
+        Thread::sleep(100);
+        stubReader->removeCard();
+    }
+
+    /* Wait a while. */
+    Thread::sleep(1000);
+
+    debouncingObserver->logStatistics();
+    timestampingObserver->logStatistics();
 
     /* Unregister plugin */
     smartCardService->unregisterPlugin(plugin->getName());
@@ -0,0 +1,443 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "IllegalStateException.h"
+#include "LoggerFactory.h"
+
+/* Keyple Cpp Example */
+#include "CalypsoConstants.h"
+#include "ConfigurationUtil.h"
+#include "InstrumentedStubPluginFactory.h"
+#include "InstrumentedStubReader.h"
+#include "ModificationsBufferPlanner.h"
+#include "SamLatencyModel.h"
+#include "StubSmartCardFactory.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::calypso;
+using namespace keyple::core::service;
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp;
+using namespace keyple::core::util::cpp::exception;
+
+/**
+ * <h1>Use Case Calypso 5 – Multiple sessions benchmark (Stub)</h1>
+ *
+ * <p>We compare here the two ways of writing more records than the card's modifications buffer
+ * can hold: the multiple session mode of the library, and explicit sessions planned by the
+ * ModificationsBufferPlanner, without any physical card or SAM.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a plugin with a stub SAM reader and one stub card reader per buffer capacity,
+ *       the stub card and SAM answering the secure session commands.
+ *   <li>For each buffer capacity, record size and number of appended records, select the card and
+ *       append the records with each strategy.
+ *   <li>Output a table of the sessions opened, the APDUs exchanged (from the transaction audit
+ *       data), the processing time of the stubs and the time modelled for a contactless card, for
+ *       both strategies, with the fastest one so that the break-even points can be read.
+ *   <li>Append records produced at execution by a CPU bound producer (e.g. ciphering), through the
+ *       planner of an instrumented stub card reader taking the time of a contactless exchange for
+ *       each APDU, without and with the pipelined mode.
+ *   <li>Output a table of the sessions, the card APDUs counted by the reader (the same in both
+ *       modes), the production time of the records, the duration of both modes and the time saved
+ *       per session after the first one, the production of the first session not being
+ *       overlapped.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ */
+class Main_MultipleSession_Benchmark_Stub {};
+static const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_MultipleSession_Benchmark_Stub));
+
+static const std::string PLUGIN_NAME = "Instrumented stub plugin";
+static const std::string CARD_READER_NAME_PREFIX = "Stub card reader ";
+static const std::string SAM_READER_NAME = "Stub SAM reader";
+static const std::string LATENCY_CARD_READER_NAME = "Stub card reader with latency";
+
+/* Buffer size indicators of the startup information: 215, 430 and 724 bytes */
+static const std::vector<uint8_t> BUFFER_SIZE_INDICATORS = {0x06, 0x0A, 0x0D};
+static const std::vector<int> RECORD_SIZES = {10, 29};
+static const std::vector<int> RECORD_COUNTS = {5, 10, 20, 40, 80};
+
+/* Contactless exchange, modelled for every APDU of the card and of the SAM */
+static const long APDU_LATENCY_US = 2000;
+static const long BYTE_LATENCY_NS = 75000;
+
+/* Pipelining: records produced at execution in a buffer of 430 bytes (12 records per session) */
+static const uint8_t PIPELINE_BUFFER_SIZE_INDICATOR = 0x0A;
+static const std::vector<int> PIPELINE_RECORD_COUNTS = {12, 24, 48, 96};
+static const int PRODUCTION_ROUNDS = 200000;
+
+/**
+ * Producer of records at execution, costing CPU time as a ciphering would.
+ */
+class CpuBoundRecordSupplier final : public ModificationsBufferPlanner::RecordSupplier {
+public:
+    /**
+     *
+     */
+    CpuBoundRecordSupplier() : mProductionDurationUs(0) {}
+
+    /**
+     * {@inheritDoc}
+     */
+    std::vector<uint8_t> getRecordData() override
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<uint8_t> recordData(CalypsoConstants::RECORD_SIZE);
+        uint32_t state = 0x12345678;
+        for (int round = 0; round < PRODUCTION_ROUNDS; round++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            recordData[round % recordData.size()] ^= static_cast<uint8_t>(state);
+        }
+
+        mProductionDurationUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - start).count();
+
+        return recordData;
+    }
+
+    /**
+     * @return The cumulated production time, in microseconds.
+     */
+    uint64_t getProductionDurationUs() const
+    {
+        return mProductionDurationUs;
+    }
+
+private:
+    /**
+     *
+     */
+    std::atomic<uint64_t> mProductionDurationUs;
+};
+
+/**
+ * Measures of a run.
+ */
+struct RunResult {
+    size_t sessionCount;
+    size_t apduCount;
+    uint64_t durationUs;
+    uint64_t modelledDurationUs;
+};
+
+/**
+ * Selects the card present in the reader.
+ */
+static std::shared_ptr<CalypsoCard> selectCard(std::shared_ptr<CardReader> cardReader)
+{
+    std::shared_ptr<CardSelectionManager> cardSelectionManager =
+        SmartCardServiceProvider::getService()->createCardSelectionManager();
+
+    std::shared_ptr<CalypsoCardSelection> cardSelection =
+        CalypsoExtensionService::getInstance()->createCardSelection();
+    cardSelection->acceptInvalidatedCard()
+                  .filterByDfName(CalypsoConstants::AID);
+    cardSelectionManager->prepareSelection(cardSelection);
+
+    const std::shared_ptr<CardSelectionResult> selectionResult =
+        cardSelectionManager->processCardSelectionScenario(cardReader);
+
+    if (selectionResult->getActiveSmartCard() == nullptr) {
+        throw IllegalStateException("The selection of the application '" +
+                                    CalypsoConstants::AID +
+                                    "' failed.");
+    }
+
+    return std::dynamic_pointer_cast<CalypsoCard>(selectionResult->getActiveSmartCard());
+}
+
+/**
+ * Appends records with one strategy and returns the measures.
+ */
+static RunResult run(std::shared_ptr<CardReader> cardReader,
+                     std::shared_ptr<CardReader> samReader,
+                     std::shared_ptr<CalypsoSam> calypsoSam,
+                     const bool isMultipleSessionMode,
+                     const int recordCount,
+                     const int recordSize)
+{
+    const std::vector<uint8_t> recordData(recordSize, 0x5A);
+
+    std::shared_ptr<CalypsoCard> calypsoCard = selectCard(cardReader);
+
+    std::shared_ptr<CardSecuritySetting> cardSecuritySetting =
+        CalypsoExtensionService::getInstance()->createCardSecuritySetting();
+    cardSecuritySetting->setControlSamResource(samReader, calypsoSam);
+    if (isMultipleSessionMode) {
+        cardSecuritySetting->enableMultipleSession();
+    }
+
+    std::shared_ptr<CardTransactionManager> cardTransaction =
+        CalypsoExtensionService::getInstance()->createCardTransaction(cardReader,
+                                                                      calypsoCard,
+                                                                      cardSecuritySetting);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (isMultipleSessionMode) {
+        /* The library closes and reopens the session when the buffer is full */
+        cardTransaction->processOpening(WriteAccessLevel::DEBIT);
+        for (int i = 0; i < recordCount; i++) {
+            cardTransaction->prepareAppendRecord(CalypsoConstants::SFI_EVENT_LOG, recordData);
+        }
+        cardTransaction->processClosing();
+
+    } else {
+        ModificationsBufferPlanner modificationsBufferPlanner(calypsoCard);
+        for (int i = 0; i < recordCount; i++) {
+            modificationsBufferPlanner.addAppendRecord(CalypsoConstants::SFI_EVENT_LOG, recordData);
+        }
+        modificationsBufferPlanner.execute(cardTransaction, WriteAccessLevel::DEBIT);
+    }
+
+    RunResult result;
+    result.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+
+    /* The audit data alternates the APDU requests and responses, of the card and of the SAM */
+    const SamLatencyModel exchangeLatencyModel(APDU_LATENCY_US, 0, BYTE_LATENCY_NS);
+    const std::vector<std::vector<uint8_t>> auditData = cardTransaction->getTransactionAuditData();
+
+    result.sessionCount = 0;
+    result.apduCount = auditData.size() / 2;
+    result.modelledDurationUs = 0;
+    for (size_t i = 0; i + 1 < auditData.size(); i += 2) {
+        const std::vector<uint8_t>& apduRequest = auditData[i];
+
+        /* Open Secure Session of the card (the SAM Digest Init has the same INS, CLA 0x80) */
+        if (apduRequest.size() >= 2 && apduRequest[0] == 0x00 && apduRequest[1] == 0x8A) {
+            result.sessionCount++;
+        }
+
+        result.modelledDurationUs +=
+            exchangeLatencyModel.getLatencyUs(0, apduRequest.size() + auditData[i + 1].size());
+    }
+
+    return result;
+}
+
+/**
+ * Measures of a planner execution with records produced at execution.
+ */
+struct PipelineResult {
+    size_t sessionCount;
+    uint64_t apduCount;
+    uint64_t productionDurationUs;
+    uint64_t durationUs;
+};
+
+/**
+ * Appends records produced at execution, pipelined or not, and returns the measures.
+ */
+static PipelineResult runPipeline(std::shared_ptr<CardReader> cardReader,
+                                  std::shared_ptr<InstrumentedStubReader> stubReader,
+                                  std::shared_ptr<CardReader> samReader,
+                                  std::shared_ptr<CalypsoSam> calypsoSam,
+                                  const bool isPipelined,
+                                  const int recordCount)
+{
+    std::shared_ptr<CalypsoCard> calypsoCard = selectCard(cardReader);
+
+    std::shared_ptr<CardSecuritySetting> cardSecuritySetting =
+        CalypsoExtensionService::getInstance()->createCardSecuritySetting();
+    cardSecuritySetting->setControlSamResource(samReader, calypsoSam);
+
+    std::shared_ptr<CardTransactionManager> cardTransaction =
+        CalypsoExtensionService::getInstance()->createCardTransaction(cardReader,
+                                                                      calypsoCard,
+                                                                      cardSecuritySetting);
+
+    auto recordSupplier = std::make_shared<CpuBoundRecordSupplier>();
+    ModificationsBufferPlanner modificationsBufferPlanner(calypsoCard);
+    modificationsBufferPlanner.setPipelined(isPipelined);
+    for (int i = 0; i < recordCount; i++) {
+        modificationsBufferPlanner.addAppendRecord(CalypsoConstants::SFI_EVENT_LOG,
+                                                   CalypsoConstants::RECORD_SIZE,
+                                                   recordSupplier);
+    }
+
+    const uint64_t previousApduCount = stubReader->getApduCount();
+    const auto start = std::chrono::steady_clock::now();
+
+    modificationsBufferPlanner.execute(cardTransaction, WriteAccessLevel::DEBIT);
+
+    PipelineResult result;
+    result.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+    result.sessionCount = modificationsBufferPlanner.getSessionCount();
+    result.apduCount = stubReader->getApduCount() - previousApduCount;
+    result.productionDurationUs = recordSupplier->getProductionDurationUs();
+
+    return result;
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register a plugin with a stub card reader per buffer capacity and a stub SAM reader */
+    std::vector<std::shared_ptr<InstrumentedStubReader>> readers;
+    for (const uint8_t bufferSizeIndicator : BUFFER_SIZE_INDICATORS) {
+        readers.push_back(
+            std::make_shared<InstrumentedStubReader>(
+                CARD_READER_NAME_PREFIX + HexUtil::toHex(bufferSizeIndicator),
+                true,
+                StubSmartCardFactory::createStubSessionCard(bufferSizeIndicator)));
+    }
+    readers.push_back(
+        std::make_shared<InstrumentedStubReader>(SAM_READER_NAME,
+                                                 false,
+                                                 StubSmartCardFactory::createStubSessionSam()));
+
+    /* A card reader taking the time of a contactless exchange, for the pipelining */
+    std::shared_ptr<InstrumentedStubReader> latencyStubReader =
+        std::make_shared<InstrumentedStubReader>(
+            LATENCY_CARD_READER_NAME,
+            true,
+            StubSmartCardFactory::createStubSessionCard(PIPELINE_BUFFER_SIZE_INDICATOR),
+            std::make_shared<SamLatencyModel>(APDU_LATENCY_US, 0, BYTE_LATENCY_NS));
+    readers.push_back(latencyStubReader);
+    std::shared_ptr<Plugin> plugin =
+        smartCardService->registerPlugin(
+            std::make_shared<InstrumentedStubPluginFactory>(PLUGIN_NAME, readers));
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(CalypsoExtensionService::getInstance());
+
+    std::shared_ptr<CardReader> samReader = plugin->getReader(SAM_READER_NAME);
+    std::dynamic_pointer_cast<ConfigurableCardReader>(samReader)
+        ->activateProtocol(ConfigurationUtil::SAM_PROTOCOL, ConfigurationUtil::SAM_PROTOCOL);
+    std::shared_ptr<CalypsoSam> calypsoSam = ConfigurationUtil::getSam(samReader);
+
+    logger->info("=============== " \
+                 "UseCase Calypso #5: multiple sessions benchmark " \
+                 "==================\n");
+    logger->info("= modelled exchange: % us per APDU, % ns per byte\n",
+                 APDU_LATENCY_US,
+                 BYTE_LATENCY_NS);
+    logger->info("buffer | record size | records | sessions multiple/explicit | " \
+                 "APDUs multiple/explicit | stub ms multiple/explicit | " \
+                 "modelled ms multiple/explicit | fastest\n");
+
+    for (const uint8_t bufferSizeIndicator : BUFFER_SIZE_INDICATORS) {
+        std::shared_ptr<CardReader> cardReader =
+            plugin->getReader(CARD_READER_NAME_PREFIX + HexUtil::toHex(bufferSizeIndicator));
+        std::dynamic_pointer_cast<ConfigurableCardReader>(cardReader)
+            ->activateProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL,
+                               ConfigurationUtil::ISO_CARD_PROTOCOL);
+
+        const int bufferCapacity = selectCard(cardReader)->getModificationsCounter();
+
+        for (const int recordSize : RECORD_SIZES) {
+            for (const int recordCount : RECORD_COUNTS) {
+                const RunResult multiple =
+                    run(cardReader, samReader, calypsoSam, true, recordCount, recordSize);
+                const RunResult explicitSplit =
+                    run(cardReader, samReader, calypsoSam, false, recordCount, recordSize);
+
+                const char* fastest =
+                    multiple.modelledDurationUs < explicitSplit.modelledDurationUs ? "multiple" :
+                    multiple.modelledDurationUs > explicitSplit.modelledDurationUs ? "explicit" :
+                                                                                     "equal";
+
+                logger->info("% | % | % | %/% | %/% | %/% | %/% | %\n",
+                             bufferCapacity,
+                             recordSize,
+                             recordCount,
+                             multiple.sessionCount,
+                             explicitSplit.sessionCount,
+                             multiple.apduCount,
+                             explicitSplit.apduCount,
+                             multiple.durationUs / 1000,
+                             explicitSplit.durationUs / 1000,
+                             multiple.modelledDurationUs / 1000,
+                             explicitSplit.modelledDurationUs / 1000,
+                             fastest);
+            }
+        }
+    }
+
+    logger->info("= #### Pipelining of records produced at execution, % rounds per record\n",
+                 PRODUCTION_ROUNDS);
+    logger->info("records | sessions | card APDUs | production ms | sequential ms | " \
+                 "pipelined ms | saved ms per extra session\n");
+
+    std::shared_ptr<CardReader> latencyCardReader = plugin->getReader(LATENCY_CARD_READER_NAME);
+    std::dynamic_pointer_cast<ConfigurableCardReader>(latencyCardReader)
+        ->activateProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL,
+                           ConfigurationUtil::ISO_CARD_PROTOCOL);
+
+    for (const int recordCount : PIPELINE_RECORD_COUNTS) {
+        const PipelineResult sequential = runPipeline(
+            latencyCardReader, latencyStubReader, samReader, calypsoSam, false, recordCount);
+        const PipelineResult pipelined = runPipeline(
+            latencyCardReader, latencyStubReader, samReader, calypsoSam, true, recordCount);
+
+        /* The pipelining only overlaps the production, the exchanges must be the same */
+        if (sequential.apduCount != pipelined.apduCount) {
+            throw IllegalStateException("Pipelining changed the card APDUs: " +
+                                        std::to_string(sequential.apduCount) +
+                                        " sequential, " +
+                                        std::to_string(pipelined.apduCount) +
+                                        " pipelined");
+        }
+
+        const long savedDurationUs = static_cast<long>(sequential.durationUs) -
+                                     static_cast<long>(pipelined.durationUs);
+
+        logger->info("% | % | % | % | % | % | %\n",
+                     recordCount,
+                     sequential.sessionCount,
+                     sequential.apduCount,
+                     sequential.productionDurationUs / 1000,
+                     sequential.durationUs / 1000,
+                     pipelined.durationUs / 1000,
+                     sequential.sessionCount > 1 ?
+                         savedDurationUs / 1000.0 / (sequential.sessionCount - 1) : 0.0);
+    }
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
@@ -38,6 +38,7 @@
 /* Keyple Cpp Example */
 #include "CalypsoConstants.h"
 #include "ConfigurationUtil.h"
+#include "ModificationsBufferPlanner.h"
 
 using namespace calypsonet::terminal::reader;
 using namespace keyple::card::calypso;
@@ -53,7 +54,8 @@ using namespace keyple::plugin::pcsc;
  * <h1>Use Case Calypso 5 – Multiple sessions (PC/SC)</h1>
  *
  * <p>We demonstrate here a simple way to bypass the card modification buffer limitation by using
- * the multiple session mode.
+ * the multiple session mode, then how to split a large batch of modifications into the fewest
+ * secure sessions according to the actual modifications buffer of the card.
  *
  * <h2>Scenario:</h2>
  *
@@ -65,6 +67,9 @@ using namespace keyple::plugin::pcsc;
  *   <li>Creates a CardTransactionManager using CardSecuritySetting referencing the selected SAM.
  *   <li>Prepares and executes a number of modification commands that exceeds the number of commands
  *       allowed by the card's modification buffer size.
+ *   <li>Plans a number of modification commands that exceeds the capacity of the card's
+ *       modifications buffer, read from the selected card, into the minimum number of sessions.
+ *   <li>Executes the planned sessions and logs the session count and the time per session.
  * </ul>
  *
  * All results are logged with slf4j.
@@ -75,6 +80,8 @@ class Main_MultipleSession_Pcsc {};
 static const std::unique_ptr<Logger> logger =
     LoggerFactory::getLogger(typeid(Main_MultipleSession_Pcsc));
 
+static const int APPEND_RECORD_COUNT = 40;
+
 int main()
 {
     /* Get the instance of the SmartCardService */
@@ -180,11 +187,38 @@ int main()
                                                 CalypsoConstants::EVENT_LOG_DATA_FILL));
     }
 
-    cardTransaction->prepareReleaseCardChannel().processClosing();
+    cardTransaction->processClosing();
 
     logger->info("The secure session has ended successfully, all data has been written to the " \
                  "card's memory\n");
 
+    /*
+     * Plan the append records (29 bytes) commands according to the actual modifications buffer of
+     * the card, each one consuming 35 (29 + 6) bytes of a buffer in bytes.
+     */
+    ModificationsBufferPlanner modificationsBufferPlanner(calypsoCard);
+    for (int i = 0; i < APPEND_RECORD_COUNT; i++) {
+        modificationsBufferPlanner.addAppendRecord(
+            CalypsoConstants::SFI_EVENT_LOG,
+            HexUtil::toByteArray(CalypsoConstants::EVENT_LOG_DATA_FILL));
+    }
+
+    logger->info("==== Send % Append Record commands in % sessions. Modifications buffer " \
+                 "capacity = % % ====\n",
+                 modificationsBufferPlanner.getCommandCount(),
+                 modificationsBufferPlanner.getSessionCount(),
+                 modificationsBufferPlanner.getBufferCapacity(),
+                 modificationsBufferPlanner.isBufferCapacityInBytes() ? "bytes" : "commands");
+
+    modificationsBufferPlanner.execute(cardTransaction, WriteAccessLevel::DEBIT);
+
+    cardTransaction->prepareReleaseCardChannel().processCommands();
+
+    modificationsBufferPlanner.logStatistics();
+
+    logger->info("The secure sessions have ended successfully, all data has been written to the " \
+                 "card's memory\n");
+
     logger->info("= #### End of the Calypso card processing\n");
 
     return 0;
@@ -0,0 +1,184 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "BatchSigner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "IllegalArgumentException.h"
+
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp::exception;
+
+const int BatchSigner::DEFAULT_BATCH_SIZE = 32;
+
+BatchSigner::BatchSigner(std::shared_ptr<CardReader> samReader,
+                         std::shared_ptr<CalypsoSam> sam,
+                         std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+                         const uint8_t kif,
+                         const uint8_t kvc,
+                         const int batchSize)
+: mKif(kif),
+  mKvc(kvc),
+  mBatchSize(batchSize),
+  mSignatureCount(0),
+  mExchangeCount(0),
+  mProcessingTimeNs(0)
+{
+    if (batchSize <= 0) {
+        throw IllegalArgumentException("The batch size must be strictly positive");
+    }
+
+    mSamTransactionManager =
+        CalypsoExtensionService::getInstance()->createSamTransaction(samReader,
+                                                                      sam,
+                                                                      samSecuritySetting);
+}
+
+void BatchSigner::signBatch(const std::vector<std::vector<uint8_t>>& payloads,
+                            const size_t begin,
+                            const size_t end,
+                            std::vector<std::vector<uint8_t>>& signatures)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    /* Prepare all the signature computations of the batch, then send them in one exchange */
+    mSignatureComputationDatas.clear();
+
+    for (size_t i = begin; i < end; i++) {
+        std::shared_ptr<BasicSignatureComputationData> signatureComputationData =
+            CalypsoExtensionService::getInstance()->createBasicSignatureComputationData();
+        signatureComputationData->setData(payloads[i], mKif, mKvc);
+        mSamTransactionManager->prepareComputeSignature(signatureComputationData);
+        mSignatureComputationDatas.push_back(signatureComputationData);
+    }
+
+    mSamTransactionManager->processCommands();
+
+    /* Assigned in place, the buffer of a signature already sized being reused */
+    for (size_t i = begin; i < end; i++) {
+        signatures[i] = mSignatureComputationDatas[i - begin]->getSignature();
+    }
+
+    mSignatureCount += end - begin;
+    mExchangeCount++;
+    mProcessingTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<std::vector<uint8_t>> BatchSigner::sign(
+    const std::vector<std::vector<uint8_t>>& payloads)
+{
+    std::vector<std::vector<uint8_t>> signatures(payloads.size());
+
+    sign(payloads, 0, payloads.size(), signatures);
+
+    return signatures;
+}
+
+void BatchSigner::sign(const std::vector<std::vector<uint8_t>>& payloads,
+                       const size_t begin,
+                       const size_t end,
+                       std::vector<std::vector<uint8_t>>& signatures)
+{
+    for (size_t i = begin; i < end; i += mBatchSize) {
+        signBatch(payloads, i, std::min(end, i + static_cast<size_t>(mBatchSize)), signatures);
+    }
+}
+
+uint64_t BatchSigner::signStream(std::istream& input, std::ostream& output)
+{
+    uint64_t count = 0;
+    std::vector<std::vector<uint8_t>> payloads(mBatchSize);
+    std::vector<std::vector<uint8_t>> signatures(mBatchSize);
+    size_t payloadCount = 0;
+    std::string line;
+
+    while (true) {
+        const bool isEndOfInput = !std::getline(input, line);
+
+        if (!isEndOfInput && !line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (!isEndOfInput && !line.empty()) {
+            payloads[payloadCount++] = HexUtil::toByteArray(line);
+        }
+
+        if (payloadCount == static_cast<size_t>(mBatchSize) ||
+            (isEndOfInput && payloadCount != 0)) {
+            signBatch(payloads, 0, payloadCount, signatures);
+
+            for (size_t i = 0; i < payloadCount; i++) {
+                output << HexUtil::toHex(signatures[i]) << '\n';
+            }
+
+            count += payloadCount;
+            payloadCount = 0;
+        }
+
+        if (isEndOfInput) {
+            break;
+        }
+    }
+
+    output.flush();
+
+    return count;
+}
+
+uint64_t BatchSigner::signFile(const std::string& inputFileName, const std::string& outputFileName)
+{
+    std::ifstream input(inputFileName);
+    if (!input.is_open()) {
+        throw IllegalArgumentException("Unable to open the file of payloads: " + inputFileName);
+    }
+
+    std::ofstream output(outputFileName, std::ios::trunc);
+    if (!output.is_open()) {
+        throw IllegalArgumentException("Unable to open the file of signatures: " + outputFileName);
+    }
+
+    return signStream(input, output);
+}
+
+uint64_t BatchSigner::getSignatureCount() const
+{
+    return mSignatureCount;
+}
+
+uint64_t BatchSigner::getExchangeCount() const
+{
+    return mExchangeCount;
+}
+
+double BatchSigner::getSignaturesPerSecond() const
+{
+    if (mProcessingTimeNs == 0) {
+        return 0;
+    }
+
+    return mSignatureCount * 1e9 / mProcessingTimeNs;
+}
+
+void BatchSigner::logStatistics() const
+{
+    mLogger->info("Batch signing: % signatures in % exchanges (batch size %), % signatures/s\n",
+                  mSignatureCount,
+                  mExchangeCount,
+                  mBatchSize,
+                  static_cast<uint64_t>(getSignaturesPerSecond()));
+}
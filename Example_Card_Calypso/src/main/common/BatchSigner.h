@@ -0,0 +1,193 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Calypso */
+#include "CalypsoSam.h"
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::calypso::sam;
+using namespace calypsonet::terminal::calypso::transaction;
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::calypso;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Basic signature generation of a stream of payloads with a SAM.
+ *
+ * <p>The payloads are grouped in batches: the signature computations of a batch are all prepared
+ * before a single processCommands, which sends them to the SAM in one card request, so that the
+ * cost of an exchange is shared by the whole batch. The batch size bounds the memory used and the
+ * work lost if an exchange fails.
+ *
+ * <p>The statistics (signatures, exchanges, signatures per second) are cumulated over all the
+ * batches.
+ */
+class BatchSigner final {
+public:
+    /**
+     * Default number of signatures computed per processCommands.
+     */
+    static const int DEFAULT_BATCH_SIZE;
+
+    /**
+     * Constructor.
+     *
+     * @param samReader The reader of the SAM.
+     * @param sam The selected SAM.
+     * @param samSecuritySetting The SAM security settings.
+     * @param kif The KIF of the signing key.
+     * @param kvc The KVC of the signing key.
+     * @param batchSize The maximum number of signatures computed per processCommands.
+     * @throw IllegalArgumentException If the batch size is not strictly positive.
+     */
+    BatchSigner(std::shared_ptr<CardReader> samReader,
+                std::shared_ptr<CalypsoSam> sam,
+                std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+                const uint8_t kif,
+                const uint8_t kvc,
+                const int batchSize = DEFAULT_BATCH_SIZE);
+
+    /**
+     * Signs payloads, by batches.
+     *
+     * @param payloads The payloads to sign.
+     * @return The signatures, in the order of the payloads.
+     */
+    std::vector<std::vector<uint8_t>> sign(const std::vector<std::vector<uint8_t>>& payloads);
+
+    /**
+     * Signs a range of payloads, by batches, each signature being written at the position of its
+     * payload, so that the payloads are not copied and the buffers of the signatures are reused.
+     *
+     * @param payloads The payloads.
+     * @param begin The position of the first payload to sign.
+     * @param end The position following the last payload to sign.
+     * @param signatures The signatures, at least as large as the payloads.
+     */
+    void sign(const std::vector<std::vector<uint8_t>>& payloads,
+              const size_t begin,
+              const size_t end,
+              std::vector<std::vector<uint8_t>>& signatures);
+
+    /**
+     * Signs a stream of payloads, one hexadecimal payload per line (empty lines being ignored),
+     * and writes one hexadecimal signature per line to the output, in the same order.
+     *
+     * <p>Only one batch of payloads is held in memory at a time.
+     *
+     * @param input The stream of payloads.
+     * @param output The stream of signatures.
+     * @return The number of signatures written.
+     */
+    uint64_t signStream(std::istream& input, std::ostream& output);
+
+    /**
+     * Signs a file of payloads to a file of signatures (see signStream).
+     *
+     * @param inputFileName The file of payloads.
+     * @param outputFileName The file of signatures, overwritten.
+     * @return The number of signatures written.
+     * @throw IllegalArgumentException If a file cannot be opened.
+     */
+    uint64_t signFile(const std::string& inputFileName, const std::string& outputFileName);
+
+    /**
+     * @return The number of signatures computed.
+     */
+    uint64_t getSignatureCount() const;
+
+    /**
+     * @return The number of processCommands performed.
+     */
+    uint64_t getExchangeCount() const;
+
+    /**
+     * @return The signatures computed per second of processing, 0 if none.
+     */
+    double getSignaturesPerSecond() const;
+
+    /**
+     * Logs the statistics.
+     */
+    void logStatistics() const;
+
+private:
+    /**
+     * Signs one batch of payloads, in a range of payloads (see sign).
+     */
+    void signBatch(const std::vector<std::vector<uint8_t>>& payloads,
+                   const size_t begin,
+                   const size_t end,
+                   std::vector<std::vector<uint8_t>>& signatures);
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(BatchSigner));
+
+    /**
+     *
+     */
+    std::shared_ptr<SamTransactionManager> mSamTransactionManager;
+
+    /**
+     *
+     */
+    const uint8_t mKif;
+
+    /**
+     *
+     */
+    const uint8_t mKvc;
+
+    /**
+     * Signature computation data of the batch in progress, the vector being reused.
+     */
+    std::vector<std::shared_ptr<BasicSignatureComputationData>> mSignatureComputationDatas;
+
+    /**
+     *
+     */
+    const int mBatchSize;
+
+    /**
+     *
+     */
+    uint64_t mSignatureCount;
+
+    /**
+     *
+     */
+    uint64_t mExchangeCount;
+
+    /**
+     * Cumulated processing time of the batches, in nanoseconds.
+     */
+    uint64_t mProcessingTimeNs;
+};
@@ -0,0 +1,397 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "BatchVerifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+/* Calypsonet Terminal Calypso */
+#include "CalypsoSam.h"
+#include "InvalidSignatureException.h"
+
+/* Keyple Core Util */
+#include "Exception.h"
+#include "HexUtil.h"
+#include "IllegalArgumentException.h"
+#include "IllegalStateException.h"
+
+using namespace calypsonet::terminal::calypso::sam;
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp::exception;
+
+/* Number of batches per SAM read at once from a stream */
+static const size_t BATCHES_PER_SAM_PER_BLOCK = 4;
+
+/**
+ * Returns true if the string is a non-empty hexadecimal string of an even length.
+ */
+static bool isHexString(const std::string& value)
+{
+    if (value.empty() || value.size() % 2 != 0) {
+        return false;
+    }
+
+    for (const char c : value) {
+        if (!std::isxdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Parses a line of a stream of signatures, returns false if it is malformed.
+ */
+static bool parseSignatureRecord(const std::string& line,
+                                 BatchVerifier::SignatureRecord& signatureRecord)
+{
+    std::istringstream fields(line);
+    std::string type;
+    std::string kif;
+    std::string kvc;
+    std::string data;
+    std::string signature;
+    std::string extra;
+
+    if (!(fields >> type >> kif >> kvc >> data >> signature) || (fields >> extra) ||
+        (type != "B" && type != "T") ||
+        kif.size() != 2 || kvc.size() != 2 ||
+        !isHexString(kif) || !isHexString(kvc) || !isHexString(data) || !isHexString(signature)) {
+        return false;
+    }
+
+    signatureRecord.isTraceable = type == "T";
+    signatureRecord.kif = HexUtil::toByteArray(kif)[0];
+    signatureRecord.kvc = HexUtil::toByteArray(kvc)[0];
+    signatureRecord.data = HexUtil::toByteArray(data);
+    signatureRecord.signature = HexUtil::toByteArray(signature);
+
+    return true;
+}
+
+BatchVerifier::BatchVerifier(std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                             const std::string& samProfileName,
+                             std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+                             const int batchSize)
+: mCardResourceAllocator(cardResourceAllocator),
+  mBatchSize(batchSize),
+  mVerificationCount(0),
+  mFailureCount(0),
+  mProcessingTimeNs(0)
+{
+    if (batchSize <= 0) {
+        throw IllegalArgumentException("The batch size must be strictly positive");
+    }
+
+    /* Lease every SAM resource of the profile available now */
+    try {
+        while (true) {
+            std::shared_ptr<CardResource> samResource =
+                cardResourceAllocator->getCardResource(samProfileName, 0);
+            if (samResource == nullptr) {
+                break;
+            }
+
+            /* Kept first, to be released if the creation of its transaction manager fails */
+            std::unique_ptr<Worker> worker(new Worker());
+            worker->samResource = samResource;
+            mWorkers.push_back(std::move(worker));
+
+            mWorkers.back()->samTransactionManager =
+                CalypsoExtensionService::getInstance()->createSamTransaction(
+                    samResource->getReader(),
+                    std::dynamic_pointer_cast<CalypsoSam>(samResource->getSmartCard()),
+                    samSecuritySetting);
+        }
+
+    } catch (...) {
+        releaseSamResources();
+        throw;
+    }
+
+    if (mWorkers.empty()) {
+        throw IllegalStateException("No SAM resource available for profile '" +
+                                    samProfileName +
+                                    "'");
+    }
+
+    mLogger->info("% SAM resources of profile '%' leased for verification\n",
+                  mWorkers.size(),
+                  samProfileName);
+}
+
+BatchVerifier::~BatchVerifier()
+{
+    releaseSamResources();
+}
+
+void BatchVerifier::releaseSamResources()
+{
+    for (const auto& worker : mWorkers) {
+        try {
+            mCardResourceAllocator->releaseCardResource(worker->samResource);
+
+        } catch (const Exception& e) {
+            mLogger->error("Unable to release the SAM resource of reader '%'\n",
+                           worker->samResource->getReader()->getName(),
+                           e);
+        }
+    }
+}
+
+size_t BatchVerifier::getSamCount() const
+{
+    return mWorkers.size();
+}
+
+bool BatchVerifier::verifyBatch(Worker& worker,
+                                const std::vector<SignatureRecord>& signatureRecords,
+                                const size_t begin,
+                                const size_t end,
+                                std::vector<uint8_t>& results)
+{
+    std::vector<std::pair<size_t, std::shared_ptr<BasicSignatureVerificationData>>> basicDatas;
+    std::vector<std::pair<size_t, std::shared_ptr<TraceableSignatureVerificationData>>>
+        traceableDatas;
+
+    worker.exchangeCount++;
+
+    try {
+        /* Prepare all the verifications of the batch, whatever their key, then exchange once */
+        for (size_t i = begin; i < end; i++) {
+            const SignatureRecord& signatureRecord = signatureRecords[i];
+
+            if (signatureRecord.isTraceable) {
+                std::shared_ptr<TraceableSignatureVerificationData> verificationData =
+                    CalypsoExtensionService::getInstance()
+                        ->createTraceableSignatureVerificationData();
+                verificationData->setData(signatureRecord.data,
+                                          signatureRecord.signature,
+                                          signatureRecord.kif,
+                                          signatureRecord.kvc)
+                                 .withSamTraceabilityMode(0, true, false);
+                worker.samTransactionManager->prepareVerifySignature(verificationData);
+                traceableDatas.emplace_back(i, verificationData);
+
+            } else {
+                std::shared_ptr<BasicSignatureVerificationData> verificationData =
+                    CalypsoExtensionService::getInstance()->createBasicSignatureVerificationData();
+                verificationData->setData(signatureRecord.data,
+                                          signatureRecord.signature,
+                                          signatureRecord.kif,
+                                          signatureRecord.kvc);
+                worker.samTransactionManager->prepareVerifySignature(verificationData);
+                basicDatas.emplace_back(i, verificationData);
+            }
+        }
+
+        worker.samTransactionManager->processCommands();
+
+    } catch (const InvalidSignatureException& e) {
+        mLogger->debug("Invalid signature among % verifications: %\n",
+                       end - begin,
+                       e.getMessage());
+        return false;
+    }
+
+    for (const auto& basicData : basicDatas) {
+        results[basicData.first] = basicData.second->isSignatureValid() ? 1 : 0;
+    }
+
+    for (const auto& traceableData : traceableDatas) {
+        results[traceableData.first] = traceableData.second->isSignatureValid() ? 1 : 0;
+    }
+
+    return true;
+}
+
+std::vector<size_t> BatchVerifier::verify(const std::vector<SignatureRecord>& signatureRecords)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    /* One byte per signature, written concurrently, 1 if valid */
+    std::vector<uint8_t> results(signatureRecords.size(), 0);
+    const size_t batchCount = (signatureRecords.size() + mBatchSize - 1) / mBatchSize;
+
+    std::atomic<size_t> nextBatchIndex(0);
+    std::atomic<bool> isFailed(false);
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < mWorkers.size(); w++) {
+        threads.emplace_back([&, w]() {
+            Worker& worker = *mWorkers[w];
+
+            try {
+                while (!isFailed) {
+                    const size_t batchIndex = nextBatchIndex++;
+                    if (batchIndex >= batchCount) {
+                        break;
+                    }
+
+                    const size_t begin = batchIndex * mBatchSize;
+                    const size_t end = std::min(signatureRecords.size(), begin + mBatchSize);
+
+                    if (verifyBatch(worker, signatureRecords, begin, end, results)) {
+                        continue;
+                    }
+
+                    /* Find the invalid signatures of the batch */
+                    worker.retriedBatchCount++;
+                    for (size_t i = begin; i < end; i++) {
+                        verifyBatch(worker, signatureRecords, i, i + 1, results);
+                    }
+                }
+
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+                isFailed = true;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+
+    std::vector<size_t> failures;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results[i] == 0) {
+            failures.push_back(i);
+        }
+    }
+
+    mVerificationCount += signatureRecords.size();
+    mFailureCount += failures.size();
+    mProcessingTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start).count();
+
+    return failures;
+}
+
+uint64_t BatchVerifier::verifyStream(std::istream& input, std::ostream& failures)
+{
+    const size_t blockSize = mBatchSize * mWorkers.size() * BATCHES_PER_SAM_PER_BLOCK;
+    uint64_t lineNumber = 0;
+    uint64_t failureCount = 0;
+    bool isEndOfInput = false;
+
+    while (!isEndOfInput) {
+        /* Read a block of lines, the well-formed ones being verified together */
+        std::vector<std::pair<uint64_t, std::string>> lines;
+        std::vector<SignatureRecord> signatureRecords;
+        std::vector<size_t> recordLines;
+        std::vector<uint8_t> isLineFailed;
+        std::string line;
+
+        while (signatureRecords.size() < blockSize) {
+            if (!std::getline(input, line)) {
+                isEndOfInput = true;
+                break;
+            }
+            lineNumber++;
+
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+
+            SignatureRecord signatureRecord;
+            const bool isWellFormed = parseSignatureRecord(line, signatureRecord);
+            if (isWellFormed) {
+                recordLines.push_back(lines.size());
+                signatureRecords.push_back(std::move(signatureRecord));
+            }
+            lines.emplace_back(lineNumber, line);
+            isLineFailed.push_back(isWellFormed ? 0 : 1);
+        }
+
+        for (const size_t failure : verify(signatureRecords)) {
+            isLineFailed[recordLines[failure]] = 1;
+        }
+
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (isLineFailed[i] != 0) {
+                failures << lines[i].first << ' ' << lines[i].second << '\n';
+                failureCount++;
+            }
+        }
+
+        /* The malformed lines are failures not counted by verify */
+        mFailureCount += lines.size() - signatureRecords.size();
+    }
+
+    failures.flush();
+
+    return failureCount;
+}
+
+uint64_t BatchVerifier::verifyFile(const std::string& inputFileName,
+                                   const std::string& failuresFileName)
+{
+    std::ifstream input(inputFileName);
+    if (!input.is_open()) {
+        throw IllegalArgumentException("Unable to open the file of signatures: " + inputFileName);
+    }
+
+    std::ofstream failures(failuresFileName, std::ios::trunc);
+    if (!failures.is_open()) {
+        throw IllegalArgumentException("Unable to open the file of failures: " + failuresFileName);
+    }
+
+    return verifyStream(input, failures);
+}
+
+double BatchVerifier::getVerificationsPerSecond() const
+{
+    if (mProcessingTimeNs == 0) {
+        return 0;
+    }
+
+    return mVerificationCount * 1e9 / mProcessingTimeNs;
+}
+
+void BatchVerifier::logStatistics() const
+{
+    mLogger->info("Batch verification: % signatures with % SAMs, % failures, % verifications/s\n",
+                  mVerificationCount,
+                  mWorkers.size(),
+                  mFailureCount,
+                  static_cast<uint64_t>(getVerificationsPerSecond()));
+
+    for (const auto& worker : mWorkers) {
+        mLogger->info("SAM reader %: % exchanges, % batches verified again one by one\n",
+                      worker->samResource->getReader()->getName(),
+                      worker->exchangeCount,
+                      worker->retriedBatchCount);
+    }
+}
@@ -0,0 +1,220 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+
+/* Examples */
+#include "BatchSigner.h"
+#include "CardResourceAllocator.h"
+
+using namespace calypsonet::terminal::calypso::transaction;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Verification of large numbers of basic and traceable signatures (e.g. audit replay), spread over
+ * all the SAMs of a card resource profile.
+ *
+ * <p>The verifier leases every SAM resource of the profile available at its creation. The
+ * signatures are verified by batches, the verifications of a batch being all prepared before a
+ * single processCommands, each SAM taking the next batch as soon as it is done with the previous
+ * one. Each signature carries its own key, so that batches may mix several KIF/KVC pairs.
+ *
+ * <p>If the library reports an invalid signature in a batch (InvalidSignatureException), the
+ * signatures of the batch are verified again one by one to find the invalid ones. Any other error
+ * is not a verification result and is thrown to the caller.
+ *
+ * <p>Only the failures are reported.
+ */
+class BatchVerifier final {
+public:
+    /**
+     * Signature to verify.
+     */
+    struct SignatureRecord {
+        /**
+         * True for a traceable signature with SAM traceability at offset 0 and a partial SAM
+         * serial number, false for a basic signature.
+         */
+        bool isTraceable;
+
+        /**
+         * The signed data (including the traceability information of a traceable signature).
+         */
+        std::vector<uint8_t> data;
+
+        /**
+         *
+         */
+        std::vector<uint8_t> signature;
+
+        /**
+         *
+         */
+        uint8_t kif;
+
+        /**
+         *
+         */
+        uint8_t kvc;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param cardResourceAllocator The allocator of the card resources, through which the SAM
+     *        resources are allocated and released.
+     * @param samProfileName The card resource profile of the SAMs.
+     * @param samSecuritySetting The SAM security settings.
+     * @param batchSize The maximum number of verifications per processCommands.
+     * @throw IllegalStateException If no SAM resource is available.
+     * @throw IllegalArgumentException If the batch size is not strictly positive.
+     */
+    BatchVerifier(std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                  const std::string& samProfileName,
+                  std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+                  const int batchSize = BatchSigner::DEFAULT_BATCH_SIZE);
+
+    /**
+     * Releases the SAM resources through the allocator.
+     */
+    ~BatchVerifier();
+
+    /**
+     * @return The number of SAMs leased.
+     */
+    size_t getSamCount() const;
+
+    /**
+     * Verifies signatures with all the SAMs in parallel.
+     *
+     * @param signatureRecords The signatures to verify.
+     * @return The positions of the invalid signatures, in increasing order.
+     * @throw Exception Any error other than an invalid signature, met by one of the SAMs.
+     */
+    std::vector<size_t> verify(const std::vector<SignatureRecord>& signatureRecords);
+
+    /**
+     * Verifies a stream of signatures, one per line, and writes the failing lines only, each one
+     * preceded by its line number.
+     *
+     * <p>Line format: "B" (basic) or "T" (traceable), KIF, KVC, data and signature, in hexadecimal
+     * and separated by spaces (e.g. "B EC 85 0011...EEFF 1122334455667788"). A malformed line is
+     * reported as a failure.
+     *
+     * <p>The signatures are read by blocks, the memory used not depending on the stream size.
+     *
+     * @param input The stream of signatures.
+     * @param failures The stream of the failing lines.
+     * @return The number of failures.
+     */
+    uint64_t verifyStream(std::istream& input, std::ostream& failures);
+
+    /**
+     * Verifies a file of signatures to a file of failures (see verifyStream).
+     *
+     * @param inputFileName The file of signatures.
+     * @param failuresFileName The file of the failing lines, overwritten.
+     * @return The number of failures.
+     * @throw IllegalArgumentException If a file cannot be opened.
+     */
+    uint64_t verifyFile(const std::string& inputFileName, const std::string& failuresFileName);
+
+    /**
+     * @return The verifications per second of verification request, 0 if none.
+     */
+    double getVerificationsPerSecond() const;
+
+    /**
+     * Logs the statistics.
+     */
+    void logStatistics() const;
+
+private:
+    /**
+     * SAM leased with its transaction manager.
+     */
+    struct Worker {
+        std::shared_ptr<CardResource> samResource;
+        std::shared_ptr<SamTransactionManager> samTransactionManager;
+        uint64_t exchangeCount = 0;
+        uint64_t retriedBatchCount = 0;
+    };
+
+    /**
+     * Verifies a range of signatures in one exchange with the SAM of a worker.
+     *
+     * @return False if a signature of the range is invalid.
+     * @throw Exception Any error other than an invalid signature.
+     */
+    bool verifyBatch(Worker& worker,
+                     const std::vector<SignatureRecord>& signatureRecords,
+                     const size_t begin,
+                     const size_t end,
+                     std::vector<uint8_t>& results);
+
+    /**
+     * Releases the SAM resources of the workers through the allocator, logging the failures.
+     */
+    void releaseSamResources();
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(BatchVerifier));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardResourceAllocator> mCardResourceAllocator;
+
+    /**
+     *
+     */
+    const int mBatchSize;
+
+    /**
+     *
+     */
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    /**
+     *
+     */
+    uint64_t mVerificationCount;
+
+    /**
+     *
+     */
+    uint64_t mFailureCount;
+
+    /**
+     * Cumulated duration of the verification requests, in nanoseconds.
+     */
+    uint64_t mProcessingTimeNs;
+};
@@ -0,0 +1,161 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "CardSelectionCache.h"
+
+#include <algorithm>
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp::exception;
+
+const long CardSelectionCache::DEFAULT_TIME_TO_LIVE_MS = 5000;
+const size_t CardSelectionCache::DEFAULT_CAPACITY = 64;
+
+CardSelectionCache::CardSelectionCache(const std::vector<RecordId>& recordIds,
+                                       const long timeToLiveMs,
+                                       const size_t capacity)
+: mRecordIds(recordIds),
+  mTimeToLive(timeToLiveMs),
+  mCapacity(capacity),
+  mHitCount(0),
+  mMissCount(0),
+  mInvalidationCount(0),
+  mSavedReadCount(0) {}
+
+const std::vector<CardSelectionCache::RecordId>& CardSelectionCache::getRecordIds() const
+{
+    return mRecordIds;
+}
+
+std::string CardSelectionCache::getKey(std::shared_ptr<CalypsoCard> calypsoCard)
+{
+    return calypsoCard->getPowerOnData() +
+           "/" +
+           HexUtil::toHex(calypsoCard->getApplicationSerialNumber());
+}
+
+bool CardSelectionCache::get(std::shared_ptr<CalypsoCard> calypsoCard, Records& records)
+{
+    const std::string key = getKey(calypsoCard);
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto it = mEntries.find(key);
+    if (it == mEntries.end()) {
+        mMissCount++;
+        return false;
+    }
+
+    /* An expired entry or a changed FCI (e.g. card invalidated meanwhile) is never served */
+    if (std::chrono::steady_clock::now() - it->second.creationTime > mTimeToLive ||
+        it->second.selectApplicationResponse != calypsoCard->getSelectApplicationResponse()) {
+        mEntries.erase(it);
+        mMissCount++;
+        return false;
+    }
+
+    records = it->second.records;
+    mHitCount++;
+    mSavedReadCount += records.size();
+
+    return true;
+}
+
+void CardSelectionCache::put(std::shared_ptr<CalypsoCard> calypsoCard)
+{
+    Entry entry;
+    entry.selectApplicationResponse = calypsoCard->getSelectApplicationResponse();
+    for (const auto& recordId : mRecordIds) {
+        const auto file = calypsoCard->getFileBySfi(recordId.first);
+        if (file == nullptr || file->getData()->getContent(recordId.second).empty()) {
+            throw IllegalStateException("Record " +
+                                        std::to_string(recordId.second) +
+                                        " of SFI " +
+                                        HexUtil::toHex(recordId.first) +
+                                        " missing from the card image");
+        }
+
+        entry.records[recordId] = file->getData()->getContent(recordId.second);
+    }
+
+    const std::string key = getKey(calypsoCard);
+    const auto now = std::chrono::steady_clock::now();
+    entry.creationTime = now;
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    /* Drop the expired entries, then the oldest one if still full */
+    for (auto it = mEntries.begin(); it != mEntries.end();) {
+        if (now - it->second.creationTime > mTimeToLive) {
+            it = mEntries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (mEntries.size() >= mCapacity && mEntries.find(key) == mEntries.end()) {
+        mEntries.erase(
+            std::min_element(mEntries.begin(),
+                             mEntries.end(),
+                             [](const std::pair<const std::string, Entry>& a,
+                                const std::pair<const std::string, Entry>& b) {
+                                 return a.second.creationTime < b.second.creationTime;
+                             }));
+    }
+
+    mEntries[key] = entry;
+}
+
+void CardSelectionCache::invalidate(std::shared_ptr<CalypsoCard> calypsoCard)
+{
+    const std::string key = getKey(calypsoCard);
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mEntries.erase(key) != 0) {
+        mInvalidationCount++;
+    }
+}
+
+double CardSelectionCache::getHitRate() const
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mHitCount + mMissCount == 0) {
+        return 0;
+    }
+
+    return static_cast<double>(mHitCount) / (mHitCount + mMissCount);
+}
+
+uint64_t CardSelectionCache::getSavedReadCount() const
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mSavedReadCount;
+}
+
+void CardSelectionCache::logStatistics() const
+{
+    const double hitRate = getHitRate();
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    mLogger->info("Selection cache: % hits, % misses (hit rate %), % invalidations, % record " \
+                  "reads saved\n",
+                  mHitCount,
+                  mMissCount,
+                  hitRate,
+                  mInvalidationCount,
+                  mSavedReadCount);
+}
@@ -0,0 +1,191 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Calypsonet Terminal Calypso */
+#include "CalypsoCard.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::calypso::card;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Short-lived cache of the records read after the selection of a card, for the repeat taps of the
+ * same card at a gate (a retry, or a second passenger on the same pass).
+ *
+ * <p>The selection of a repeat tap is then limited to the AID: the records are taken from the
+ * cache and only read from the card on a miss, so each hit saves one read APDU per cached record.
+ * The AID selection itself cannot be saved, the key being built from its response.
+ *
+ * <p>The entries are keyed by the power-on data and the application serial number of the card.
+ * They also hold the FCI returned by the selection: an entry is served only if it has not expired
+ * and if the FCI of the new selection is unchanged. The records served are not certified and must
+ * only be used for non-secure decisions.
+ *
+ * <p>The invalidation is strict: the entry of a card must be invalidated before any write to the
+ * card. It may be put again once the secure session has been closed successfully, the card image
+ * then holding the records as written and certified by the closing.
+ */
+class CardSelectionCache final {
+public:
+    /**
+     * Identifier of a record: SFI and record number.
+     */
+    typedef std::pair<uint8_t, uint8_t> RecordId;
+
+    /**
+     * Records of a card, by identifier.
+     */
+    typedef std::map<RecordId, std::vector<uint8_t>> Records;
+
+    /**
+     * Default lifetime of an entry.
+     */
+    static const long DEFAULT_TIME_TO_LIVE_MS;
+
+    /**
+     * Default maximum number of entries, the oldest one being evicted first.
+     */
+    static const size_t DEFAULT_CAPACITY;
+
+    /**
+     * Constructor.
+     *
+     * @param recordIds The records cached, those read at the selection.
+     * @param timeToLiveMs The lifetime of an entry.
+     * @param capacity The maximum number of entries.
+     */
+    CardSelectionCache(const std::vector<RecordId>& recordIds,
+                       const long timeToLiveMs = DEFAULT_TIME_TO_LIVE_MS,
+                       const size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @return The records cached.
+     */
+    const std::vector<RecordId>& getRecordIds() const;
+
+    /**
+     * Gets the records of a card just selected.
+     *
+     * @param calypsoCard The card just selected.
+     * @param records Set to the records cached if found.
+     * @return False if the card has no valid entry.
+     */
+    bool get(std::shared_ptr<CalypsoCard> calypsoCard, Records& records);
+
+    /**
+     * Caches the records of a card, taken from its image.
+     *
+     * @param calypsoCard The card, whose image holds the records cached.
+     * @throw IllegalStateException If a record is missing from the card image.
+     */
+    void put(std::shared_ptr<CalypsoCard> calypsoCard);
+
+    /**
+     * Removes the entry of a card, to be called before any write to the card.
+     *
+     * @param calypsoCard The card.
+     */
+    void invalidate(std::shared_ptr<CalypsoCard> calypsoCard);
+
+    /**
+     * @return The ratio of the lookups served, 0 if none.
+     */
+    double getHitRate() const;
+
+    /**
+     * @return The number of record reads saved by the hits.
+     */
+    uint64_t getSavedReadCount() const;
+
+    /**
+     * Logs the statistics.
+     */
+    void logStatistics() const;
+
+private:
+    /**
+     *
+     */
+    struct Entry {
+        std::vector<uint8_t> selectApplicationResponse;
+        Records records;
+        std::chrono::steady_clock::time_point creationTime;
+    };
+
+    /**
+     * Returns the key of a card: power-on data and application serial number.
+     */
+    static std::string getKey(std::shared_ptr<CalypsoCard> calypsoCard);
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(CardSelectionCache));
+
+    /**
+     *
+     */
+    const std::vector<RecordId> mRecordIds;
+
+    /**
+     *
+     */
+    const std::chrono::milliseconds mTimeToLive;
+
+    /**
+     *
+     */
+    const size_t mCapacity;
+
+    /**
+     *
+     */
+    std::map<std::string, Entry> mEntries;
+
+    /**
+     *
+     */
+    uint64_t mHitCount;
+
+    /**
+     *
+     */
+    uint64_t mMissCount;
+
+    /**
+     *
+     */
+    uint64_t mInvalidationCount;
+
+    /**
+     *
+     */
+    uint64_t mSavedReadCount;
+
+    /**
+     *
+     */
+    mutable std::mutex mMutex;
+};
@@ -12,7 +12,6 @@
 
 #include "ConfigurationUtil.h"
 
-#include <regex>
 #include <sstream>
 
 /* Keyple Card Calypso */
@@ -69,6 +68,27 @@ void ConfigurationUtil::ReaderConfigurator::setupReader(std::shared_ptr<CardRead
     }
 }
 
+/* PLUGIN AND READER EXCEPTION HANDLER ---------------------------------------------------------- */
+
+ConfigurationUtil::PluginAndReaderExceptionHandler::PluginAndReaderExceptionHandler() {}
+
+void ConfigurationUtil::PluginAndReaderExceptionHandler::onPluginObservationError(
+    const std::string& pluginName, const std::shared_ptr<Exception> e)
+{
+    mLogger->error("An exception occurred while monitoring the plugin '%'\n", pluginName, e);
+}
+
+void ConfigurationUtil::PluginAndReaderExceptionHandler::onReaderObservationError(
+    const std::string& pluginName,
+    const std::string& readerName,
+    const std::shared_ptr<Exception> e)
+{
+    mLogger->error("An exception occurred while monitoring the reader '%/%'\n",
+                   pluginName,
+                   readerName,
+                   e);
+}
+
 /* CONFIGURATION UTIL --------------------------------------------------------------------------- */
 
 const std::string ConfigurationUtil::CARD_READER_NAME_REGEX =
@@ -78,20 +98,28 @@ const std::string ConfigurationUtil::SAM_READER_NAME_REGEX =
 const std::string ConfigurationUtil::SAM_PROTOCOL = "ISO_7816_3_T0";
 const std::string ConfigurationUtil::ISO_CARD_PROTOCOL = "ISO_14443_4_CARD";
 const std::string ConfigurationUtil::INNOVATRON_CARD_PROTOCOL = "INNOVATRON_B_PRIME_CARD";
+const std::string ConfigurationUtil::AID_KEYPLE_PREFIX = "315449432E";
 
 const std::unique_ptr<Logger> ConfigurationUtil::mLogger =
     LoggerFactory::getLogger(typeid(ConfigurationUtil));
 
+const std::regex ConfigurationUtil::mCardReaderNameRegex(CARD_READER_NAME_REGEX);
+const std::regex ConfigurationUtil::mSamReaderNameRegex(SAM_READER_NAME_REGEX);
+const size_t ConfigurationUtil::MAX_COMPILED_REGEX_COUNT = 16;
+const size_t ConfigurationUtil::MAX_READER_NAME_MATCH_COUNT = 256;
+std::map<std::string, std::regex> ConfigurationUtil::mCompiledRegexes;
+std::map<std::pair<std::string, std::string>, bool> ConfigurationUtil::mReaderNameMatches;
+std::mutex ConfigurationUtil::mReaderNameMatchingMutex;
+
 ConfigurationUtil::ConfigurationUtil() {}
 
 const std::string ConfigurationUtil::getReaderName(std::shared_ptr<Plugin> plugin,
                                                    const std::string& readerNameRegex)
 {
     std::string name = "";
-    const std::regex nameRegex(readerNameRegex);
 
     for (const auto& readerName : plugin->getReaderNames()) {
-        if (std::regex_match(readerName, nameRegex)) {
+        if (isReaderNameMatching(readerName, readerNameRegex)) {
             mLogger->info("Card reader, plugin; %, name: %\n", plugin->getName(), readerName);
             name = readerName;
             return name;
@@ -216,4 +244,148 @@ void ConfigurationUtil::setupCardResourceService(std::shared_ptr<Plugin> plugin,
 
     /* Release the resource */
     cardResourceService->releaseCardResource(cardResource);
-}
\ No newline at end of file
+}
+
+std::vector<std::pair<std::string, std::shared_ptr<CardResource>>>
+    ConfigurationUtil::setupCardResourceServiceForEachReader(std::shared_ptr<Plugin> plugin,
+                                                             const std::string& readerNameRegex,
+                                                             const std::string& samProfileName)
+{
+    /* Create one profile expecting a SAM "C1" for each matching reader */
+    std::vector<std::string> samProfileNames;
+    std::vector<std::shared_ptr<CardResourceProfileConfigurator>> samProfiles;
+
+    for (const auto& readerName : plugin->getReaderNames()) {
+        if (!isReaderNameMatching(readerName, readerNameRegex)) {
+            continue;
+        }
+
+        std::shared_ptr<CalypsoSamSelection> samSelection =
+            CalypsoExtensionService::getInstance()->createSamSelection();
+        samSelection->filterByProductType(CalypsoSam::ProductType::SAM_C1);
+
+        std::shared_ptr<CardResourceProfileExtension> samCardResourceExtension =
+            CalypsoExtensionService::getInstance()->createSamResourceProfileExtension(samSelection);
+
+        samProfileNames.push_back(samProfileName + "_" + std::to_string(samProfileNames.size()));
+        samProfiles.push_back(
+            CardResourceProfileConfigurator::builder(samProfileNames.back(),
+                                                     samCardResourceExtension)
+                ->withReaderNameRegex(toExactRegex(readerName))
+                 .build());
+
+        mLogger->info("SAM reader, plugin: %, name: %, profile: %\n",
+                      plugin->getName(),
+                      readerName,
+                      samProfileNames.back());
+    }
+
+    if (samProfileNames.empty()) {
+        std::stringstream ss;
+        ss << "Reader '" << readerNameRegex << "' not found in plugin '" << plugin->getName() << "'";
+        throw IllegalStateException(ss.str());
+    }
+
+    /* Get the service */
+    std::shared_ptr<CardResourceService> cardResourceService =
+        CardResourceServiceProvider::getService();
+
+    /*
+     * Monitor the plugin and its readers, so that the removal of a SAM kept allocated by the
+     * caller is notified to the observers of its reader.
+     */
+    auto pluginAndReaderExceptionHandler =
+        std::shared_ptr<PluginAndReaderExceptionHandler>(new PluginAndReaderExceptionHandler());
+    cardResourceService
+        ->getConfigurator()
+        ->withPlugins(
+            PluginsConfigurator::builder()
+                ->addPluginWithMonitoring(
+                      plugin,
+                      std::shared_ptr<ReaderConfigurator>(new ReaderConfigurator()),
+                      pluginAndReaderExceptionHandler,
+                      pluginAndReaderExceptionHandler)
+                 .build())
+        .withCardResourceProfiles(samProfiles)
+        .configure();
+    cardResourceService->start();
+
+    /* Verify the resources availability, keeping them allocated for the caller */
+    std::vector<std::pair<std::string, std::shared_ptr<CardResource>>> samResources;
+    for (const auto& name : samProfileNames) {
+        std::shared_ptr<CardResource> cardResource = cardResourceService->getCardResource(name);
+
+        if (cardResource == nullptr) {
+            std::stringstream ss;
+            ss << "Unable to retrieve a SAM card resource for profile '"
+               << name
+               << "' in plugin '"
+               << plugin->getName() << "'";
+            throw IllegalStateException(ss.str());
+        }
+
+        samResources.emplace_back(name, cardResource);
+    }
+
+    return samResources;
+}
+
+std::string ConfigurationUtil::toExactRegex(const std::string& value)
+{
+    static const std::string specialCharacters = "\\^$.|?*+()[]{}";
+    std::string regex;
+
+    for (const char c : value) {
+        if (specialCharacters.find(c) != std::string::npos) {
+            regex += '\\';
+        }
+        regex += c;
+    }
+
+    return regex;
+}
+
+const std::regex& ConfigurationUtil::getCompiledRegex(const std::string& readerNameRegex)
+{
+    if (readerNameRegex == CARD_READER_NAME_REGEX) {
+        return mCardReaderNameRegex;
+    }
+
+    if (readerNameRegex == SAM_READER_NAME_REGEX) {
+        return mSamReaderNameRegex;
+    }
+
+    const auto it = mCompiledRegexes.find(readerNameRegex);
+    if (it != mCompiledRegexes.end()) {
+        return it->second;
+    }
+
+    /* Compiled before any eviction, an invalid pattern leaving the cache unchanged */
+    std::regex compiledRegex(readerNameRegex);
+    if (mCompiledRegexes.size() >= MAX_COMPILED_REGEX_COUNT) {
+        mCompiledRegexes.clear();
+    }
+
+    return mCompiledRegexes.emplace(readerNameRegex, std::move(compiledRegex)).first->second;
+}
+
+bool ConfigurationUtil::isReaderNameMatching(const std::string& readerName,
+                                             const std::string& readerNameRegex)
+{
+    const std::pair<std::string, std::string> key(readerNameRegex, readerName);
+    const std::lock_guard<std::mutex> lock(mReaderNameMatchingMutex);
+
+    const auto it = mReaderNameMatches.find(key);
+    if (it != mReaderNameMatches.end()) {
+        return it->second;
+    }
+
+    const bool isMatching = std::regex_match(readerName, getCompiledRegex(readerNameRegex));
+    if (mReaderNameMatches.size() >= MAX_READER_NAME_MATCH_COUNT) {
+        mReaderNameMatches.clear();
+    }
+
+    mReaderNameMatches[key] = isMatching;
+
+    return isMatching;
+}
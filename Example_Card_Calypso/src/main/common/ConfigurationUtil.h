@@ -12,27 +12,43 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
 /* Calypsonet Terminal Calypso */
 #include "CalypsoSam.h"
 
 /* Calypsonet Terminal Reader */
 #include "CardReader.h"
+#include "CardReaderObservationExceptionHandlerSpi.h"
 
 /* Keyple Core Service */
 #include "Plugin.h"
+#include "PluginObservationExceptionHandlerSpi.h"
 #include "SmartCardServiceProvider.h"
 
 /* Keyple Core Util */
+#include "Exception.h"
 #include "LoggerFactory.h"
 
 /* Keyple Service Resource */
+#include "CardResource.h"
 #include "ReaderConfiguratorSpi.h"
 
 using namespace calypsonet::terminal::calypso::sam;
 using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::spi;
 using namespace keyple::core::service;
+using namespace keyple::core::service::resource;
 using namespace keyple::core::service::resource::spi;
+using namespace keyple::core::service::spi;
 using namespace keyple::core::util::cpp;
+using namespace keyple::core::util::cpp::exception;
 
 /**
  * Utility class providing methods for configuring readers and the card resource service used across
@@ -51,9 +67,31 @@ public:
     static const std::string ISO_CARD_PROTOCOL;
     static const std::string INNOVATRON_CARD_PROTOCOL;
 
+    /**
+     * AID prefix of the applications of the Keyple test kit
+     */
+    static const std::string AID_KEYPLE_PREFIX;
+
     static const std::string getReaderName(std::shared_ptr<Plugin> plugin,
                                            const std::string& readerNameRegex);
 
+    /**
+     * Indicates whether a reader name matches a regular expression.
+     *
+     * <p>The repeated lookups (e.g. on each reader connection) do not pay for the construction of
+     * a std::regex: CARD_READER_NAME_REGEX and SAM_READER_NAME_REGEX are compiled only once, any
+     * other pattern is compiled on its first use and kept in a bounded cache. The result is also
+     * kept per pattern and reader name in a bounded index, so that a reader name already seen is
+     * not matched again. Each cache is cleared when full.
+     *
+     * @param readerName The reader name.
+     * @param readerNameRegex A regular expression matching the targeted readers.
+     * @return True if the name matches.
+     * @throw std::regex_error If the regular expression is invalid.
+     */
+    static bool isReaderNameMatching(const std::string& readerName,
+                                     const std::string& readerNameRegex);
+
     /**
      * Retrieves the contactless card reader the first available reader in the provided plugin whose
      * name matches the provided regular expression.
@@ -99,6 +137,33 @@ public:
                                          const std::string& readerNameRegex,
                                          const std::string& samProfileName);
 
+    /**
+     * Set up the CardResourceService to provide a Calypso SAM C1 resource from each SAM reader
+     * matching the regex, through one profile per reader, so that the application can choose the
+     * SAM to use (e.g. with a CardResourcePool).
+     *
+     * <p>The profiles are named after the provided profile name followed by "_" and the index of
+     * the reader.
+     *
+     * <p>The plugin and its readers are monitored by the service, so that a SAM removal is notified
+     * to the observers of the SAM readers.
+     *
+     * <p>The SAM resource allocated for each profile by the availability check is not released but
+     * returned, so that the caller can keep it (e.g. in a CardResourceLease) without selecting the
+     * SAM again.
+     *
+     * @param plugin The plugin to which the SAM readers belong (must be observable).
+     * @param readerNameRegex A regular expression matching the expected SAM reader names.
+     * @param samProfileName A string defining the base name of the SAM profiles.
+     * @return The names of the profiles created, each with the SAM resource allocated for it.
+     * @throw IllegalStateException If no reader matches or if an expected card resource is not
+     *        found.
+     */
+    static std::vector<std::pair<std::string, std::shared_ptr<CardResource>>>
+        setupCardResourceServiceForEachReader(std::shared_ptr<Plugin> plugin,
+                                              const std::string& readerNameRegex,
+                                              const std::string& samProfileName);
+
 private:
     /*
      * Reader configurator used by the card resource service to set up the SAM reader with the
@@ -127,11 +192,93 @@ private:
         ReaderConfigurator();
     };
 
+    /*
+     * Exception handler used by the card resource service when monitoring the plugin and its
+     * readers.
+     */
+    class PluginAndReaderExceptionHandler final
+    : public PluginObservationExceptionHandlerSpi, public CardReaderObservationExceptionHandlerSpi {
+    public:
+        friend class ConfigurationUtil;
+
+        /**
+         * {@inheritDoc}
+         */
+        void onPluginObservationError(const std::string& pluginName,
+                                      const std::shared_ptr<Exception> e) override;
+
+        /**
+         * {@inheritDoc}
+         */
+        void onReaderObservationError(const std::string& pluginName,
+                                      const std::string& readerName,
+                                      const std::shared_ptr<Exception> e) override;
+
+    private:
+        /**
+         *
+         */
+        const std::unique_ptr<Logger> mLogger =
+            LoggerFactory::getLogger(typeid(PluginAndReaderExceptionHandler));
+
+        /**
+         * (private)<br>
+         * Constructor.
+         */
+        PluginAndReaderExceptionHandler();
+    };
+
     /**
      *
      */
     static const std::unique_ptr<Logger> mLogger;
 
+    /**
+     * Compiled CARD_READER_NAME_REGEX.
+     */
+    static const std::regex mCardReaderNameRegex;
+
+    /**
+     * Compiled SAM_READER_NAME_REGEX.
+     */
+    static const std::regex mSamReaderNameRegex;
+
+    /**
+     * Maximum number of patterns compiled on their first use.
+     */
+    static const size_t MAX_COMPILED_REGEX_COUNT;
+
+    /**
+     * Maximum number of matching results kept.
+     */
+    static const size_t MAX_READER_NAME_MATCH_COUNT;
+
+    /**
+     * Patterns compiled on their first use, by pattern.
+     */
+    static std::map<std::string, std::regex> mCompiledRegexes;
+
+    /**
+     * Matching results, by pattern and reader name.
+     */
+    static std::map<std::pair<std::string, std::string>, bool> mReaderNameMatches;
+
+    /**
+     * Protects the caches.
+     */
+    static std::mutex mReaderNameMatchingMutex;
+
+    /**
+     * Returns the compiled pattern, compiling it if not known, the caller holding
+     * mReaderNameMatchingMutex.
+     */
+    static const std::regex& getCompiledRegex(const std::string& readerNameRegex);
+
+    /**
+     * Returns a regular expression matching exactly the provided string.
+     */
+    static std::string toExactRegex(const std::string& value);
+
     /**
      * (private)<br>
      * Constructor.
@@ -0,0 +1,187 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "DebouncingCardReaderObserver.h"
+
+/* Calypsonet Terminal Reader */
+#include "CardSelectionResult.h"
+#include "SmartCard.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+
+using namespace calypsonet::terminal::reader::selection::spi;
+using namespace keyple::core::util;
+
+const long DebouncingCardReaderObserver::DEFAULT_DEBOUNCE_DELAY_MS = 500;
+
+DebouncingCardReaderObserver::DebouncingCardReaderObserver(
+  std::shared_ptr<CardReaderObserverSpi> observer,
+  std::shared_ptr<ObservableCardReader> reader,
+  std::shared_ptr<CardSelectionManager> cardSelectionManager,
+  const long debounceDelayMs)
+: mObserver(observer),
+  mReader(reader),
+  mCardSelectionManager(cardSelectionManager),
+  mDebounceDelay(debounceDelayMs),
+  mIsStopping(false),
+  mForwardedEventCount(0),
+  mSavedTransactionCount(0)
+{
+    mDeliveryThread = std::thread(&DebouncingCardReaderObserver::deliverRemovals, this);
+}
+
+DebouncingCardReaderObserver::~DebouncingCardReaderObserver()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        mIsStopping = true;
+    }
+
+    mCondition.notify_all();
+    mDeliveryThread.join();
+}
+
+std::string DebouncingCardReaderObserver::getCardIdentity(
+    const std::shared_ptr<CardReaderEvent> event) const
+{
+    if (event->getType() != CardReaderEvent::Type::CARD_MATCHED) {
+        return "";
+    }
+
+    const std::shared_ptr<SmartCard> smartCard =
+        mCardSelectionManager->parseScheduledCardSelectionsResponse(
+                                  event->getScheduledCardSelectionsResponse())
+                             ->getActiveSmartCard();
+    if (smartCard == nullptr) {
+        return "";
+    }
+
+    return smartCard->getPowerOnData() +
+           "/" +
+           HexUtil::toHex(smartCard->getSelectApplicationResponse());
+}
+
+void DebouncingCardReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> event)
+{
+    /* Parsed before locking, the removals being delivered meanwhile */
+    const std::string cardIdentity = getCardIdentity(event);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (event->getType() == CardReaderEvent::Type::CARD_REMOVED) {
+        /* Held until the delay is elapsed */
+        mPendingRemoval = event;
+        mPendingRemovalDeadline = std::chrono::steady_clock::now() + mDebounceDelay;
+        mCondition.notify_all();
+
+        return;
+    }
+
+    if (event->getType() != CardReaderEvent::Type::CARD_INSERTED &&
+        event->getType() != CardReaderEvent::Type::CARD_MATCHED) {
+        forward(lock, event);
+        return;
+    }
+
+    if (mPendingRemoval != nullptr &&
+        !cardIdentity.empty() &&
+        cardIdentity == mLastCardIdentity) {
+        /* The same card is back in time: the presentation continues, not processed again */
+        mPendingRemoval = nullptr;
+        mSavedTransactionCount++;
+        mLogger->info("Re-insertion of the same card suppressed on reader %, transaction saved " \
+                      "(% so far)\n",
+                      event->getReaderName(),
+                      mSavedTransactionCount);
+        lock.unlock();
+
+        mReader->finalizeCardProcessing();
+
+        return;
+    }
+
+    if (mPendingRemoval != nullptr) {
+        /* Another card: the previous one has really left */
+        const std::shared_ptr<CardReaderEvent> removal = mPendingRemoval;
+        mPendingRemoval = nullptr;
+        forward(lock, removal);
+        lock.lock();
+    }
+
+    mLastCardIdentity = cardIdentity;
+    forward(lock, event);
+}
+
+void DebouncingCardReaderObserver::deliverRemovals()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (true) {
+        if (mPendingRemoval == nullptr) {
+            if (mIsStopping) {
+                return;
+            }
+            mCondition.wait(lock);
+            continue;
+        }
+
+        /* No event is lost on destruction: the held removal is forwarded at once */
+        if (!mIsStopping && std::chrono::steady_clock::now() < mPendingRemovalDeadline) {
+            mCondition.wait_until(lock, mPendingRemovalDeadline);
+            continue;
+        }
+
+        std::shared_ptr<CardReaderEvent> removal = mPendingRemoval;
+        mPendingRemoval = nullptr;
+        forward(lock, removal);
+        lock.lock();
+    }
+}
+
+void DebouncingCardReaderObserver::forward(std::unique_lock<std::mutex>& lock,
+                                           const std::shared_ptr<CardReaderEvent> event)
+{
+    mForwardedEventCount++;
+
+    /* Taken before mMutex is released, so that the events are forwarded in order */
+    const std::lock_guard<std::mutex> forwardLock(mForwardMutex);
+    lock.unlock();
+
+    mObserver->onReaderEvent(event);
+}
+
+uint64_t DebouncingCardReaderObserver::getForwardedEventCount()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mForwardedEventCount;
+}
+
+uint64_t DebouncingCardReaderObserver::getSavedTransactionCount()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mSavedTransactionCount;
+}
+
+void DebouncingCardReaderObserver::logStatistics()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    mLogger->info("Events forwarded: %, transactions saved by dropping the re-insertions of the " \
+                  "same card: % (debounce delay: % ms)\n",
+                  mForwardedEventCount,
+                  mSavedTransactionCount,
+                  mDebounceDelay.count());
+}
@@ -0,0 +1,186 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/* Calypsonet Terminal Reader */
+#include "CardReaderEvent.h"
+#include "CardReaderObserverSpi.h"
+#include "CardSelectionManager.h"
+#include "ObservableCardReader.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::selection;
+using namespace calypsonet::terminal::reader::spi;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Reader observer placed in front of another reader observer to absorb the rapid
+ * CARD_REMOVED/CARD_MATCHED sequences produced by a card held at the edge of the field.
+ *
+ * <p>A card removal is held for the debounce delay. If the same card is matched again in the
+ * meantime, both the removal and the new insertion are dropped: the observer sees the presentation
+ * continuing and does not process the card a second time, each drop saving a transaction. The
+ * suppressed insertion is finalized on the reader in place of the observer. The card is identified
+ * by its power-on data and its selection response, which holds the serial number of a Calypso
+ * card.
+ *
+ * <p>Any other card insertion (another card, or a CARD_INSERTED carrying no selection response) is
+ * forwarded at once, after the removal held if any, so that the card of the next passenger is
+ * processed. A removal not followed by the same card is forwarded once the delay is elapsed.
+ */
+class DebouncingCardReaderObserver final : public CardReaderObserverSpi {
+public:
+    /**
+     * Default debounce delay in milliseconds.
+     */
+    static const long DEFAULT_DEBOUNCE_DELAY_MS;
+
+    /**
+     * Constructor.
+     *
+     * @param observer The observer to which the retained events are forwarded.
+     * @param reader The observed reader, whose suppressed insertions are finalized.
+     * @param cardSelectionManager The card selection manager of the scheduled selection scenario,
+     *        used to identify the matched cards.
+     * @param debounceDelayMs The debounce delay in milliseconds.
+     */
+    DebouncingCardReaderObserver(std::shared_ptr<CardReaderObserverSpi> observer,
+                                 std::shared_ptr<ObservableCardReader> reader,
+                                 std::shared_ptr<CardSelectionManager> cardSelectionManager,
+                                 const long debounceDelayMs = DEFAULT_DEBOUNCE_DELAY_MS);
+
+    /**
+     * Forwards the removal still held, if any, and stops the delivery thread.
+     */
+    ~DebouncingCardReaderObserver();
+
+    /**
+     * {@inheritDoc}
+     */
+    void onReaderEvent(const std::shared_ptr<CardReaderEvent> event) override;
+
+    /**
+     * @return The number of events forwarded to the observer.
+     */
+    uint64_t getForwardedEventCount();
+
+    /**
+     * @return The number of transactions saved: re-insertions of the same card dropped, with the
+     *         removal preceding them.
+     */
+    uint64_t getSavedTransactionCount();
+
+    /**
+     * Logs the number of forwarded events and of transactions saved.
+     */
+    void logStatistics();
+
+private:
+    /**
+     * Returns the identity of the card of a CARD_MATCHED event (power-on data and selection
+     * response), empty if not available.
+     */
+    std::string getCardIdentity(const std::shared_ptr<CardReaderEvent> event) const;
+
+    /**
+     * Forwards the held removal once its delay is elapsed, until the observer is destroyed.
+     */
+    void deliverRemovals();
+
+    /**
+     * Forwards an event to the observer, in the order of the decisions taken under mMutex.
+     *
+     * @param lock The lock of mMutex, released once the delivery order is secured.
+     * @param event The event to forward.
+     */
+    void forward(std::unique_lock<std::mutex>& lock, const std::shared_ptr<CardReaderEvent> event);
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger =
+        LoggerFactory::getLogger(typeid(DebouncingCardReaderObserver));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardReaderObserverSpi> mObserver;
+
+    /**
+     *
+     */
+    std::shared_ptr<ObservableCardReader> mReader;
+
+    /**
+     *
+     */
+    std::shared_ptr<CardSelectionManager> mCardSelectionManager;
+
+    /**
+     *
+     */
+    const std::chrono::milliseconds mDebounceDelay;
+
+    /**
+     * Removal held until mPendingRemovalDeadline, null if none.
+     */
+    std::shared_ptr<CardReaderEvent> mPendingRemoval;
+    std::chrono::steady_clock::time_point mPendingRemovalDeadline;
+
+    /**
+     * Identity of the last card forwarded, empty if unknown.
+     */
+    std::string mLastCardIdentity;
+
+    /**
+     *
+     */
+    bool mIsStopping;
+
+    /**
+     * Statistics.
+     */
+    uint64_t mForwardedEventCount;
+    uint64_t mSavedTransactionCount;
+
+    /**
+     * Protects the state above.
+     */
+    std::mutex mMutex;
+
+    /**
+     * Held while an event is forwarded, taken before mMutex is released.
+     */
+    std::mutex mForwardMutex;
+
+    /**
+     *
+     */
+    std::condition_variable mCondition;
+
+    /**
+     *
+     */
+    std::thread mDeliveryThread;
+};
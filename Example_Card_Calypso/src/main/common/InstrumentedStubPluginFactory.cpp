@@ -0,0 +1,70 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "InstrumentedStubPluginFactory.h"
+
+/* Keyple Core Common */
+#include "CommonApiProperties.h"
+
+/* Keyple Core Plugin */
+#include "PluginApiProperties.h"
+
+using namespace keyple::core::plugin;
+
+/* INSTRUMENTED STUB PLUGIN --------------------------------------------------------------------- */
+
+InstrumentedStubPluginFactory::InstrumentedStubPlugin::InstrumentedStubPlugin(
+  const std::string& name, const std::vector<std::shared_ptr<InstrumentedStubReader>>& readers)
+: mName(name), mReaders(readers) {}
+
+const std::string& InstrumentedStubPluginFactory::InstrumentedStubPlugin::getName() const
+{
+    return mName;
+}
+
+const std::vector<std::shared_ptr<ReaderSpi>>
+    InstrumentedStubPluginFactory::InstrumentedStubPlugin::searchAvailableReaders()
+{
+    return std::vector<std::shared_ptr<ReaderSpi>>(mReaders.begin(), mReaders.end());
+}
+
+void InstrumentedStubPluginFactory::InstrumentedStubPlugin::onUnregister()
+{
+    /* Nothing to do here in this plugin */
+}
+
+/* INSTRUMENTED STUB PLUGIN FACTORY ------------------------------------------------------------- */
+
+InstrumentedStubPluginFactory::InstrumentedStubPluginFactory(
+  const std::string& pluginName,
+  const std::vector<std::shared_ptr<InstrumentedStubReader>>& readers)
+: mPluginName(pluginName), mReaders(readers) {}
+
+const std::string& InstrumentedStubPluginFactory::getPluginApiVersion() const
+{
+    return PluginApiProperties_VERSION;
+}
+
+const std::string& InstrumentedStubPluginFactory::getCommonApiVersion() const
+{
+    return CommonApiProperties_VERSION;
+}
+
+const std::string& InstrumentedStubPluginFactory::getPluginName() const
+{
+    return mPluginName;
+}
+
+std::shared_ptr<PluginSpi> InstrumentedStubPluginFactory::getPlugin()
+{
+    return std::make_shared<InstrumentedStubPlugin>(mPluginName, mReaders);
+}
@@ -0,0 +1,120 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Keyple Core Common */
+#include "KeyplePluginExtension.h"
+#include "KeyplePluginExtensionFactory.h"
+
+/* Keyple Core Plugin */
+#include "PluginFactorySpi.h"
+#include "PluginSpi.h"
+
+/* Keyple Cpp Example */
+#include "InstrumentedStubReader.h"
+
+using namespace keyple::core::common;
+using namespace keyple::core::plugin::spi;
+
+/**
+ * Factory of a plugin whose readers are InstrumentedStubReader, counting the APDUs exchanged and
+ * simulating the time of the exchanges, to be registered with SmartCardService::registerPlugin.
+ *
+ * <p>The readers are created by the application, which keeps them to insert and remove the cards
+ * and to read the number of APDUs exchanged.
+ */
+class InstrumentedStubPluginFactory final
+: public PluginFactorySpi, public KeyplePluginExtensionFactory {
+public:
+    /**
+     * Constructor.
+     *
+     * @param pluginName The name of the plugin.
+     * @param readers The readers of the plugin.
+     */
+    InstrumentedStubPluginFactory(const std::string& pluginName,
+                                  const std::vector<std::shared_ptr<InstrumentedStubReader>>& readers);
+
+    /**
+     * {@inheritDoc}
+     */
+    const std::string& getPluginApiVersion() const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    const std::string& getCommonApiVersion() const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    const std::string& getPluginName() const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    std::shared_ptr<PluginSpi> getPlugin() override;
+
+private:
+    /**
+     * Plugin providing the readers of the factory.
+     */
+    class InstrumentedStubPlugin final : public PluginSpi, public KeyplePluginExtension {
+    public:
+        /**
+         *
+         */
+        InstrumentedStubPlugin(const std::string& name,
+                               const std::vector<std::shared_ptr<InstrumentedStubReader>>& readers);
+
+        /**
+         * {@inheritDoc}
+         */
+        const std::string& getName() const override;
+
+        /**
+         * {@inheritDoc}
+         */
+        const std::vector<std::shared_ptr<ReaderSpi>> searchAvailableReaders() override;
+
+        /**
+         * {@inheritDoc}
+         */
+        void onUnregister() override;
+
+    private:
+        /**
+         *
+         */
+        const std::string mName;
+
+        /**
+         *
+         */
+        const std::vector<std::shared_ptr<InstrumentedStubReader>> mReaders;
+    };
+
+    /**
+     *
+     */
+    const std::string mPluginName;
+
+    /**
+     *
+     */
+    const std::vector<std::shared_ptr<InstrumentedStubReader>> mReaders;
+};
@@ -0,0 +1,156 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "InstrumentedStubReader.h"
+
+/* Keyple Core Plugin */
+#include "CardIOException.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+
+using namespace keyple::core::plugin;
+using namespace keyple::core::util;
+
+InstrumentedStubReader::InstrumentedStubReader(const std::string& name,
+                                               const bool isContactless,
+                                               std::shared_ptr<StubSmartCard> smartCard,
+                                               std::shared_ptr<SamLatencyModel> latencyModel)
+: mName(name),
+  mIsContactless(isContactless),
+  mSmartCard(smartCard),
+  mLatencyModel(latencyModel),
+  mApduCount(0) {}
+
+void InstrumentedStubReader::insertCard(std::shared_ptr<StubSmartCard> smartCard)
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    mSmartCard = smartCard;
+}
+
+void InstrumentedStubReader::removeCard()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mSmartCard != nullptr) {
+        mSmartCard->closePhysicalChannel();
+        mSmartCard = nullptr;
+    }
+}
+
+uint64_t InstrumentedStubReader::getApduCount() const
+{
+    return mApduCount;
+}
+
+const std::string& InstrumentedStubReader::getName() const
+{
+    return mName;
+}
+
+void InstrumentedStubReader::openPhysicalChannel()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mSmartCard != nullptr) {
+        mSmartCard->openPhysicalChannel();
+    }
+}
+
+void InstrumentedStubReader::closePhysicalChannel()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mSmartCard != nullptr) {
+        mSmartCard->closePhysicalChannel();
+    }
+}
+
+bool InstrumentedStubReader::isPhysicalChannelOpen() const
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mSmartCard != nullptr && mSmartCard->isPhysicalChannelOpen();
+}
+
+bool InstrumentedStubReader::checkCardPresence()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mSmartCard != nullptr;
+}
+
+const std::string InstrumentedStubReader::getPowerOnData() const
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mSmartCard != nullptr ? HexUtil::toHex(mSmartCard->getPowerOnData()) : "";
+}
+
+const std::vector<uint8_t> InstrumentedStubReader::transmitApdu(const std::vector<uint8_t>& apduIn)
+{
+    std::shared_ptr<StubSmartCard> smartCard;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        smartCard = mSmartCard;
+    }
+
+    if (smartCard == nullptr) {
+        throw CardIOException("No card available.");
+    }
+
+    const std::vector<uint8_t> apduOut = smartCard->processApdu(apduIn);
+    mApduCount++;
+
+    if (mLatencyModel != nullptr) {
+        mLatencyModel->simulate(1, apduIn.size() + apduOut.size());
+    }
+
+    return apduOut;
+}
+
+bool InstrumentedStubReader::isContactless()
+{
+    return mIsContactless;
+}
+
+void InstrumentedStubReader::onUnregister()
+{
+    /* Nothing to do here in this reader */
+}
+
+bool InstrumentedStubReader::isProtocolSupported(const std::string& readerProtocol) const
+{
+    (void)readerProtocol;
+
+    return true;
+}
+
+void InstrumentedStubReader::activateProtocol(const std::string& readerProtocol)
+{
+    /* The protocol of the card is given by the stub card itself */
+    (void)readerProtocol;
+}
+
+void InstrumentedStubReader::deactivateProtocol(const std::string& readerProtocol)
+{
+    (void)readerProtocol;
+}
+
+bool InstrumentedStubReader::isCurrentProtocol(const std::string& readerProtocol) const
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mSmartCard != nullptr && mSmartCard->getCardProtocol() == readerProtocol;
+}
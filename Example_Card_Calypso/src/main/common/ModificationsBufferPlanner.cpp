@@ -0,0 +1,338 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "ModificationsBufferPlanner.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/* Keyple Core Util */
+#include "IllegalArgumentException.h"
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+/* Bytes of buffer management added by the card to each command stored */
+static const int SESSION_BUFFER_CMD_ADDITIONAL_COST = 6;
+
+/* Body of an Increase/Decrease APDU: the 3-byte value and Le */
+static const int COUNTER_APDU_BODY_LENGTH = 4;
+
+ModificationsBufferPlanner::ModificationsBufferPlanner(std::shared_ptr<CalypsoCard> calypsoCard)
+: mBufferCapacity(calypsoCard->getModificationsCounter()),
+  mIsBufferCapacityInBytes(calypsoCard->isModificationsCounterInBytes()),
+  mIsPipelined(false),
+  mLastSessionConsumption(0) {}
+
+ModificationsBufferPlanner& ModificationsBufferPlanner::setPipelined(const bool isPipelined)
+{
+    mIsPipelined = isPipelined;
+
+    return *this;
+}
+
+int ModificationsBufferPlanner::getBufferCapacity() const
+{
+    return mBufferCapacity;
+}
+
+bool ModificationsBufferPlanner::isBufferCapacityInBytes() const
+{
+    return mIsBufferCapacityInBytes;
+}
+
+int ModificationsBufferPlanner::getBufferConsumption(const int apduBodyLength) const
+{
+    return mIsBufferCapacityInBytes ? apduBodyLength + SESSION_BUFFER_CMD_ADDITIONAL_COST : 1;
+}
+
+void ModificationsBufferPlanner::addCommand(const PlannedCommand& command, const int apduBodyLength)
+{
+    const int consumption = getBufferConsumption(apduBodyLength);
+
+    if (consumption > mBufferCapacity) {
+        throw IllegalArgumentException("The command needs " +
+                                       std::to_string(consumption) +
+                                       " units of a modifications buffer of " +
+                                       std::to_string(mBufferCapacity));
+    }
+
+    /* Greedy filling, optimal as the order of the commands is kept */
+    if (mSessionStarts.empty() || mLastSessionConsumption + consumption > mBufferCapacity) {
+        mSessionStarts.push_back(mCommands.size());
+        mLastSessionConsumption = 0;
+    }
+
+    mLastSessionConsumption += consumption;
+    mCommands.push_back(command);
+    mCommands.back().apduBodyLength = apduBodyLength;
+}
+
+ModificationsBufferPlanner& ModificationsBufferPlanner::addAppendRecord(
+    const uint8_t sfi, const std::vector<uint8_t>& recordData)
+{
+    addCommand({PlannedCommand::Type::APPEND_RECORD, sfi, 0, recordData, 0, nullptr, 0},
+               static_cast<int>(recordData.size()));
+
+    return *this;
+}
+
+ModificationsBufferPlanner& ModificationsBufferPlanner::addAppendRecord(
+    const uint8_t sfi, const size_t recordSize, std::shared_ptr<RecordSupplier> recordSupplier)
+{
+    addCommand({PlannedCommand::Type::APPEND_RECORD, sfi, 0, {}, 0, recordSupplier, 0},
+               static_cast<int>(recordSize));
+
+    return *this;
+}
+
+ModificationsBufferPlanner& ModificationsBufferPlanner::addUpdateRecord(
+    const uint8_t sfi, const uint8_t recordNumber, const std::vector<uint8_t>& recordData)
+{
+    addCommand({PlannedCommand::Type::UPDATE_RECORD, sfi, recordNumber, recordData, 0, nullptr, 0},
+               static_cast<int>(recordData.size()));
+
+    return *this;
+}
+
+ModificationsBufferPlanner& ModificationsBufferPlanner::addWriteRecord(
+    const uint8_t sfi, const uint8_t recordNumber, const std::vector<uint8_t>& recordData)
+{
+    addCommand({PlannedCommand::Type::WRITE_RECORD, sfi, recordNumber, recordData, 0, nullptr, 0},
+               static_cast<int>(recordData.size()));
+
+    return *this;
+}
+
+ModificationsBufferPlanner& ModificationsBufferPlanner::addIncreaseCounter(
+    const uint8_t sfi, const uint8_t counterNumber, const int incValue)
+{
+    addCommand({PlannedCommand::Type::INCREASE, sfi, counterNumber, {}, incValue, nullptr, 0},
+               COUNTER_APDU_BODY_LENGTH);
+
+    return *this;
+}
+
+ModificationsBufferPlanner& ModificationsBufferPlanner::addDecreaseCounter(
+    const uint8_t sfi, const uint8_t counterNumber, const int decValue)
+{
+    addCommand({PlannedCommand::Type::DECREASE, sfi, counterNumber, {}, decValue, nullptr, 0},
+               COUNTER_APDU_BODY_LENGTH);
+
+    return *this;
+}
+
+size_t ModificationsBufferPlanner::getCommandCount() const
+{
+    return mCommands.size();
+}
+
+size_t ModificationsBufferPlanner::getSessionCount() const
+{
+    return mSessionStarts.size();
+}
+
+size_t ModificationsBufferPlanner::getSessionEnd(const size_t session) const
+{
+    return session + 1 < mSessionStarts.size() ? mSessionStarts[session + 1] : mCommands.size();
+}
+
+void ModificationsBufferPlanner::prepare(std::shared_ptr<CardTransactionManager> cardTransaction,
+                                         const PlannedCommand& command,
+                                         const std::vector<uint8_t>& data)
+{
+    switch (command.type) {
+    case PlannedCommand::Type::APPEND_RECORD:
+        cardTransaction->prepareAppendRecord(command.sfi, data);
+        break;
+    case PlannedCommand::Type::UPDATE_RECORD:
+        cardTransaction->prepareUpdateRecord(command.sfi, command.number, data);
+        break;
+    case PlannedCommand::Type::WRITE_RECORD:
+        cardTransaction->prepareWriteRecord(command.sfi, command.number, data);
+        break;
+    case PlannedCommand::Type::INCREASE:
+        cardTransaction->prepareIncreaseCounter(command.sfi, command.number, command.value);
+        break;
+    case PlannedCommand::Type::DECREASE:
+        cardTransaction->prepareDecreaseCounter(command.sfi, command.number, command.value);
+        break;
+    }
+}
+
+ModificationsBufferPlanner::SessionRecords ModificationsBufferPlanner::produceSessionRecords(
+    const size_t session) const
+{
+    const size_t begin = mSessionStarts[session];
+    SessionRecords sessionRecords(getSessionEnd(session) - begin);
+
+    for (size_t i = 0; i < sessionRecords.size(); i++) {
+        const PlannedCommand& command = mCommands[begin + i];
+        if (command.recordSupplier == nullptr) {
+            continue;
+        }
+
+        sessionRecords[i] = command.recordSupplier->getRecordData();
+        if (static_cast<int>(sessionRecords[i].size()) != command.apduBodyLength) {
+            throw IllegalStateException("Record of " +
+                                        std::to_string(sessionRecords[i].size()) +
+                                        " bytes supplied instead of " +
+                                        std::to_string(command.apduBodyLength));
+        }
+    }
+
+    return sessionRecords;
+}
+
+void ModificationsBufferPlanner::executeSession(
+    std::shared_ptr<CardTransactionManager> cardTransaction,
+    const WriteAccessLevel writeAccessLevel,
+    const size_t session,
+    const SessionRecords& sessionRecords)
+{
+    const size_t begin = mSessionStarts[session];
+    const size_t end = getSessionEnd(session);
+
+    cardTransaction->processOpening(writeAccessLevel);
+    for (size_t i = begin; i < end; i++) {
+        const PlannedCommand& command = mCommands[i];
+        prepare(cardTransaction,
+                command,
+                command.recordSupplier != nullptr ? sessionRecords[i - begin] : command.data);
+    }
+    cardTransaction->processClosing();
+}
+
+void ModificationsBufferPlanner::executePipelined(
+    std::shared_ptr<CardTransactionManager> cardTransaction,
+    const WriteAccessLevel writeAccessLevel)
+{
+    /* Records produced and not yet taken for the exchanges, at most one session */
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<SessionRecords> producedSessions;
+    std::exception_ptr productionError;
+    bool isCancelled = false;
+
+    std::thread productionThread([&]() {
+        for (size_t session = 0; session < mSessionStarts.size(); session++) {
+            SessionRecords sessionRecords;
+            try {
+                sessionRecords = produceSessionRecords(session);
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mutex);
+                productionError = std::current_exception();
+                condition.notify_all();
+                return;
+            }
+
+            /* The next session is produced once this one is being exchanged */
+            std::unique_lock<std::mutex> lock(mutex);
+            producedSessions.push_back(std::move(sessionRecords));
+            condition.notify_all();
+            condition.wait(lock, [&]() { return isCancelled || producedSessions.empty(); });
+            if (isCancelled) {
+                return;
+            }
+        }
+    });
+
+    try {
+        for (size_t session = 0; session < mSessionStarts.size(); session++) {
+            SessionRecords sessionRecords;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() {
+                    return productionError != nullptr || !producedSessions.empty();
+                });
+                if (producedSessions.empty()) {
+                    std::rethrow_exception(productionError);
+                }
+                sessionRecords = std::move(producedSessions.front());
+                producedSessions.pop_front();
+                condition.notify_all();
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            executeSession(cardTransaction, writeAccessLevel, session, sessionRecords);
+            mSessionDurationsUs.push_back(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+        }
+
+    } catch (...) {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            isCancelled = true;
+            condition.notify_all();
+        }
+        productionThread.join();
+        throw;
+    }
+
+    productionThread.join();
+}
+
+void ModificationsBufferPlanner::execute(std::shared_ptr<CardTransactionManager> cardTransaction,
+                                         const WriteAccessLevel writeAccessLevel)
+{
+    mSessionDurationsUs.clear();
+
+    if (mIsPipelined) {
+        executePipelined(cardTransaction, writeAccessLevel);
+        return;
+    }
+
+    for (size_t session = 0; session < mSessionStarts.size(); session++) {
+        const SessionRecords sessionRecords = produceSessionRecords(session);
+
+        const auto start = std::chrono::steady_clock::now();
+        executeSession(cardTransaction, writeAccessLevel, session, sessionRecords);
+        mSessionDurationsUs.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+const std::vector<uint64_t>& ModificationsBufferPlanner::getSessionDurationsUs() const
+{
+    return mSessionDurationsUs;
+}
+
+void ModificationsBufferPlanner::logStatistics() const
+{
+    mLogger->info("Modifications buffer of % %: % commands in % sessions%\n",
+                  mBufferCapacity,
+                  mIsBufferCapacityInBytes ? "bytes" : "commands",
+                  mCommands.size(),
+                  mSessionStarts.size(),
+                  mIsPipelined ? ", pipelined" : "");
+
+    uint64_t totalDurationUs = 0;
+    for (size_t session = 0; session < mSessionDurationsUs.size(); session++) {
+        mLogger->info("Session %: % commands, % ms\n",
+                      session + 1,
+                      getSessionEnd(session) - mSessionStarts[session],
+                      mSessionDurationsUs[session] / 1000);
+        totalDurationUs += mSessionDurationsUs[session];
+    }
+
+    if (!mSessionDurationsUs.empty()) {
+        mLogger->info("Average time per session: % ms\n",
+                      totalDurationUs / mSessionDurationsUs.size() / 1000);
+    }
+}
@@ -0,0 +1,306 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* Calypsonet Terminal Calypso */
+#include "CalypsoCard.h"
+#include "CardTransactionManager.h"
+#include "WriteAccessLevel.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::calypso;
+using namespace calypsonet::terminal::calypso::card;
+using namespace calypsonet::terminal::calypso::transaction;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Planning of a large batch of card modifications into the fewest secure sessions.
+ *
+ * <p>The capacity of the modifications buffer is read from the selected card, in bytes or in
+ * number of commands. In bytes, a command consumes the length of its APDU without the header, plus
+ * 6 bytes of buffer management, e.g. 35 bytes for an Append Record of 29 bytes. The commands being
+ * kept in their order, filling each session up to the capacity before starting the next one gives
+ * the minimum number of sessions, and thus of ratifications.
+ *
+ * <p>The planned commands are then executed session by session, without relying on the multiple
+ * session mode of the library, and the duration of each session is measured.
+ *
+ * <p>The content of a record may be produced only at execution (e.g. encoded or ciphered), its
+ * size being enough to plan it. In pipelined mode, a single helper thread started by the execution
+ * produces the records session by session, one session ahead: the records of the next session are
+ * produced while the current session is exchanged with the card and the SAM, so that the next
+ * opening does not wait for them. Only the host production time is overlapped, the exchanges being
+ * unchanged.
+ */
+class ModificationsBufferPlanner final {
+public:
+    /**
+     * Producer of the content of a record, called at execution.
+     */
+    class RecordSupplier {
+    public:
+        /**
+         *
+         */
+        virtual ~RecordSupplier() = default;
+
+        /**
+         * Produces the content of a record, called from the helper thread in pipelined mode, in the
+         * order of the commands.
+         *
+         * @return The record content, of the size announced when it was added.
+         */
+        virtual std::vector<uint8_t> getRecordData() = 0;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param calypsoCard The selected card, providing the capacity of its modifications buffer.
+     */
+    explicit ModificationsBufferPlanner(std::shared_ptr<CalypsoCard> calypsoCard);
+
+    /**
+     * Produces the records of the next session while the current session is exchanged.
+     *
+     * @param isPipelined True to enable the pipelined mode, false by default.
+     * @return The current instance.
+     */
+    ModificationsBufferPlanner& setPipelined(const bool isPipelined);
+
+    /**
+     * @return The capacity of the modifications buffer, in bytes or in number of commands.
+     */
+    int getBufferCapacity() const;
+
+    /**
+     * @return True if the capacity of the modifications buffer is in bytes.
+     */
+    bool isBufferCapacityInBytes() const;
+
+    /**
+     * Adds an Append Record command.
+     *
+     * @param sfi The SFI of the file.
+     * @param recordData The record content.
+     * @return The current instance.
+     * @throw IllegalArgumentException If the command alone does not fit in the buffer.
+     */
+    ModificationsBufferPlanner& addAppendRecord(const uint8_t sfi,
+                                                const std::vector<uint8_t>& recordData);
+
+    /**
+     * Adds an Append Record command whose content is produced at execution.
+     *
+     * @param sfi The SFI of the file.
+     * @param recordSize The size of the record content.
+     * @param recordSupplier The producer of the record content.
+     * @return The current instance.
+     * @throw IllegalArgumentException If the command alone does not fit in the buffer.
+     */
+    ModificationsBufferPlanner& addAppendRecord(const uint8_t sfi,
+                                                const size_t recordSize,
+                                                std::shared_ptr<RecordSupplier> recordSupplier);
+
+    /**
+     * Adds an Update Record command.
+     *
+     * @param sfi The SFI of the file.
+     * @param recordNumber The record number.
+     * @param recordData The record content.
+     * @return The current instance.
+     * @throw IllegalArgumentException If the command alone does not fit in the buffer.
+     */
+    ModificationsBufferPlanner& addUpdateRecord(const uint8_t sfi,
+                                                const uint8_t recordNumber,
+                                                const std::vector<uint8_t>& recordData);
+
+    /**
+     * Adds a Write Record command.
+     *
+     * @param sfi The SFI of the file.
+     * @param recordNumber The record number.
+     * @param recordData The data to OR with the record content.
+     * @return The current instance.
+     * @throw IllegalArgumentException If the command alone does not fit in the buffer.
+     */
+    ModificationsBufferPlanner& addWriteRecord(const uint8_t sfi,
+                                               const uint8_t recordNumber,
+                                               const std::vector<uint8_t>& recordData);
+
+    /**
+     * Adds an Increase command.
+     *
+     * @param sfi The SFI of the counters file.
+     * @param counterNumber The counter number.
+     * @param incValue The value to add to the counter.
+     * @return The current instance.
+     */
+    ModificationsBufferPlanner& addIncreaseCounter(const uint8_t sfi,
+                                                   const uint8_t counterNumber,
+                                                   const int incValue);
+
+    /**
+     * Adds a Decrease command.
+     *
+     * @param sfi The SFI of the counters file.
+     * @param counterNumber The counter number.
+     * @param decValue The value to subtract from the counter.
+     * @return The current instance.
+     */
+    ModificationsBufferPlanner& addDecreaseCounter(const uint8_t sfi,
+                                                   const uint8_t counterNumber,
+                                                   const int decValue);
+
+    /**
+     * @return The number of commands added.
+     */
+    size_t getCommandCount() const;
+
+    /**
+     * @return The minimum number of sessions needed by the commands added.
+     */
+    size_t getSessionCount() const;
+
+    /**
+     * Executes the commands added, each planned session being opened, filled and closed.
+     *
+     * @param cardTransaction The card transaction manager, the multiple session mode being
+     *        unnecessary.
+     * @param writeAccessLevel The write access level of the sessions.
+     * @throw Exception The first error raised by the card transaction manager or by a record
+     *        supplier.
+     * @throw IllegalStateException If a record supplier produces a content of an unexpected size.
+     */
+    void execute(std::shared_ptr<CardTransactionManager> cardTransaction,
+                 const WriteAccessLevel writeAccessLevel);
+
+    /**
+     * @return The duration of each session of the last execution, in microseconds.
+     */
+    const std::vector<uint64_t>& getSessionDurationsUs() const;
+
+    /**
+     * Logs the plan and the duration of the sessions of the last execution.
+     */
+    void logStatistics() const;
+
+private:
+    /**
+     * Modification command planned.
+     */
+    struct PlannedCommand {
+        enum class Type {APPEND_RECORD, UPDATE_RECORD, WRITE_RECORD, INCREASE, DECREASE};
+        Type type;
+        uint8_t sfi;
+        uint8_t number;
+        std::vector<uint8_t> data;
+        int value;
+        std::shared_ptr<RecordSupplier> recordSupplier;
+        int apduBodyLength;
+    };
+
+    /**
+     * Record contents of a session produced at execution, by command index.
+     */
+    typedef std::vector<std::vector<uint8_t>> SessionRecords;
+
+    /**
+     * Adds a command to the plan, starting a new session if it does not fit in the current one.
+     */
+    void addCommand(const PlannedCommand& command, const int dataLength);
+
+    /**
+     * Returns the buffer consumption of a command according to the length of its APDU without the
+     * header.
+     */
+    int getBufferConsumption(const int apduBodyLength) const;
+
+    /**
+     * Returns the index of the first command following a session.
+     */
+    size_t getSessionEnd(const size_t session) const;
+
+    /**
+     * Produces the record contents of the commands of a session having a record supplier.
+     */
+    SessionRecords produceSessionRecords(const size_t session) const;
+
+    /**
+     * Executes the sessions, the records being produced by a helper thread one session ahead.
+     */
+    void executePipelined(std::shared_ptr<CardTransactionManager> cardTransaction,
+                          const WriteAccessLevel writeAccessLevel);
+
+    /**
+     * Exchanges a session with the card, the supplied records being provided.
+     */
+    void executeSession(std::shared_ptr<CardTransactionManager> cardTransaction,
+                        const WriteAccessLevel writeAccessLevel,
+                        const size_t session,
+                        const SessionRecords& sessionRecords);
+
+    /**
+     * Prepares a planned command.
+     */
+    static void prepare(std::shared_ptr<CardTransactionManager> cardTransaction,
+                        const PlannedCommand& command,
+                        const std::vector<uint8_t>& data);
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger =
+        LoggerFactory::getLogger(typeid(ModificationsBufferPlanner));
+
+    /**
+     *
+     */
+    const int mBufferCapacity;
+
+    /**
+     *
+     */
+    const bool mIsBufferCapacityInBytes;
+
+    /**
+     *
+     */
+    bool mIsPipelined;
+
+    /**
+     *
+     */
+    std::vector<PlannedCommand> mCommands;
+
+    /**
+     * Index of the first command of each session.
+     */
+    std::vector<size_t> mSessionStarts;
+
+    /**
+     * Buffer consumption of the last session.
+     */
+    int mLastSessionConsumption;
+
+    /**
+     *
+     */
+    std::vector<uint64_t> mSessionDurationsUs;
+};
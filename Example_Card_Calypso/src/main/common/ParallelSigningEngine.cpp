@@ -0,0 +1,233 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "ParallelSigningEngine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+/* Calypsonet Terminal Calypso */
+#include "CalypsoSam.h"
+
+/* Keyple Core Util */
+#include "Exception.h"
+#include "IllegalStateException.h"
+
+using namespace calypsonet::terminal::calypso::sam;
+using namespace keyple::core::util::cpp::exception;
+
+ParallelSigningEngine::ParallelSigningEngine(
+  std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+  const std::string& samProfileName,
+  std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+  const uint8_t kif,
+  const uint8_t kvc,
+  const int batchSize)
+: mCardResourceAllocator(cardResourceAllocator),
+  mBatchSize(batchSize),
+  mSignatureCount(0),
+  mStolenBatchCount(0),
+  mProcessingTimeNs(0)
+{
+    /* Lease every SAM resource of the profile available now */
+    try {
+        while (true) {
+            std::shared_ptr<CardResource> samResource =
+                cardResourceAllocator->getCardResource(samProfileName, 0);
+            if (samResource == nullptr) {
+                break;
+            }
+
+            /* Kept first, to be released if the creation of its signer fails */
+            std::unique_ptr<Worker> worker(new Worker());
+            worker->samResource = samResource;
+            mWorkers.push_back(std::move(worker));
+
+            mWorkers.back()->batchSigner =
+                std::make_shared<BatchSigner>(
+                    samResource->getReader(),
+                    std::dynamic_pointer_cast<CalypsoSam>(samResource->getSmartCard()),
+                    samSecuritySetting,
+                    kif,
+                    kvc,
+                    batchSize);
+        }
+
+    } catch (...) {
+        releaseSamResources();
+        throw;
+    }
+
+    if (mWorkers.empty()) {
+        throw IllegalStateException("No SAM resource available for profile '" +
+                                    samProfileName +
+                                    "'");
+    }
+
+    mLogger->info("% SAM resources of profile '%' leased for signing\n",
+                  mWorkers.size(),
+                  samProfileName);
+}
+
+ParallelSigningEngine::~ParallelSigningEngine()
+{
+    releaseSamResources();
+}
+
+void ParallelSigningEngine::releaseSamResources()
+{
+    for (const auto& worker : mWorkers) {
+        try {
+            mCardResourceAllocator->releaseCardResource(worker->samResource);
+
+        } catch (const Exception& e) {
+            mLogger->error("Unable to release the SAM resource of reader '%'\n",
+                           worker->samResource->getReader()->getName(),
+                           e);
+        }
+    }
+}
+
+size_t ParallelSigningEngine::getSamCount() const
+{
+    return mWorkers.size();
+}
+
+bool ParallelSigningEngine::takeBatch(const size_t workerIndex, size_t& batchIndex, bool& isStolen)
+{
+    {
+        Worker& worker = *mWorkers[workerIndex];
+        const std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.batchIndexes.empty()) {
+            batchIndex = worker.batchIndexes.front();
+            worker.batchIndexes.pop_front();
+            isStolen = false;
+            return true;
+        }
+    }
+
+    /* Steal from the back, the end of the queue its owner would reach last */
+    for (size_t i = 1; i < mWorkers.size(); i++) {
+        Worker& victim = *mWorkers[(workerIndex + i) % mWorkers.size()];
+        const std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.batchIndexes.empty()) {
+            batchIndex = victim.batchIndexes.back();
+            victim.batchIndexes.pop_back();
+            isStolen = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<std::vector<uint8_t>> ParallelSigningEngine::sign(
+    const std::vector<std::vector<uint8_t>>& payloads)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<uint8_t>> signatures(payloads.size());
+    const size_t batchCount = (payloads.size() + mBatchSize - 1) / mBatchSize;
+
+    /* Deal the batches round-robin, the workers not being started yet */
+    for (size_t i = 0; i < batchCount; i++) {
+        mWorkers[i % mWorkers.size()]->batchIndexes.push_back(i);
+    }
+
+    std::atomic<bool> isFailed(false);
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+    std::vector<uint64_t> stolenBatchCounts(mWorkers.size(), 0);
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < mWorkers.size(); w++) {
+        threads.emplace_back([&, w]() {
+            try {
+                size_t batchIndex;
+                bool isStolen;
+                while (!isFailed && takeBatch(w, batchIndex, isStolen)) {
+                    const size_t begin = batchIndex * mBatchSize;
+                    const size_t end = std::min(payloads.size(), begin + mBatchSize);
+
+                    /* Each position is written by a single worker, without intermediate copy */
+                    mWorkers[w]->batchSigner->sign(payloads, begin, end, signatures);
+
+                    if (isStolen) {
+                        stolenBatchCounts[w]++;
+                    }
+                }
+
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+                isFailed = true;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    /* Drop the batches left by a failure */
+    for (auto& worker : mWorkers) {
+        worker->batchIndexes.clear();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+
+    for (const uint64_t stolenBatchCount : stolenBatchCounts) {
+        mStolenBatchCount += stolenBatchCount;
+    }
+    mSignatureCount += payloads.size();
+    mProcessingTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start).count();
+
+    return signatures;
+}
+
+uint64_t ParallelSigningEngine::getStolenBatchCount() const
+{
+    return mStolenBatchCount;
+}
+
+double ParallelSigningEngine::getSignaturesPerSecond() const
+{
+    if (mProcessingTimeNs == 0) {
+        return 0;
+    }
+
+    return mSignatureCount * 1e9 / mProcessingTimeNs;
+}
+
+void ParallelSigningEngine::logStatistics() const
+{
+    mLogger->info("Parallel signing: % signatures with % SAMs, % batches stolen, % signatures/s\n",
+                  mSignatureCount,
+                  mWorkers.size(),
+                  mStolenBatchCount,
+                  static_cast<uint64_t>(getSignaturesPerSecond()));
+
+    for (const auto& worker : mWorkers) {
+        mLogger->info("SAM reader %: % signatures in % exchanges\n",
+                      worker->samResource->getReader()->getName(),
+                      worker->batchSigner->getSignatureCount(),
+                      worker->batchSigner->getExchangeCount());
+    }
+}
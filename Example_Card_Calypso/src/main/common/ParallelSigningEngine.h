@@ -0,0 +1,167 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+
+/* Examples */
+#include "BatchSigner.h"
+#include "CardResourceAllocator.h"
+
+using namespace calypsonet::terminal::calypso::transaction;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Basic signature generation spread over all the SAMs of a card resource profile.
+ *
+ * <p>The engine leases every SAM resource of the profile available at its creation and keeps them
+ * until its destruction. A signing request is split into batches (see BatchSigner), dealt
+ * round-robin to one queue per SAM. Each SAM has its own worker thread, taking the batches from
+ * the front of its queue and, when its queue is empty, stealing batches from the back of the
+ * queue of another SAM, so that a slower SAM does not delay the end of the request.
+ *
+ * <p>Each signature is stored at the position of its payload, the output order being thus the
+ * input order whatever the SAM which computed it.
+ */
+class ParallelSigningEngine final {
+public:
+    /**
+     * Constructor.
+     *
+     * @param cardResourceAllocator The allocator of the card resources, through which the SAM
+     *        resources are allocated and released.
+     * @param samProfileName The card resource profile of the SAMs.
+     * @param samSecuritySetting The SAM security settings.
+     * @param kif The KIF of the signing key.
+     * @param kvc The KVC of the signing key.
+     * @param batchSize The maximum number of signatures computed per processCommands.
+     * @throw IllegalStateException If no SAM resource is available.
+     */
+    ParallelSigningEngine(std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                          const std::string& samProfileName,
+                          std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+                          const uint8_t kif,
+                          const uint8_t kvc,
+                          const int batchSize = BatchSigner::DEFAULT_BATCH_SIZE);
+
+    /**
+     * Releases the SAM resources through the allocator.
+     */
+    ~ParallelSigningEngine();
+
+    /**
+     * @return The number of SAMs leased.
+     */
+    size_t getSamCount() const;
+
+    /**
+     * Signs payloads with all the SAMs in parallel.
+     *
+     * @param payloads The payloads to sign.
+     * @return The signatures, in the order of the payloads.
+     * @throw Exception The first error raised by a worker, the other workers stopping after their
+     *        current batch.
+     */
+    std::vector<std::vector<uint8_t>> sign(const std::vector<std::vector<uint8_t>>& payloads);
+
+    /**
+     * @return The number of batches processed by a SAM other than the one they were dealt to.
+     */
+    uint64_t getStolenBatchCount() const;
+
+    /**
+     * @return The signatures computed per second of signing request, 0 if none.
+     */
+    double getSignaturesPerSecond() const;
+
+    /**
+     * Logs the statistics, globally and per SAM.
+     */
+    void logStatistics() const;
+
+private:
+    /**
+     * SAM leased with its signer and its queue of batches.
+     */
+    struct Worker {
+        std::shared_ptr<CardResource> samResource;
+        std::shared_ptr<BatchSigner> batchSigner;
+        std::deque<size_t> batchIndexes;
+        std::mutex mutex;
+    };
+
+    /**
+     * Takes the next batch of a worker, from its own queue first, then from the other queues.
+     *
+     * @param workerIndex The worker.
+     * @param batchIndex The batch taken.
+     * @param isStolen Set to true if the batch has been taken from another queue.
+     * @return False if all the queues are empty.
+     */
+    bool takeBatch(const size_t workerIndex, size_t& batchIndex, bool& isStolen);
+
+    /**
+     * Releases the SAM resources of the workers through the allocator, logging the failures.
+     */
+    void releaseSamResources();
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(ParallelSigningEngine));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardResourceAllocator> mCardResourceAllocator;
+
+    /**
+     *
+     */
+    const int mBatchSize;
+
+    /**
+     *
+     */
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    /**
+     *
+     */
+    uint64_t mSignatureCount;
+
+    /**
+     *
+     */
+    uint64_t mStolenBatchCount;
+
+    /**
+     * Cumulated duration of the signing requests, in nanoseconds.
+     */
+    uint64_t mProcessingTimeNs;
+};
@@ -0,0 +1,172 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "SamAccessScheduler.h"
+
+#include <algorithm>
+
+/* Keyple Core Util */
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+/* ACCESS --------------------------------------------------------------------------------------- */
+
+SamAccessScheduler::Access::Access(SamAccessScheduler& scheduler, const Priority priority)
+: mScheduler(scheduler), mPriority(priority), mWaitingTime(mScheduler.acquire(mPriority)) {}
+
+SamAccessScheduler::Access::~Access()
+{
+    mScheduler.release();
+}
+
+void SamAccessScheduler::Access::yield()
+{
+    if (mPriority == Priority::LOW && mScheduler.isHighPriorityAccessWaiting()) {
+        mScheduler.release();
+        mWaitingTime += mScheduler.acquire(mPriority);
+    }
+}
+
+std::chrono::microseconds SamAccessScheduler::Access::getWaitingTime() const
+{
+    return mWaitingTime;
+}
+
+/* SCHEDULED SAM READER ------------------------------------------------------------------------- */
+
+SamAccessScheduler::ScheduledSamReader::ScheduledSamReader(SamAccessScheduler& scheduler,
+                                                           std::shared_ptr<CardReader> samReader)
+: mScheduler(scheduler), mSamReader(samReader) {}
+
+const std::string& SamAccessScheduler::ScheduledSamReader::getName() const
+{
+    return mSamReader->getName();
+}
+
+bool SamAccessScheduler::ScheduledSamReader::isContactless()
+{
+    return mSamReader->isContactless();
+}
+
+bool SamAccessScheduler::ScheduledSamReader::isCardPresent()
+{
+    return mSamReader->isCardPresent();
+}
+
+const std::shared_ptr<CardResponseApi> SamAccessScheduler::ScheduledSamReader::transmitCardRequest(
+    const std::shared_ptr<CardRequestSpi> cardRequest, const ChannelControl channelControl)
+{
+    if (!mScheduler.isHeldByCurrentThread()) {
+        throw IllegalStateException("The shared SAM is used without a scheduled access.");
+    }
+
+    return std::dynamic_pointer_cast<ProxyReaderApi>(mSamReader)
+               ->transmitCardRequest(cardRequest, channelControl);
+}
+
+void SamAccessScheduler::ScheduledSamReader::releaseChannel()
+{
+    std::dynamic_pointer_cast<ProxyReaderApi>(mSamReader)->releaseChannel();
+}
+
+/* SAM ACCESS SCHEDULER ------------------------------------------------------------------------- */
+
+SamAccessScheduler::SamAccessScheduler(std::shared_ptr<CardReader> samReader,
+                                       const std::chrono::milliseconds highPriorityLatencyBudget)
+: mHighPriorityLatencyBudget(highPriorityLatencyBudget),
+  mNextTicket(0),
+  mIsSamBusy(false),
+  mBudgetOverrunCount(0)
+{
+    mScheduledSamReader = std::make_shared<ScheduledSamReader>(*this, samReader);
+}
+
+std::shared_ptr<CardReader> SamAccessScheduler::getSamReader() const
+{
+    return mScheduledSamReader;
+}
+
+std::chrono::microseconds SamAccessScheduler::acquire(const Priority priority)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    std::deque<uint64_t>& queue =
+        priority == Priority::HIGH ? mHighPriorityQueue : mLowPriorityQueue;
+    const uint64_t ticket = mNextTicket++;
+    queue.push_back(ticket);
+
+    /* The SAM goes to the oldest access of the highest priority level */
+    auto isGranted = [&]() {
+        if (mIsSamBusy || queue.front() != ticket) {
+            return false;
+        }
+        return priority == Priority::HIGH || mHighPriorityQueue.empty();
+    };
+
+    if (priority == Priority::HIGH) {
+        if (!mCondition.wait_until(lock, start + mHighPriorityLatencyBudget, isGranted)) {
+            /* Given up: the next access in the queue may now be granted */
+            queue.erase(std::find(queue.begin(), queue.end(), ticket));
+            mBudgetOverrunCount++;
+            lock.unlock();
+            mCondition.notify_all();
+
+            mLogger->warn("SAM not granted within the latency budget of % ms\n",
+                          mHighPriorityLatencyBudget.count());
+
+            throw IllegalStateException("SAM not granted within the latency budget.");
+        }
+    } else {
+        mCondition.wait(lock, isGranted);
+    }
+
+    queue.pop_front();
+    mIsSamBusy = true;
+    mHolder = std::this_thread::get_id();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start);
+}
+
+void SamAccessScheduler::release()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        mIsSamBusy = false;
+    }
+
+    mCondition.notify_all();
+}
+
+bool SamAccessScheduler::isHighPriorityAccessWaiting()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return !mHighPriorityQueue.empty();
+}
+
+bool SamAccessScheduler::isHeldByCurrentThread()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mIsSamBusy && mHolder == std::this_thread::get_id();
+}
+
+uint64_t SamAccessScheduler::getBudgetOverrunCount()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mBudgetOverrunCount;
+}
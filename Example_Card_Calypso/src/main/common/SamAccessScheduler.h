@@ -0,0 +1,267 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/* Calypsonet Terminal Card */
+#include "ProxyReaderApi.h"
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::card;
+using namespace calypsonet::terminal::card::spi;
+using namespace calypsonet::terminal::reader;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Schedules the accesses of several card readers to a single SAM shared through
+ * CardSecuritySetting::setControlSamResource.
+ *
+ * <p>The reader provided by getSamReader must be given to setControlSamResource in place of the
+ * SAM reader: it forwards the exchanges of the card transactions to the SAM only from the thread
+ * holding an Access, so that no transaction can use the SAM without being scheduled. An Access
+ * covers whole secure sessions, the SAM keeping the digest of the current session.
+ *
+ * <p>The SAM is granted to the waiting HIGH priority accesses first, then to the LOW priority
+ * ones, in arrival order within a priority level. A LOW priority holder running several sessions
+ * calls Access::yield between two of them: the SAM is then handed over to the HIGH priority
+ * accesses waiting at that time.
+ *
+ * <p>The latency budget is a reject after budget policy, not a guaranteed grant time: a HIGH
+ * priority access still not granted once the budget has elapsed is given up, its constructor
+ * throwing an exception, so that the reader can reject the card instead of keeping the passenger
+ * waiting longer. The SAM may still be busy with a session for the whole budget.
+ */
+class SamAccessScheduler final {
+public:
+    /**
+     * Access priority.
+     */
+    enum class Priority {
+        LOW,
+        HIGH
+    };
+
+    /**
+     * Exclusive access to the SAM, granted on construction (blocking) and released on
+     * destruction.
+     */
+    class Access final {
+    public:
+        /**
+         * Constructor: waits for the SAM to be granted.
+         *
+         * @param scheduler The scheduler of the SAM.
+         * @param priority The access priority.
+         * @throw IllegalStateException If a HIGH priority access is still not granted once the
+         *        latency budget has elapsed.
+         */
+        Access(SamAccessScheduler& scheduler, const Priority priority);
+
+        /**
+         * Releases the SAM.
+         */
+        ~Access();
+
+        /**
+         * Hands the SAM over to the waiting accesses of higher priority, if any, and waits for it
+         * to be granted again.
+         *
+         * <p>To be called by LOW priority holders between two secure sessions.
+         */
+        void yield();
+
+        /**
+         * @return The total time waited for the SAM by this access.
+         */
+        std::chrono::microseconds getWaitingTime() const;
+
+    private:
+        /**
+         *
+         */
+        SamAccessScheduler& mScheduler;
+
+        /**
+         *
+         */
+        const Priority mPriority;
+
+        /**
+         *
+         */
+        std::chrono::microseconds mWaitingTime;
+
+        Access(const Access&) = delete;
+        Access& operator=(const Access&) = delete;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param samReader The reader of the shared SAM.
+     * @param highPriorityLatencyBudget The waiting time after which a HIGH priority access not
+     *        granted yet is rejected.
+     */
+    SamAccessScheduler(std::shared_ptr<CardReader> samReader,
+                       const std::chrono::milliseconds highPriorityLatencyBudget);
+
+    /**
+     * @return The reader to provide to CardSecuritySetting::setControlSamResource.
+     */
+    std::shared_ptr<CardReader> getSamReader() const;
+
+    /**
+     * Waits for the SAM to be granted to the current thread.
+     *
+     * @param priority The access priority.
+     * @return The time waited.
+     * @throw IllegalStateException If a HIGH priority access is still not granted once the
+     *        latency budget has elapsed.
+     */
+    std::chrono::microseconds acquire(const Priority priority);
+
+    /**
+     * Releases the SAM previously granted by acquire.
+     */
+    void release();
+
+    /**
+     * @return True if a HIGH priority access is waiting for the SAM.
+     */
+    bool isHighPriorityAccessWaiting();
+
+    /**
+     * @return The number of HIGH priority accesses given up because of the latency budget.
+     */
+    uint64_t getBudgetOverrunCount();
+
+private:
+    /**
+     * SAM reader forwarding the exchanges of the thread holding the SAM only.
+     */
+    class ScheduledSamReader final : public CardReader, public ProxyReaderApi {
+    public:
+        /**
+         *
+         */
+        ScheduledSamReader(SamAccessScheduler& scheduler, std::shared_ptr<CardReader> samReader);
+
+        /**
+         * {@inheritDoc}
+         */
+        const std::string& getName() const override;
+
+        /**
+         * {@inheritDoc}
+         */
+        bool isContactless() override;
+
+        /**
+         * {@inheritDoc}
+         */
+        bool isCardPresent() override;
+
+        /**
+         * {@inheritDoc}
+         *
+         * @throw IllegalStateException If the current thread does not hold the SAM.
+         */
+        const std::shared_ptr<CardResponseApi> transmitCardRequest(
+            const std::shared_ptr<CardRequestSpi> cardRequest,
+            const ChannelControl channelControl) override;
+
+        /**
+         * {@inheritDoc}
+         */
+        void releaseChannel() override;
+
+    private:
+        /**
+         *
+         */
+        SamAccessScheduler& mScheduler;
+
+        /**
+         *
+         */
+        const std::shared_ptr<CardReader> mSamReader;
+    };
+
+    /**
+     * @return True if the SAM is granted to the current thread.
+     */
+    bool isHeldByCurrentThread();
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(SamAccessScheduler));
+
+    /**
+     *
+     */
+    const std::chrono::milliseconds mHighPriorityLatencyBudget;
+
+    /**
+     *
+     */
+    std::shared_ptr<ScheduledSamReader> mScheduledSamReader;
+
+    /**
+     * Tickets of the waiting accesses, per priority, in arrival order.
+     */
+    std::deque<uint64_t> mHighPriorityQueue;
+    std::deque<uint64_t> mLowPriorityQueue;
+
+    /**
+     *
+     */
+    uint64_t mNextTicket;
+
+    /**
+     *
+     */
+    bool mIsSamBusy;
+
+    /**
+     * Thread holding the SAM, valid if mIsSamBusy is true.
+     */
+    std::thread::id mHolder;
+
+    /**
+     *
+     */
+    uint64_t mBudgetOverrunCount;
+
+    /**
+     *
+     */
+    std::mutex mMutex;
+
+    /**
+     *
+     */
+    std::condition_variable mCondition;
+};
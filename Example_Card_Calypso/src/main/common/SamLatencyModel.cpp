@@ -0,0 +1,39 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "SamLatencyModel.h"
+
+#include <chrono>
+#include <thread>
+
+const long SamLatencyModel::DEFAULT_EXCHANGE_LATENCY_US = 1000;
+const long SamLatencyModel::DEFAULT_COMMAND_LATENCY_US = 4000;
+const long SamLatencyModel::DEFAULT_BYTE_LATENCY_NS = 90000;
+
+SamLatencyModel::SamLatencyModel(const long exchangeLatencyUs,
+                                 const long commandLatencyUs,
+                                 const long byteLatencyNs)
+: mExchangeLatencyUs(exchangeLatencyUs),
+  mCommandLatencyUs(commandLatencyUs),
+  mByteLatencyNs(byteLatencyNs) {}
+
+long SamLatencyModel::getLatencyUs(const size_t commandCount, const size_t byteCount) const
+{
+    return mExchangeLatencyUs +
+           mCommandLatencyUs * static_cast<long>(commandCount) +
+           mByteLatencyNs * static_cast<long>(byteCount) / 1000;
+}
+
+void SamLatencyModel::simulate(const size_t commandCount, const size_t byteCount) const
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(getLatencyUs(commandCount, byteCount)));
+}
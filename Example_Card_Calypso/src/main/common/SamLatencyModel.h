@@ -0,0 +1,85 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Processing time of a physical SAM, simulated for the stub SAMs which answer instantly.
+ *
+ * <p>The time of an exchange is modeled as a fixed cost (reader and transmission protocol
+ * overhead), plus a cost per command (e.g. the cryptographic computation of a signature), plus a
+ * cost per byte transmitted.
+ *
+ * <p>The default values are in the order of magnitude of a Calypso SAM C1 in a PC/SC contact
+ * reader at 115200 bauds.
+ */
+class SamLatencyModel final {
+public:
+    /**
+     *
+     */
+    static const long DEFAULT_EXCHANGE_LATENCY_US;
+
+    /**
+     *
+     */
+    static const long DEFAULT_COMMAND_LATENCY_US;
+
+    /**
+     *
+     */
+    static const long DEFAULT_BYTE_LATENCY_NS;
+
+    /**
+     * Constructor.
+     *
+     * @param exchangeLatencyUs The fixed cost of an exchange, in microseconds.
+     * @param commandLatencyUs The cost of a command, in microseconds.
+     * @param byteLatencyNs The cost of a byte transmitted, in nanoseconds.
+     */
+    SamLatencyModel(const long exchangeLatencyUs = DEFAULT_EXCHANGE_LATENCY_US,
+                    const long commandLatencyUs = DEFAULT_COMMAND_LATENCY_US,
+                    const long byteLatencyNs = DEFAULT_BYTE_LATENCY_NS);
+
+    /**
+     * @param commandCount The number of commands of the exchange.
+     * @param byteCount The number of bytes transmitted, commands and responses.
+     * @return The modeled time of an exchange, in microseconds.
+     */
+    long getLatencyUs(const size_t commandCount, const size_t byteCount) const;
+
+    /**
+     * Waits for the modeled time of an exchange.
+     *
+     * @param commandCount The number of commands of the exchange.
+     * @param byteCount The number of bytes transmitted, commands and responses.
+     */
+    void simulate(const size_t commandCount, const size_t byteCount) const;
+
+private:
+    /**
+     *
+     */
+    const long mExchangeLatencyUs;
+
+    /**
+     *
+     */
+    const long mCommandLatencyUs;
+
+    /**
+     *
+     */
+    const long mByteLatencyNs;
+};
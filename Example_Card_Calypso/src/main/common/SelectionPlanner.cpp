@@ -0,0 +1,383 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "SelectionPlanner.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "IllegalArgumentException.h"
+#include "IllegalStateException.h"
+
+/* Keyple Core Service */
+#include "SmartCardServiceProvider.h"
+
+using namespace keyple::card::calypso;
+using namespace keyple::core::service;
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp::exception;
+
+const int SelectionPlanner::DEFAULT_REPLAN_INTERVAL = 32;
+const double SelectionPlanner::DEFAULT_DECAY = 0.99;
+
+SelectionPlanner::SelectionPlanner(const int replanInterval,
+                                   const double decay,
+                                   const bool isPrefixMergingEnabled)
+: mReplanInterval(replanInterval),
+  mDecay(decay),
+  mIsPrefixMergingEnabled(isPrefixMergingEnabled),
+  mFrequencyScale(0),
+  mTapsSinceReplan(0),
+  mTapCount(0),
+  mNoMatchCount(0),
+  mReorderCount(0)
+{
+    if (replanInterval < 0) {
+        throw IllegalArgumentException("The replan interval must be positive");
+    }
+
+    if (decay <= 0 || decay >= 1) {
+        throw IllegalArgumentException("The decay must be between 0 and 1 excluded");
+    }
+}
+
+void SelectionPlanner::addApplication(const std::string& name,
+                                      const std::string& cardProtocol,
+                                      const std::string& aid,
+                                      const double frequency)
+{
+    for (const auto& application : mApplications) {
+        if (application.name == name) {
+            throw IllegalArgumentException("Application already added: " + name);
+        }
+    }
+
+    if (cardProtocol.empty()) {
+        throw IllegalArgumentException("The card protocol of the application must be provided");
+    }
+
+    if (frequency < 0) {
+        throw IllegalArgumentException("The frequency must be positive");
+    }
+
+    /* The frequencies are scaled by the first ordering, the later ones with the same factor */
+    Application application;
+    application.name = name;
+    application.cardProtocol = cardProtocol;
+    application.aid = aid;
+    application.weight = mFrequencyScale == 0 ? frequency : frequency * mFrequencyScale;
+    application.hitCount = 0;
+    mApplications.push_back(application);
+
+    mCardSelectionManager = nullptr;
+}
+
+bool SelectionPlanner::isMatching(const SelectionCase& selectionCase,
+                                  const Application& application)
+{
+    return selectionCase.cardProtocol == application.cardProtocol &&
+           (selectionCase.aid.empty() ||
+            (!application.aid.empty() &&
+             application.aid.compare(0, selectionCase.aid.size(), selectionCase.aid) == 0));
+}
+
+void SelectionPlanner::plan()
+{
+    if (mFrequencyScale == 0) {
+        double frequencySum = 0;
+        for (const auto& application : mApplications) {
+            frequencySum += application.weight;
+        }
+
+        /* The initial frequencies weigh as much as the taps of the decay window */
+        mFrequencyScale = frequencySum > 0 ? 1 / ((1 - mDecay) * frequencySum) : 1;
+        for (auto& application : mApplications) {
+            application.weight *= mFrequencyScale;
+        }
+    }
+
+    std::vector<SelectionCase> protocolCases;
+    std::vector<SelectionCase> aidCases;
+    for (size_t i = 0; i < mApplications.size(); i++) {
+        const Application& application = mApplications[i];
+
+        if (application.aid.empty()) {
+            protocolCases.push_back({application.cardProtocol, "", {i}});
+            continue;
+        }
+
+        if (mIsPrefixMergingEnabled) {
+            bool isPrefixed = false;
+            for (size_t j = 0; j < mApplications.size() && !isPrefixed; j++) {
+                const Application& other = mApplications[j];
+                isPrefixed = j != i &&
+                             !other.aid.empty() &&
+                             other.cardProtocol == application.cardProtocol &&
+                             application.aid.compare(0, other.aid.size(), other.aid) == 0 &&
+                             (other.aid.size() < application.aid.size() || j < i);
+            }
+            if (isPrefixed) {
+                continue;
+            }
+        }
+
+        aidCases.push_back({application.cardProtocol, application.aid, {i}});
+    }
+
+    for (auto& selectionCase : aidCases) {
+        for (size_t i = 0; i < mApplications.size(); i++) {
+            if (i != selectionCase.applicationIndexes.front() &&
+                isMatching(selectionCase, mApplications[i])) {
+                selectionCase.applicationIndexes.push_back(i);
+            }
+        }
+    }
+
+    std::vector<SelectionCase> selectionCases;
+
+    /* The cases without AID cost no APDU, unless they would hide the AID cases */
+    for (const auto& protocolCase : protocolCases) {
+        bool isSharingProtocol = false;
+        for (const auto& aidCase : aidCases) {
+            isSharingProtocol |= aidCase.cardProtocol == protocolCase.cardProtocol;
+        }
+        if (!isSharingProtocol) {
+            selectionCases.push_back(protocolCase);
+        }
+    }
+
+    /*
+     * Each time, the case matching first the greatest weight of the remaining applications, a case
+     * prefixing the AID of another one coming after it, not to hide it
+     */
+    std::vector<double> remainingWeights;
+    for (const auto& application : mApplications) {
+        remainingWeights.push_back(application.weight);
+    }
+    std::vector<bool> isOrdered(aidCases.size(), false);
+    for (size_t n = 0; n < aidCases.size(); n++) {
+        size_t bestCase = 0;
+        double bestWeight = -1;
+        for (size_t c = 0; c < aidCases.size(); c++) {
+            if (isOrdered[c]) {
+                continue;
+            }
+            bool isHiding = false;
+            for (size_t d = 0; d < aidCases.size() && !isHiding; d++) {
+                isHiding = !isOrdered[d] &&
+                           aidCases[d].cardProtocol == aidCases[c].cardProtocol &&
+                           aidCases[d].aid.size() > aidCases[c].aid.size() &&
+                           aidCases[d].aid.compare(0, aidCases[c].aid.size(), aidCases[c].aid) == 0;
+            }
+            if (isHiding) {
+                continue;
+            }
+            double weight = 0;
+            for (const size_t i : aidCases[c].applicationIndexes) {
+                weight += remainingWeights[i];
+            }
+            if (weight > bestWeight) {
+                bestCase = c;
+                bestWeight = weight;
+            }
+        }
+
+        isOrdered[bestCase] = true;
+        for (const size_t i : aidCases[bestCase].applicationIndexes) {
+            remainingWeights[i] = 0;
+        }
+        selectionCases.push_back(aidCases[bestCase]);
+    }
+
+    for (const auto& protocolCase : protocolCases) {
+        bool isSharingProtocol = false;
+        for (const auto& aidCase : aidCases) {
+            isSharingProtocol |= aidCase.cardProtocol == protocolCase.cardProtocol;
+        }
+        if (isSharingProtocol) {
+            selectionCases.push_back(protocolCase);
+        }
+    }
+
+    bool isOrderChanged = selectionCases.size() != mSelectionCases.size();
+    for (size_t c = 0; c < selectionCases.size() && !isOrderChanged; c++) {
+        isOrderChanged = selectionCases[c].applicationIndexes.front() !=
+                         mSelectionCases[c].applicationIndexes.front();
+    }
+
+    if (isOrderChanged && !mSelectionCases.empty() && mCardSelectionManager != nullptr) {
+        mReorderCount++;
+    }
+
+    if (!isOrderChanged && mCardSelectionManager != nullptr) {
+        return;
+    }
+
+    mSelectionCases = selectionCases;
+
+    mCardSelectionManager = SmartCardServiceProvider::getService()->createCardSelectionManager();
+    for (const auto& selectionCase : mSelectionCases) {
+        std::shared_ptr<CalypsoCardSelection> cardSelection =
+            CalypsoExtensionService::getInstance()->createCardSelection();
+        cardSelection->acceptInvalidatedCard()
+                      .filterByCardProtocol(selectionCase.cardProtocol);
+        if (!selectionCase.aid.empty()) {
+            cardSelection->filterByDfName(selectionCase.aid);
+        }
+        mCardSelectionManager->prepareSelection(cardSelection);
+    }
+}
+
+int SelectionPlanner::getCaseApduCount(const size_t caseIndex) const
+{
+    int apduCount = 0;
+
+    for (size_t c = 0; c < mSelectionCases.size() && c <= caseIndex; c++) {
+        /* The protocol of the card is known from the case matched only */
+        if (!mSelectionCases[c].aid.empty() &&
+            (caseIndex >= mSelectionCases.size() ||
+             mSelectionCases[c].cardProtocol == mSelectionCases[caseIndex].cardProtocol)) {
+            apduCount++;
+        }
+    }
+
+    return apduCount;
+}
+
+size_t SelectionPlanner::getMatchedApplication(
+    const SelectionCase& selectionCase, const std::shared_ptr<CalypsoCard> calypsoCard) const
+{
+    size_t matchedApplication = selectionCase.applicationIndexes.front();
+
+    if (selectionCase.aid.empty()) {
+        return matchedApplication;
+    }
+
+    /* The application of the longest AID prefixing the DF Name of the card */
+    const std::string dfName = HexUtil::toHex(calypsoCard->getDfName());
+    for (const size_t i : selectionCase.applicationIndexes) {
+        const std::string& aid = mApplications[i].aid;
+        if (aid.size() > mApplications[matchedApplication].aid.size() &&
+            dfName.compare(0, aid.size(), aid) == 0) {
+            matchedApplication = i;
+        }
+    }
+
+    return matchedApplication;
+}
+
+std::shared_ptr<CalypsoCard> SelectionPlanner::selectCard(std::shared_ptr<CardReader> cardReader,
+                                                          std::string& applicationName)
+{
+    if (mApplications.empty()) {
+        throw IllegalStateException("No application to select");
+    }
+
+    if (mCardSelectionManager == nullptr) {
+        plan();
+    }
+
+    const std::shared_ptr<CardSelectionResult> selectionResult =
+        mCardSelectionManager->processCardSelectionScenario(cardReader);
+
+    for (auto& application : mApplications) {
+        application.weight *= mDecay;
+    }
+    mTapCount++;
+
+    applicationName.clear();
+
+    std::shared_ptr<CalypsoCard> calypsoCard =
+        std::dynamic_pointer_cast<CalypsoCard>(selectionResult->getActiveSmartCard());
+    if (calypsoCard == nullptr) {
+        mNoMatchCount++;
+
+    } else {
+        const size_t caseIndex = static_cast<size_t>(selectionResult->getActiveSelectionIndex());
+        Application& application =
+            mApplications[getMatchedApplication(mSelectionCases[caseIndex], calypsoCard)];
+        application.weight += 1;
+        application.hitCount++;
+        applicationName = application.name;
+    }
+
+    if (mReplanInterval > 0 && ++mTapsSinceReplan >= mReplanInterval) {
+        mTapsSinceReplan = 0;
+        plan();
+    }
+
+    return calypsoCard;
+}
+
+std::vector<std::string> SelectionPlanner::getPlan() const
+{
+    std::vector<std::string> plan;
+
+    for (const auto& selectionCase : mSelectionCases) {
+        std::string names;
+        for (const size_t i : selectionCase.applicationIndexes) {
+            names += (names.empty() ? "" : "+") + mApplications[i].name;
+        }
+        plan.push_back(names);
+    }
+
+    return plan;
+}
+
+double SelectionPlanner::getExpectedApduCount() const
+{
+    double weightSum = 0;
+    double apduCount = 0;
+
+    for (const auto& application : mApplications) {
+        size_t caseIndex = 0;
+        while (caseIndex < mSelectionCases.size() &&
+               !isMatching(mSelectionCases[caseIndex], application)) {
+            caseIndex++;
+        }
+
+        weightSum += application.weight;
+        apduCount += application.weight * getCaseApduCount(caseIndex);
+    }
+
+    return weightSum > 0 ? apduCount / weightSum : 0;
+}
+
+uint64_t SelectionPlanner::getTapCount() const
+{
+    return mTapCount;
+}
+
+void SelectionPlanner::logStatistics() const
+{
+    mLogger->info("Selection planner: % taps, % without match, % APDUs per tap expected, " \
+                  "% reorders\n",
+                  mTapCount,
+                  mNoMatchCount,
+                  getExpectedApduCount(),
+                  mReorderCount);
+
+    for (const auto& application : mApplications) {
+        mLogger->info("  %: % hits, weight %\n",
+                      application.name,
+                      application.hitCount,
+                      application.weight);
+    }
+
+    std::string plan;
+    for (const auto& selectionCase : getPlan()) {
+        plan += (plan.empty() ? "" : " > ") + selectionCase;
+    }
+    mLogger->info("  Plan: %\n", plan);
+}
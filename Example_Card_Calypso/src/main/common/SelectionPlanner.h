@@ -0,0 +1,236 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Calypso */
+#include "CalypsoCard.h"
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "CardSelectionManager.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::calypso::card;
+using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::selection;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Selection scenario of a fleet mixing several Calypso applications and card protocols (e.g. the
+ * Calypso AID, an AID prefix and Innovatron rev1 cards), ordered to minimise the expected number of
+ * selection APDUs per tap.
+ *
+ * <p>The scenario stops at the first selection case matching the card. A case whose card protocol
+ * does not match costs no APDU, the protocol being known from the reader: only the AID cases of the
+ * protocol of the card are ordered, by decreasing weight of the applications they are the first to
+ * match (an AID prefix matching also the applications it prefixes), a case never coming before the
+ * cases whose AID it prefixes. The cases without AID (e.g. rev1) come first, unless AID cases share
+ * their protocol, in which case they come last.
+ *
+ * <p>If the prefix merging is enabled, the applications whose AID is prefixed by the AID of
+ * another application of the same protocol get no case of their own: a single SELECT of the prefix
+ * matches them all, the application retained being the first occurrence found by the card.
+ *
+ * <p>The application matched by each tap is identified from the DF Name of the card, and the
+ * weights of the applications follow the fleet: they are initialised with the frequencies
+ * provided, weighing as much as the taps of the decay window, and decay at each tap. The cases
+ * are ordered again every replan interval.
+ */
+class SelectionPlanner final {
+public:
+    /**
+     * Default number of taps between two orderings of the cases.
+     */
+    static const int DEFAULT_REPLAN_INTERVAL;
+
+    /**
+     * Default decay of the weights at each tap (window of about 100 taps).
+     */
+    static const double DEFAULT_DECAY;
+
+    /**
+     * Constructor.
+     *
+     * @param replanInterval The number of taps between two orderings of the cases, 0 to keep the
+     *        order given by the initial frequencies.
+     * @param decay The decay of the weights at each tap, between 0 and 1 excluded.
+     * @param isPrefixMergingEnabled True to merge the cases of the applications prefixed by another
+     *        one.
+     * @throw IllegalArgumentException If the replan interval is negative or the decay out of
+     *        range.
+     */
+    SelectionPlanner(const int replanInterval = DEFAULT_REPLAN_INTERVAL,
+                     const double decay = DEFAULT_DECAY,
+                     const bool isPrefixMergingEnabled = false);
+
+    /**
+     * Adds an accepted application.
+     *
+     * @param name The name of the application.
+     * @param cardProtocol The card protocol (e.g. ConfigurationUtil::ISO_CARD_PROTOCOL).
+     * @param aid The AID or AID prefix, empty for a selection based on the protocol only (e.g.
+     *        ConfigurationUtil::INNOVATRON_CARD_PROTOCOL).
+     * @param frequency The observed frequency of the application, relative to the others.
+     * @throw IllegalArgumentException If the name is already used, the protocol empty or the
+     *        frequency negative.
+     */
+    void addApplication(const std::string& name,
+                        const std::string& cardProtocol,
+                        const std::string& aid,
+                        const double frequency);
+
+    /**
+     * Runs the selection scenario and updates the statistics.
+     *
+     * @param cardReader The reader, in which a card is present.
+     * @param applicationName Set to the name of the application matched, empty if none.
+     * @return The selected card, null if no application matched.
+     * @throw IllegalStateException If no application was added.
+     */
+    std::shared_ptr<CalypsoCard> selectCard(std::shared_ptr<CardReader> cardReader,
+                                            std::string& applicationName);
+
+    /**
+     * @return The selection cases in the current order, the names of the applications matched by
+     *         a case being separated by '+'.
+     */
+    std::vector<std::string> getPlan() const;
+
+    /**
+     * @return The expected number of selection APDUs per tap of the current order, for the cards
+     *         of the applications accepted and the current weights.
+     */
+    double getExpectedApduCount() const;
+
+    /**
+     * @return The number of taps.
+     */
+    uint64_t getTapCount() const;
+
+    /**
+     * Logs the statistics.
+     */
+    void logStatistics() const;
+
+private:
+    /**
+     * Accepted application.
+     */
+    struct Application {
+        std::string name;
+        std::string cardProtocol;
+        std::string aid;
+        double weight;
+        uint64_t hitCount;
+    };
+
+    /**
+     * Selection case, matching one or more applications, the first one being the application for
+     * which the case was created.
+     */
+    struct SelectionCase {
+        std::string cardProtocol;
+        std::string aid;
+        std::vector<size_t> applicationIndexes;
+    };
+
+    /**
+     * @return True if a case matches the cards of an application.
+     */
+    static bool isMatching(const SelectionCase& selectionCase, const Application& application);
+
+    /**
+     * Orders the cases for the current weights and prepares the selection scenario if the order
+     * changed.
+     */
+    void plan();
+
+    /**
+     * @return The number of selection APDUs sent until the case of an index matches, or until the
+     *         end of the scenario (all the AID cases) for the index following the last case.
+     */
+    int getCaseApduCount(const size_t caseIndex) const;
+
+    /**
+     * @return The application matched by a case, identified from the DF Name of the card.
+     */
+    size_t getMatchedApplication(const SelectionCase& selectionCase,
+                                 const std::shared_ptr<CalypsoCard> calypsoCard) const;
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(SelectionPlanner));
+
+    /**
+     *
+     */
+    const int mReplanInterval;
+
+    /**
+     *
+     */
+    const double mDecay;
+
+    /**
+     *
+     */
+    const bool mIsPrefixMergingEnabled;
+
+    /**
+     *
+     */
+    std::vector<Application> mApplications;
+
+    /**
+     *
+     */
+    std::vector<SelectionCase> mSelectionCases;
+
+    /**
+     * Weight of a frequency of 1, set by the first ordering (0 before).
+     */
+    double mFrequencyScale;
+
+    /**
+     * The scenario of the current order, null if it must be prepared again.
+     */
+    std::shared_ptr<CardSelectionManager> mCardSelectionManager;
+
+    /**
+     *
+     */
+    int mTapsSinceReplan;
+
+    /**
+     *
+     */
+    uint64_t mTapCount;
+
+    /**
+     *
+     */
+    uint64_t mNoMatchCount;
+
+    /**
+     * Number of times the order changed.
+     */
+    uint64_t mReorderCount;
+};
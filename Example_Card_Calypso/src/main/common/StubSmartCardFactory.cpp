@@ -26,6 +26,9 @@ using namespace keyple::plugin::stub;
 const std::string StubSmartCardFactory::CARD_POWER_ON_DATA = "3B888001000000009171710098";
 const std::string StubSmartCardFactory::SAM_POWER_ON_DATA =
     "3B3F9600805A0080C120000012345678829000";
+const std::string StubSmartCardFactory::REV1_CARD_POWER_ON_DATA =
+    "3B8F8001805A0A010320031112345678829000F7";
+const std::string StubSmartCardFactory::SIGNATURE = "1122334455667788";
 
 std::shared_ptr<StubSmartCard> StubSmartCardFactory::mStubCard =
     StubSmartCard::builder()
@@ -79,4 +82,141 @@ std::shared_ptr<StubSmartCard> StubSmartCardFactory::getStubCard()
 std::shared_ptr<StubSmartCard> StubSmartCardFactory::getStubSam()
 {
     return mStubSam;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<StubSmartCard> StubSmartCardFactory::createStubSignatureSam()
+{
+    /* The simulated commands are regular expressions, matching any data and key */
+    return StubSmartCard::builder()
+               ->withPowerOnData(HexUtil::toByteArray(SAM_POWER_ON_DATA))
+               .withProtocol(ConfigurationUtil::SAM_PROTOCOL)
+               /* Select diversifier */
+               .withSimulatedCommand("8014.*", "9000")
+               /* PSO Compute signature */
+               .withSimulatedCommand("802A9E9A.*", SIGNATURE + "9000")
+               /* PSO Verify signature */
+               .withSimulatedCommand("802A00A8.*", "9000")
+               .build();
+}
+
+std::shared_ptr<StubSmartCard> StubSmartCardFactory::createStubSessionCard(
+    const uint8_t bufferSizeIndicator)
+{
+    /* The simulated commands are regular expressions, matching any file, record and data */
+    return StubSmartCard::builder()
+               ->withPowerOnData(HexUtil::toByteArray(CARD_POWER_ON_DATA))
+               .withProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL)
+               /* Select application, the startup information beginning with the buffer size */
+               .withSimulatedCommand(
+                   "00A4040009315449432E4943413100",
+                   "6F238409315449432E49434131A516BF0C13C70800000000AABBCCDD5307" +
+                   HexUtil::toHex(bufferSizeIndicator) +
+                   "3C23051410019000")
+               /* Open secure session, without record data */
+               .withSimulatedCommand("008A.*", "0308D181003079009000")
+               /* Append record, update record, write record */
+               .withSimulatedCommand("00E2.*", "9000")
+               .withSimulatedCommand("00DC.*", "9000")
+               .withSimulatedCommand("00D2.*", "9000")
+               /* Close secure session */
+               .withSimulatedCommand("008E.*", "876543219000")
+               /* Ratification */
+               .withSimulatedCommand("00B2.*", "9000")
+               /* Ping command (used by the card removal procedure) */
+               .withSimulatedCommand("00C0000000", "9000")
+               .build();
+}
+
+std::shared_ptr<StubSmartCard> StubSmartCardFactory::createStubSessionSam()
+{
+    /* The simulated commands are regular expressions, matching any data and key */
+    return StubSmartCard::builder()
+               ->withPowerOnData(HexUtil::toByteArray(SAM_POWER_ON_DATA))
+               .withProtocol(ConfigurationUtil::SAM_PROTOCOL)
+               /* Select diversifier */
+               .withSimulatedCommand("8014.*", "9000")
+               /* Get challenge */
+               .withSimulatedCommand("8084.*", "001122339000")
+               /* Digest init, digest update */
+               .withSimulatedCommand("808A.*", "9000")
+               .withSimulatedCommand("808C.*", "9000")
+               /* Digest close */
+               .withSimulatedCommand("808E.*", "123456789000")
+               /* Digest authenticate */
+               .withSimulatedCommand("8082.*", "9000")
+               .build();
+}
+
+std::shared_ptr<StubSmartCard> StubSmartCardFactory::createStubFleetCard(
+    const std::string& dfName, const std::vector<std::string>& aids)
+{
+    /* FCI of the application, the startup information of the default stub card */
+    const std::string fci = "6F" +
+                            HexUtil::toHex(static_cast<uint8_t>(dfName.size() / 2 + 26)) +
+                            "84" +
+                            HexUtil::toHex(static_cast<uint8_t>(dfName.size() / 2)) +
+                            dfName +
+                            "A516BF0C13C70800000000AABBCCDD53070A3C2305141001";
+
+    auto builder = StubSmartCard::builder();
+    auto& commandStep = builder->withPowerOnData(HexUtil::toByteArray(CARD_POWER_ON_DATA))
+                                .withProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL);
+
+    /* Select application */
+    for (const auto& aid : aids) {
+        commandStep.withSimulatedCommand(
+            "00A40400" + HexUtil::toHex(static_cast<uint8_t>(aid.size() / 2)) + aid + "00",
+            dfName.compare(0, aid.size(), aid) == 0 ? fci + "9000" : "6A82");
+    }
+
+    /* Ping command (used by the card removal procedure) */
+    return commandStep.withSimulatedCommand("00C0000000", "9000")
+                      .build();
+}
+
+std::shared_ptr<StubSmartCard> StubSmartCardFactory::createStubRev1Card()
+{
+    return StubSmartCard::builder()
+               ->withPowerOnData(HexUtil::toByteArray(REV1_CARD_POWER_ON_DATA))
+               .withProtocol(ConfigurationUtil::INNOVATRON_CARD_PROTOCOL)
+               .build();
+}
+
+std::shared_ptr<StubSmartCard> StubSmartCardFactory::createStubGateCard(const uint32_t serialNumber)
+{
+    /* The serial number is the one of the default stub card with its last four bytes replaced */
+    const std::string serialNumberSuffix =
+        HexUtil::toHex(static_cast<uint8_t>(serialNumber >> 24)) +
+        HexUtil::toHex(static_cast<uint8_t>(serialNumber >> 16)) +
+        HexUtil::toHex(static_cast<uint8_t>(serialNumber >> 8)) +
+        HexUtil::toHex(static_cast<uint8_t>(serialNumber));
+
+    /* The simulated commands are regular expressions, matching any data and key */
+    return StubSmartCard::builder()
+               ->withPowerOnData(HexUtil::toByteArray(CARD_POWER_ON_DATA))
+               .withProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL)
+               /* Select application */
+               .withSimulatedCommand(
+                   "00A4040009315449432E4943413100",
+                   "6F238409315449432E49434131A516BF0C13C70800000000" +
+                   serialNumberSuffix +
+                   "53070A3C23051410019000")
+               /* Read record 1 of the environment and of the event log */
+               .withSimulatedCommand(
+                   "00B2013C.*",
+                   "00112233445566778899AABBCCDDEEFF00112233445566778899AABBCC9000")
+               .withSimulatedCommand(
+                   "00B20144.*",
+                   "FFEEDDCCBBAA99887766554433221100FFEEDDCCBBAA998877665544339000")
+               /* Open secure session, without record data */
+               .withSimulatedCommand("008A.*", "0308D181003079009000")
+               /* Append record */
+               .withSimulatedCommand("00E2.*", "9000")
+               /* Close secure session */
+               .withSimulatedCommand("008E.*", "876543219000")
+               /* Ratification */
+               .withSimulatedCommand("00B20000.*", "9000")
+               /* Ping command (used by the card removal procedure) */
+               .withSimulatedCommand("00C0000000", "9000")
+               .build();
+}
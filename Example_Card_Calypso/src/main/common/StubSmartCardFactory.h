@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 /* Keyple Plugin Stub */
 #include "StubSmartCard.h"
@@ -39,6 +41,70 @@ public:
      */
     static std::shared_ptr<StubSmartCard> getStubSam();
 
+    /**
+     * Creates a new stub smart card for a Calypso SAM answering the signature commands, each
+     * stub reader needing its own instance
+     *
+     * <p>All the payloads get the same signature, and all the signatures are valid.
+     *
+     * @return A not null reference
+     */
+    static std::shared_ptr<StubSmartCard> createStubSignatureSam();
+
+    /**
+     * Creates a new stub smart card for a Calypso card accepting secure sessions of record
+     * modifications, each stub reader needing its own instance
+     *
+     * <p>The capacity of the modifications buffer is given by the buffer size indicator of the
+     * startup information (e.g. 0x0A for 430 bytes).
+     *
+     * @param bufferSizeIndicator The buffer size indicator.
+     * @return A not null reference
+     */
+    static std::shared_ptr<StubSmartCard> createStubSessionCard(const uint8_t bufferSizeIndicator);
+
+    /**
+     * Creates a new stub smart card for a Calypso SAM answering the secure session commands of any
+     * card, each stub reader needing its own instance
+     *
+     * @return A not null reference
+     */
+    static std::shared_ptr<StubSmartCard> createStubSessionSam();
+
+    /**
+     * Creates a new stub smart card for a Calypso card of a mixed fleet (ISO 14443-4), each stub
+     * reader needing its own instance
+     *
+     * <p>The card answers the selection of each AID provided, with its FCI if its DF Name is
+     * prefixed by the AID, with "application not found" otherwise.
+     *
+     * @param dfName The DF Name of the application of the card, in hexadecimal.
+     * @param aids The AIDs or AID prefixes selected by the terminal, in hexadecimal.
+     * @return A not null reference
+     */
+    static std::shared_ptr<StubSmartCard> createStubFleetCard(const std::string& dfName,
+                                                              const std::vector<std::string>& aids);
+
+    /**
+     * Creates a new stub smart card for a Calypso card Revision 1 (Innovatron B Prime protocol),
+     * selected by its protocol only, each stub reader needing its own instance
+     *
+     * @return A not null reference
+     */
+    static std::shared_ptr<StubSmartCard> createStubRev1Card();
+
+    /**
+     * Creates a new stub smart card for a Calypso card validated at a gate, each stub reader
+     * needing its own instance
+     *
+     * <p>The card answers the reading of the first record of the environment and of the event log,
+     * and the secure session commands appending a record.
+     *
+     * @param serialNumber The last four bytes of the application serial number.
+     * @return A not null reference
+     */
+    static std::shared_ptr<StubSmartCard> createStubGateCard(const uint32_t serialNumber);
+
 private:
     /**
      *
@@ -55,11 +121,21 @@ private:
      */
     static const std::string SAM_POWER_ON_DATA;
 
+    /**
+     *
+     */
+    static const std::string REV1_CARD_POWER_ON_DATA;
+
     /**
      *
      */
     static std::shared_ptr<StubSmartCard> mStubSam;
 
+    /**
+     *
+     */
+    static const std::string SIGNATURE;
+
     /**
      * (private)<br>
      * Constructor
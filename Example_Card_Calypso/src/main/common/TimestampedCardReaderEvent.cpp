@@ -0,0 +1,101 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "TimestampedCardReaderEvent.h"
+
+TimestampedCardReaderEvent::TimestampedCardReaderEvent(
+  const std::shared_ptr<CardReaderEvent> event,
+  const bool isDetectionKnown,
+  const std::chrono::steady_clock::time_point detection,
+  const std::chrono::steady_clock::time_point notification)
+: mEvent(event),
+  mIsDetectionKnown(isDetectionKnown),
+  mDetection(detection),
+  mNotification(notification),
+  mIsSelectionResultParseStartMarked(false),
+  mIsSelectionResultParseEndMarked(false) {}
+
+const std::string& TimestampedCardReaderEvent::getReaderName() const
+{
+    return mEvent->getReaderName();
+}
+
+CardReaderEvent::Type TimestampedCardReaderEvent::getType() const
+{
+    return mEvent->getType();
+}
+
+const std::shared_ptr<ScheduledCardSelectionsResponse>
+    TimestampedCardReaderEvent::getScheduledCardSelectionsResponse() const
+{
+    return mEvent->getScheduledCardSelectionsResponse();
+}
+
+void TimestampedCardReaderEvent::markSelectionResultParseStart()
+{
+    mSelectionResultParseStart = std::chrono::steady_clock::now();
+    mIsSelectionResultParseStartMarked = true;
+}
+
+void TimestampedCardReaderEvent::markSelectionResultParseEnd()
+{
+    mSelectionResultParseEnd = std::chrono::steady_clock::now();
+    mIsSelectionResultParseEndMarked = true;
+}
+
+bool TimestampedCardReaderEvent::isDetectionKnown() const
+{
+    return mIsDetectionKnown;
+}
+
+std::chrono::microseconds TimestampedCardReaderEvent::getDetectionToNotificationTime() const
+{
+    if (!mIsDetectionKnown) {
+        return std::chrono::microseconds::zero();
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(mNotification - mDetection);
+}
+
+std::chrono::microseconds
+    TimestampedCardReaderEvent::getNotificationToSelectionResultParseTime() const
+{
+    if (!mIsSelectionResultParseStartMarked) {
+        return std::chrono::microseconds::zero();
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(mSelectionResultParseStart -
+                                                                 mNotification);
+}
+
+std::chrono::microseconds TimestampedCardReaderEvent::getSelectionResultParseTime() const
+{
+    if (!mIsSelectionResultParseStartMarked || !mIsSelectionResultParseEndMarked) {
+        return std::chrono::microseconds::zero();
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(mSelectionResultParseEnd -
+                                                                 mSelectionResultParseStart);
+}
+
+void TimestampedCardReaderEvent::logTimestamps(Logger& logger) const
+{
+    if (mIsDetectionKnown) {
+        logger.info("Detection to notification: % us\n", getDetectionToNotificationTime().count());
+    } else {
+        logger.info("Detection to notification: n/a (detection time not known)\n");
+    }
+
+    logger.info("Notification to selection result parse: % us, selection result parse: % us\n",
+                getNotificationToSelectionResultParseTime().count(),
+                getSelectionResultParseTime().count());
+}
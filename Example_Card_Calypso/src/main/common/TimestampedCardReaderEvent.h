@@ -0,0 +1,141 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+/* Calypsonet Terminal Reader */
+#include "CardReaderEvent.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::selection;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Card reader event carrying the timestamps of the stages leading to its processing, delivered to
+ * the observers placed behind a TimestampingCardReaderObserver.
+ *
+ * <p>The stages are:
+ *
+ * <ul>
+ *   <li>detection: the card entered the field. Only known when the card insertion source can tell
+ *       it (e.g. a Stub reader), the core service does not expose it.
+ *   <li>notification: the event reached the observers. The time elapsed since the detection covers
+ *       the polling of the reader, the scheduled selection and the observer dispatch.
+ *   <li>selection result parse start/end: the host-side parsing of the scheduled selection
+ *       response by the observer (CardSelectionManager::parseScheduledCardSelectionsResponse),
+ *       marked by the observer. The selection APDUs themselves were exchanged before the
+ *       notification.
+ * </ul>
+ *
+ * <p>An observer retrieves the timestamps with a dynamic cast of the received event.
+ */
+class TimestampedCardReaderEvent final : public CardReaderEvent {
+public:
+    /**
+     * Constructor.
+     *
+     * @param event The original event.
+     * @param isDetectionKnown True if the detection time is known.
+     * @param detection The detection time (ignored if unknown).
+     * @param notification The notification time.
+     */
+    TimestampedCardReaderEvent(const std::shared_ptr<CardReaderEvent> event,
+                               const bool isDetectionKnown,
+                               const std::chrono::steady_clock::time_point detection,
+                               const std::chrono::steady_clock::time_point notification);
+
+    /**
+     * {@inheritDoc}
+     */
+    const std::string& getReaderName() const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    CardReaderEvent::Type getType() const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    const std::shared_ptr<ScheduledCardSelectionsResponse> getScheduledCardSelectionsResponse()
+        const override;
+
+    /**
+     * Marks the start of the parsing of the scheduled selection response.
+     */
+    void markSelectionResultParseStart();
+
+    /**
+     * Marks the end of the parsing of the scheduled selection response.
+     */
+    void markSelectionResultParseEnd();
+
+    /**
+     * @return True if the detection time is known.
+     */
+    bool isDetectionKnown() const;
+
+    /**
+     * @return The time elapsed between the detection and the notification, 0 if unknown.
+     */
+    std::chrono::microseconds getDetectionToNotificationTime() const;
+
+    /**
+     * @return The time elapsed between the notification and the start of the selection response
+     *         parsing, 0 if not marked.
+     */
+    std::chrono::microseconds getNotificationToSelectionResultParseTime() const;
+
+    /**
+     * @return The duration of the selection response parsing, 0 if not marked.
+     */
+    std::chrono::microseconds getSelectionResultParseTime() const;
+
+    /**
+     * Logs the stage durations of the event.
+     *
+     * @param logger The logger to use.
+     */
+    void logTimestamps(Logger& logger) const;
+
+private:
+    /**
+     *
+     */
+    const std::shared_ptr<CardReaderEvent> mEvent;
+
+    /**
+     *
+     */
+    const bool mIsDetectionKnown;
+
+    /**
+     * Stage timestamps.
+     */
+    const std::chrono::steady_clock::time_point mDetection;
+    const std::chrono::steady_clock::time_point mNotification;
+    std::chrono::steady_clock::time_point mSelectionResultParseStart;
+    std::chrono::steady_clock::time_point mSelectionResultParseEnd;
+
+    /**
+     *
+     */
+    bool mIsSelectionResultParseStartMarked;
+    bool mIsSelectionResultParseEndMarked;
+};
@@ -0,0 +1,109 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "TimestampingCardReaderObserver.h"
+
+/* Keyple Cpp Example */
+#include "TimestampedCardReaderEvent.h"
+
+/* STAGE STATISTICS ----------------------------------------------------------------------------- */
+
+void TimestampingCardReaderObserver::StageStatistics::add(const std::chrono::microseconds duration)
+{
+    count++;
+    total += duration;
+    if (duration > max) {
+        max = duration;
+    }
+}
+
+long long TimestampingCardReaderObserver::StageStatistics::getAverage() const
+{
+    return count == 0 ? 0 : total.count() / static_cast<long long>(count);
+}
+
+/* TIMESTAMPING CARD READER OBSERVER ------------------------------------------------------------ */
+
+TimestampingCardReaderObserver::TimestampingCardReaderObserver(
+  std::shared_ptr<CardReaderObserverSpi> observer)
+: mObserver(observer), mIsDetectionPending(false) {}
+
+void TimestampingCardReaderObserver::markCardDetection()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    mDetection = std::chrono::steady_clock::now();
+    mIsDetectionPending = true;
+}
+
+void TimestampingCardReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> event)
+{
+    const auto notification = std::chrono::steady_clock::now();
+    const bool isInsertion = event->getType() == CardReaderEvent::Type::CARD_INSERTED ||
+                             event->getType() == CardReaderEvent::Type::CARD_MATCHED;
+    bool isDetectionKnown = false;
+    std::chrono::steady_clock::time_point detection;
+
+    if (isInsertion) {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        /* The pending detection belongs to this insertion */
+        isDetectionKnown = mIsDetectionPending;
+        detection = mDetection;
+        mIsDetectionPending = false;
+    }
+
+    auto timestampedEvent =
+        std::make_shared<TimestampedCardReaderEvent>(event,
+                                                     isDetectionKnown,
+                                                     detection,
+                                                     notification);
+
+    mObserver->onReaderEvent(timestampedEvent);
+
+    if (isInsertion) {
+        const auto processingTime =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - notification);
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        if (timestampedEvent->isDetectionKnown()) {
+            mDetectionToNotification.add(timestampedEvent->getDetectionToNotificationTime());
+        }
+        mNotificationToSelectionResultParse.add(
+            timestampedEvent->getNotificationToSelectionResultParseTime());
+        mSelectionResultParse.add(timestampedEvent->getSelectionResultParseTime());
+        mObserverProcessing.add(processingTime);
+    }
+}
+
+void TimestampingCardReaderObserver::logStatistics()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    mLogger->info("Card insertions timestamped: % (detection time known: %)\n",
+                  mObserverProcessing.count,
+                  mDetectionToNotification.count);
+    mLogger->info("Detection to notification: average % us, max % us\n",
+                  mDetectionToNotification.getAverage(),
+                  mDetectionToNotification.max.count());
+    mLogger->info("Notification to selection result parse: average % us, max % us\n",
+                  mNotificationToSelectionResultParse.getAverage(),
+                  mNotificationToSelectionResultParse.max.count());
+    mLogger->info("Selection result parse: average % us, max % us\n",
+                  mSelectionResultParse.getAverage(),
+                  mSelectionResultParse.max.count());
+    mLogger->info("Observer processing: average % us, max % us\n",
+                  mObserverProcessing.getAverage(),
+                  mObserverProcessing.max.count());
+}
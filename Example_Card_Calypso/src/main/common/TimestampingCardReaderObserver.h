@@ -0,0 +1,107 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/* Calypsonet Terminal Reader */
+#include "CardReaderEvent.h"
+#include "CardReaderObserverSpi.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::spi;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Reader observer placed first in front of the other reader observers to timestamp the card
+ * reader events.
+ *
+ * <p>Each event is forwarded as a TimestampedCardReaderEvent carrying its notification time and,
+ * for a card insertion, the detection time provided beforehand with markCardDetection. The stage
+ * durations of the card insertions are aggregated once the observer behind has returned.
+ */
+class TimestampingCardReaderObserver final : public CardReaderObserverSpi {
+public:
+    /**
+     * Constructor.
+     *
+     * @param observer The observer to which the timestamped events are forwarded.
+     */
+    explicit TimestampingCardReaderObserver(std::shared_ptr<CardReaderObserverSpi> observer);
+
+    /**
+     * Records the time a card entered the field, attached to the next card insertion event.
+     *
+     * <p>To be called by the card insertion source when it knows it (e.g. a Stub reader).
+     */
+    void markCardDetection();
+
+    /**
+     * {@inheritDoc}
+     */
+    void onReaderEvent(const std::shared_ptr<CardReaderEvent> event) override;
+
+    /**
+     * Logs the average and maximum stage durations of the card insertions processed.
+     */
+    void logStatistics();
+
+private:
+    /**
+     * Aggregated duration of a stage.
+     */
+    struct StageStatistics {
+        uint64_t count = 0;
+        std::chrono::microseconds total = std::chrono::microseconds::zero();
+        std::chrono::microseconds max = std::chrono::microseconds::zero();
+
+        void add(const std::chrono::microseconds duration);
+        long long getAverage() const;
+    };
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger =
+        LoggerFactory::getLogger(typeid(TimestampingCardReaderObserver));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardReaderObserverSpi> mObserver;
+
+    /**
+     * Time of the last card detection, valid if mIsDetectionPending is true.
+     */
+    std::chrono::steady_clock::time_point mDetection;
+    bool mIsDetectionPending;
+
+    /**
+     * Statistics.
+     */
+    StageStatistics mDetectionToNotification;
+    StageStatistics mNotificationToSelectionResultParse;
+    StageStatistics mSelectionResultParse;
+    StageStatistics mObserverProcessing;
+
+    /**
+     *
+     */
+    std::mutex mMutex;
+};
@@ -0,0 +1,355 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "TraceableFileSigner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Keyple Core Util */
+#include "IllegalArgumentException.h"
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+/* Number of prepared batches waiting for the SAM, bounding the memory used */
+static const size_t PIPELINE_DEPTH = 2;
+
+/**
+ * Read-only access to a file, memory-mapped where available, read through a stream otherwise.
+ */
+class InputFile final {
+public:
+    explicit InputFile(const std::string& fileName)
+    {
+#if defined(_WIN32)
+        mStream.open(fileName, std::ios::binary | std::ios::ate);
+        if (!mStream.is_open()) {
+            throw IllegalArgumentException("Unable to open the file to sign: " + fileName);
+        }
+        mSize = static_cast<uint64_t>(mStream.tellg());
+#else
+        mFd = open(fileName.c_str(), O_RDONLY);
+        if (mFd < 0) {
+            throw IllegalArgumentException("Unable to open the file to sign: " + fileName);
+        }
+
+        struct stat fileStat;
+        if (fstat(mFd, &fileStat) != 0) {
+            close(mFd);
+            throw IllegalArgumentException("Unable to get the size of the file to sign: " + fileName);
+        }
+        mSize = static_cast<uint64_t>(fileStat.st_size);
+
+        /* An empty file cannot be mapped */
+        mData = nullptr;
+        mReleasedOffset = 0;
+        if (mSize != 0) {
+            void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+            if (data == MAP_FAILED) {
+                close(mFd);
+                throw IllegalArgumentException("Unable to map the file to sign: " + fileName);
+            }
+            mData = static_cast<const uint8_t*>(data);
+            madvise(data, mSize, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    ~InputFile()
+    {
+#if !defined(_WIN32)
+        if (mData != nullptr) {
+            munmap(const_cast<uint8_t*>(mData), mSize);
+        }
+        close(mFd);
+#endif
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    uint64_t getSize() const
+    {
+        return mSize;
+    }
+
+    /**
+     * Copies bytes of the file.
+     */
+    void read(const uint64_t offset, const size_t length, uint8_t* destination)
+    {
+#if defined(_WIN32)
+        mStream.seekg(offset);
+        mStream.read(reinterpret_cast<char*>(destination), length);
+#else
+        std::memcpy(destination, mData + offset, length);
+#endif
+    }
+
+    /**
+     * Lets the system reclaim the pages preceding an offset, which will not be read again.
+     */
+    void release(const uint64_t offset)
+    {
+#if !defined(_WIN32)
+        const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        const uint64_t releasedOffset = offset / pageSize * pageSize;
+        if (releasedOffset > mReleasedOffset) {
+            madvise(const_cast<uint8_t*>(mData) + mReleasedOffset,
+                    releasedOffset - mReleasedOffset,
+                    MADV_DONTNEED);
+            mReleasedOffset = releasedOffset;
+        }
+#else
+        (void)offset;
+#endif
+    }
+
+private:
+    uint64_t mSize;
+#if defined(_WIN32)
+    std::ifstream mStream;
+#else
+    int mFd;
+    const uint8_t* mData;
+    uint64_t mReleasedOffset;
+#endif
+};
+
+const size_t TraceableFileSigner::DEFAULT_CHUNK_SIZE = 200;
+const size_t TraceableFileSigner::MAX_SIGNED_DATA_SIZE = 206;
+const size_t TraceableFileSigner::TRACEABILITY_INFO_SIZE = 6;
+const size_t TraceableFileSigner::SIGNATURE_SIZE = 8;
+
+TraceableFileSigner::TraceableFileSigner(std::shared_ptr<CardReader> samReader,
+                                         std::shared_ptr<CalypsoSam> sam,
+                                         std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+                                         const uint8_t kif,
+                                         const uint8_t kvc,
+                                         const size_t chunkSize,
+                                         const int batchSize)
+: mKif(kif),
+  mKvc(kvc),
+  mChunkSize(chunkSize),
+  mBatchSize(batchSize),
+  mSignedByteCount(0),
+  mChunkCount(0),
+  mExchangeCount(0),
+  mProcessingTimeNs(0)
+{
+    if (chunkSize == 0 || chunkSize + TRACEABILITY_INFO_SIZE > MAX_SIGNED_DATA_SIZE) {
+        throw IllegalArgumentException("The chunk size must be between 1 and " +
+                                       std::to_string(MAX_SIGNED_DATA_SIZE -
+                                                      TRACEABILITY_INFO_SIZE));
+    }
+
+    if (batchSize <= 0) {
+        throw IllegalArgumentException("The batch size must be strictly positive");
+    }
+
+    mSamTransactionManager =
+        CalypsoExtensionService::getInstance()->createSamTransaction(samReader,
+                                                                      sam,
+                                                                      samSecuritySetting);
+}
+
+uint64_t TraceableFileSigner::signFile(const std::string& inputFileName,
+                                       const std::string& manifestFileName)
+{
+    typedef std::vector<std::shared_ptr<TraceableSignatureComputationData>> Batch;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    InputFile inputFile(inputFileName);
+    const uint64_t fileSize = inputFile.getSize();
+
+    std::ofstream manifest(manifestFileName, std::ios::binary | std::ios::trunc);
+    if (!manifest.is_open()) {
+        throw IllegalArgumentException("Unable to open the manifest: " + manifestFileName);
+    }
+
+    /* Header */
+    manifest.write("KTSM", 4);
+    manifest.put(1);
+    manifest.put(static_cast<char>(mKif));
+    manifest.put(static_cast<char>(mKvc));
+    manifest.put(static_cast<char>(TRACEABILITY_INFO_SIZE));
+    manifest.put(static_cast<char>(SIGNATURE_SIZE));
+    manifest.put(static_cast<char>(mChunkSize >> 8));
+    manifest.put(static_cast<char>(mChunkSize));
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        manifest.put(static_cast<char>(fileSize >> shift));
+    }
+
+    std::deque<Batch> preparedBatches;
+    bool isPreparationDone = false;
+    bool isStopping = false;
+    std::exception_ptr preparationError;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    /* Prepare the chunks while the SAM signs the previous ones */
+    std::thread preparationThread([&]() {
+        try {
+            uint64_t offset = 0;
+            while (offset < fileSize) {
+                Batch batch;
+                for (int i = 0; i < mBatchSize && offset < fileSize; i++) {
+                    const size_t length =
+                        static_cast<size_t>(std::min<uint64_t>(mChunkSize, fileSize - offset));
+
+                    /* The placeholder of the traceability information precedes the chunk */
+                    std::vector<uint8_t> data(TRACEABILITY_INFO_SIZE + length, 0);
+                    inputFile.read(offset, length, data.data() + TRACEABILITY_INFO_SIZE);
+
+                    std::shared_ptr<TraceableSignatureComputationData> signatureComputationData =
+                        CalypsoExtensionService::getInstance()
+                            ->createTraceableSignatureComputationData();
+                    signatureComputationData->setData(data, mKif, mKvc)
+                                             .withSamTraceabilityMode(0, true);
+                    batch.push_back(signatureComputationData);
+
+                    offset += length;
+                }
+                inputFile.release(offset);
+
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() {
+                    return preparedBatches.size() < PIPELINE_DEPTH || isStopping;
+                });
+                if (isStopping) {
+                    break;
+                }
+                preparedBatches.push_back(std::move(batch));
+                lock.unlock();
+                condition.notify_all();
+            }
+
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(mutex);
+            preparationError = std::current_exception();
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            isPreparationDone = true;
+        }
+        condition.notify_all();
+    });
+
+    uint64_t chunkCount = 0;
+    try {
+        while (true) {
+            Batch batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() {
+                    return !preparedBatches.empty() || isPreparationDone;
+                });
+                if (preparedBatches.empty()) {
+                    break;
+                }
+                batch = std::move(preparedBatches.front());
+                preparedBatches.pop_front();
+            }
+            condition.notify_all();
+
+            for (const auto& signatureComputationData : batch) {
+                mSamTransactionManager->prepareComputeSignature(signatureComputationData);
+            }
+            mSamTransactionManager->processCommands();
+            mExchangeCount++;
+
+            for (const auto& signatureComputationData : batch) {
+                const std::vector<uint8_t>& signedData = signatureComputationData->getSignedData();
+                const std::vector<uint8_t>& signature = signatureComputationData->getSignature();
+
+                if (signature.size() != SIGNATURE_SIZE ||
+                    signedData.size() < TRACEABILITY_INFO_SIZE) {
+                    throw IllegalStateException("Unexpected signature size: " +
+                                                std::to_string(signature.size()));
+                }
+
+                manifest.write(reinterpret_cast<const char*>(signedData.data()),
+                               TRACEABILITY_INFO_SIZE);
+                manifest.write(reinterpret_cast<const char*>(signature.data()), SIGNATURE_SIZE);
+
+                mSignedByteCount += signedData.size() - TRACEABILITY_INFO_SIZE;
+            }
+
+            chunkCount += batch.size();
+        }
+
+    } catch (...) {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            isStopping = true;
+        }
+        condition.notify_all();
+        preparationThread.join();
+        throw;
+    }
+
+    preparationThread.join();
+
+    if (preparationError) {
+        std::rethrow_exception(preparationError);
+    }
+
+    manifest.flush();
+
+    mChunkCount += chunkCount;
+    mProcessingTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start).count();
+
+    return chunkCount;
+}
+
+uint64_t TraceableFileSigner::getSignedByteCount() const
+{
+    return mSignedByteCount;
+}
+
+double TraceableFileSigner::getBytesPerSecond() const
+{
+    if (mProcessingTimeNs == 0) {
+        return 0;
+    }
+
+    return mSignedByteCount * 1e9 / mProcessingTimeNs;
+}
+
+void TraceableFileSigner::logStatistics() const
+{
+    mLogger->info("File signing: % bytes in % chunks of % bytes, % exchanges, % bytes/s\n",
+                  mSignedByteCount,
+                  mChunkCount,
+                  mChunkSize,
+                  mExchangeCount,
+                  static_cast<uint64_t>(getBytesPerSecond()));
+}
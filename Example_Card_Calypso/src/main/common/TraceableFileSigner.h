@@ -0,0 +1,182 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/* Calypsonet Terminal Calypso */
+#include "CalypsoSam.h"
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+
+/* Keyple Card Calypso */
+#include "CalypsoExtensionService.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Examples */
+#include "BatchSigner.h"
+
+using namespace calypsonet::terminal::calypso::sam;
+using namespace calypsonet::terminal::calypso::transaction;
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::calypso;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Traceable signature generation of a whole file, streamed through a SAM.
+ *
+ * <p>The file is memory-mapped and split into chunks fitting in a PSO Compute Signature. Each chunk
+ * is preceded by a placeholder in which the SAM writes its traceability information (partial
+ * serial number and counter), so that the content of the file is signed unaltered. The chunks are
+ * prepared by a dedicated thread while the SAM computes the signatures of the previous batch,
+ * through a queue of a few batches, and the pages of the file already signed are released, so
+ * that the file is never loaded as a whole.
+ *
+ * <p>The signatures are written to a binary manifest:
+ *
+ * <ul>
+ *   <li>Header: "KTSM", version (1 byte), KIF (1 byte), KVC (1 byte), traceability information
+ *       size (1 byte), signature size (1 byte), chunk size (2 bytes), file size (8 bytes), the
+ *       integers being big-endian.
+ *   <li>Then for each chunk, in file order: the traceability information written by the SAM,
+ *       followed by the signature.
+ * </ul>
+ *
+ * <p>A chunk is verified with the traceability information followed by the chunk as signed data.
+ */
+class TraceableFileSigner final {
+public:
+    /**
+     * Default number of bytes of the file per chunk.
+     */
+    static const size_t DEFAULT_CHUNK_SIZE;
+
+    /**
+     * Maximum number of bytes signed by a PSO Compute Signature with SAM traceability.
+     */
+    static const size_t MAX_SIGNED_DATA_SIZE;
+
+    /**
+     * Size of the traceability information written by the SAM (partial serial number and
+     * counter).
+     */
+    static const size_t TRACEABILITY_INFO_SIZE;
+
+    /**
+     * Size of the signatures (default signature size of the computation data).
+     */
+    static const size_t SIGNATURE_SIZE;
+
+    /**
+     * Constructor.
+     *
+     * @param samReader The reader of the SAM.
+     * @param sam The selected SAM.
+     * @param samSecuritySetting The SAM security settings.
+     * @param kif The KIF of the signing key.
+     * @param kvc The KVC of the signing key.
+     * @param chunkSize The number of bytes of the file per chunk.
+     * @param batchSize The maximum number of chunks signed per processCommands.
+     * @throw IllegalArgumentException If the chunk size does not fit in a signature command or if
+     *        the batch size is not strictly positive.
+     */
+    TraceableFileSigner(std::shared_ptr<CardReader> samReader,
+                        std::shared_ptr<CalypsoSam> sam,
+                        std::shared_ptr<SamSecuritySetting> samSecuritySetting,
+                        const uint8_t kif,
+                        const uint8_t kvc,
+                        const size_t chunkSize = DEFAULT_CHUNK_SIZE,
+                        const int batchSize = BatchSigner::DEFAULT_BATCH_SIZE);
+
+    /**
+     * Signs a file and writes its manifest.
+     *
+     * @param inputFileName The file to sign.
+     * @param manifestFileName The manifest, overwritten.
+     * @return The number of chunks signed.
+     * @throw IllegalArgumentException If a file cannot be opened or mapped.
+     * @throw IllegalStateException If the SAM returns a signature of an unexpected size.
+     */
+    uint64_t signFile(const std::string& inputFileName, const std::string& manifestFileName);
+
+    /**
+     * @return The number of bytes of files signed.
+     */
+    uint64_t getSignedByteCount() const;
+
+    /**
+     * @return The bytes of files signed per second, 0 if none.
+     */
+    double getBytesPerSecond() const;
+
+    /**
+     * Logs the statistics.
+     */
+    void logStatistics() const;
+
+private:
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(TraceableFileSigner));
+
+    /**
+     *
+     */
+    std::shared_ptr<SamTransactionManager> mSamTransactionManager;
+
+    /**
+     *
+     */
+    const uint8_t mKif;
+
+    /**
+     *
+     */
+    const uint8_t mKvc;
+
+    /**
+     *
+     */
+    const size_t mChunkSize;
+
+    /**
+     *
+     */
+    const int mBatchSize;
+
+    /**
+     *
+     */
+    uint64_t mSignedByteCount;
+
+    /**
+     *
+     */
+    uint64_t mChunkCount;
+
+    /**
+     *
+     */
+    uint64_t mExchangeCount;
+
+    /**
+     * Cumulated duration of the file signings, in nanoseconds.
+     */
+    uint64_t mProcessingTimeNs;
+};
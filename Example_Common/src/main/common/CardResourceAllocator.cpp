@@ -0,0 +1,145 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "CardResourceAllocator.h"
+
+#include <algorithm>
+#include <chrono>
+
+const long CardResourceAllocator::RECHECK_INTERVAL_MS = 500;
+
+CardResourceAllocator::CardResourceAllocator(
+  std::shared_ptr<CardResourceService> cardResourceService,
+  std::shared_ptr<CardResourceServiceMetrics> metrics)
+: mCardResourceService(cardResourceService), mMetrics(metrics) {}
+
+std::shared_ptr<CardResourceAllocator::ProfileState> CardResourceAllocator::getProfileState(
+    const std::string& cardResourceProfileName)
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    std::shared_ptr<ProfileState>& state = mProfileStates[cardResourceProfileName];
+    if (state == nullptr) {
+        state = std::make_shared<ProfileState>();
+    }
+
+    return state;
+}
+
+std::shared_ptr<CardResource> CardResourceAllocator::getCardResource(
+    const std::string& cardResourceProfileName, const long timeoutMs)
+{
+    const auto requestTime = std::chrono::steady_clock::now();
+    const auto deadline = requestTime + std::chrono::milliseconds(timeoutMs);
+    std::shared_ptr<ProfileState> state = getProfileState(cardResourceProfileName);
+    std::unique_lock<std::mutex> lock(state->mutex);
+
+    std::deque<uint64_t>& queue = state->waitingQueue;
+    const uint64_t ticket = state->nextTicket++;
+    queue.push_back(ticket);
+
+    std::shared_ptr<CardResource> cardResource = nullptr;
+
+    while (true) {
+        /* Only the first caller of the queue competes for a card resource */
+        if (queue.front() == ticket) {
+            const uint64_t availabilityCount = state->availabilityCount;
+
+            /* The service call is done unlocked, the other callers only wait behind the ticket */
+            lock.unlock();
+            try {
+                cardResource = mCardResourceService->getCardResource(cardResourceProfileName);
+            } catch (...) {
+                lock.lock();
+                queue.erase(std::find(queue.begin(), queue.end(), ticket));
+                lock.unlock();
+                state->condition.notify_all();
+                throw;
+            }
+            lock.lock();
+
+            if (cardResource != nullptr) {
+                break;
+            }
+
+            /* A card resource became available during the call, retry at once */
+            if (state->availabilityCount != availabilityCount) {
+                continue;
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+
+        state->condition.wait_until(
+            lock, std::min(deadline, now + std::chrono::milliseconds(RECHECK_INTERVAL_MS)));
+    }
+
+    queue.erase(std::find(queue.begin(), queue.end(), ticket));
+
+    /* Let the next caller of the queue compete */
+    lock.unlock();
+    state->condition.notify_all();
+
+    if (mMetrics != nullptr) {
+        const long long waitTimeUs =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - requestTime).count();
+        if (cardResource != nullptr) {
+            mMetrics->onAllocation(cardResourceProfileName, cardResource, waitTimeUs);
+        } else {
+            mMetrics->onAllocationFailure(cardResourceProfileName, waitTimeUs);
+        }
+    }
+
+    if (cardResource == nullptr) {
+        mLogger->debug("No card resource of profile '%' available within % ms\n",
+                       cardResourceProfileName,
+                       timeoutMs);
+    }
+
+    return cardResource;
+}
+
+void CardResourceAllocator::releaseCardResource(std::shared_ptr<CardResource> cardResource)
+{
+    if (mMetrics != nullptr) {
+        mMetrics->onRelease(cardResource);
+    }
+
+    mCardResourceService->releaseCardResource(cardResource);
+
+    notifyCardResourceAvailable();
+}
+
+void CardResourceAllocator::notifyCardResourceAvailable()
+{
+    /* A card resource may match several profiles, all of them are woken */
+    std::vector<std::shared_ptr<ProfileState>> states;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        for (const auto& entry : mProfileStates) {
+            states.push_back(entry.second);
+        }
+    }
+
+    for (const auto& state : states) {
+        {
+            const std::lock_guard<std::mutex> lock(state->mutex);
+            state->availabilityCount++;
+        }
+        state->condition.notify_all();
+    }
+}
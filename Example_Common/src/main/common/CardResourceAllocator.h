@@ -0,0 +1,156 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+#include "CardResourceService.h"
+
+/* Examples */
+#include "CardResourceServiceMetrics.h"
+
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Event-driven blocking allocation of card resources, on top of a card resource service
+ * configured in non-blocking allocation mode (i.e. without withBlockingAllocationMode).
+ *
+ * <p>The callers waiting for a card resource of a profile are queued in arrival order, each
+ * profile having its own queue, lock and wake-up. Only the first one in the queue tries to allocate
+ * a card resource, outside the lock so that the callers of the other profiles and the releases are
+ * not held during the service call; when it fails, it sleeps until a card resource is released
+ * through releaseCardResource, which wakes the waiters immediately, instead of retrying at a fixed
+ * cycle.
+ *
+ * <p>The code releasing a card resource directly with the service has to call
+ * notifyCardResourceAvailable to wake the waiters as well. The card resources appearing otherwise
+ * (card insertion, reader connection, processed by the service itself) are caught by a periodic
+ * re-check.
+ */
+class CardResourceAllocator final {
+public:
+    /**
+     * Period of the re-check of the card resources becoming available without a release through
+     * this allocator, in milliseconds.
+     */
+    static const long RECHECK_INTERVAL_MS;
+
+    /**
+     * Constructor.
+     *
+     * @param cardResourceService The card resource service, configured in non-blocking allocation
+     *        mode.
+     * @param metrics The metrics to feed with the allocations and releases (optional).
+     */
+    explicit CardResourceAllocator(
+        std::shared_ptr<CardResourceService> cardResourceService,
+        std::shared_ptr<CardResourceServiceMetrics> metrics = nullptr);
+
+    /**
+     * Gets a card resource of the provided profile, waiting for it if none is available.
+     *
+     * @param cardResourceProfileName The name of the card resource profile.
+     * @param timeoutMs The maximum waiting time in milliseconds.
+     * @return Null if no card resource became available within the timeout.
+     */
+    std::shared_ptr<CardResource> getCardResource(const std::string& cardResourceProfileName,
+                                                  const long timeoutMs);
+
+    /**
+     * Releases a card resource and wakes the callers waiting for one.
+     *
+     * @param cardResource The card resource to release.
+     */
+    void releaseCardResource(std::shared_ptr<CardResource> cardResource);
+
+    /**
+     * Wakes the callers waiting for a card resource, after a card resource was made available
+     * without this allocator (e.g. released directly with the service).
+     */
+    void notifyCardResourceAvailable();
+
+private:
+    /**
+     * Wait state of the callers of a card resource profile.
+     */
+    struct ProfileState {
+        /**
+         * Tickets of the waiting callers, in arrival order.
+         */
+        std::deque<uint64_t> waitingQueue;
+
+        /**
+         *
+         */
+        uint64_t nextTicket = 0;
+
+        /**
+         * Incremented each time a card resource may have become available, to detect the releases
+         * happening during a service call.
+         */
+        uint64_t availabilityCount = 0;
+
+        /**
+         *
+         */
+        std::mutex mutex;
+
+        /**
+         *
+         */
+        std::condition_variable condition;
+    };
+
+    /**
+     * Returns the wait state of a profile, created on first use.
+     */
+    std::shared_ptr<ProfileState> getProfileState(const std::string& cardResourceProfileName);
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(CardResourceAllocator));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardResourceService> mCardResourceService;
+
+    /**
+     * Null if no metrics.
+     */
+    std::shared_ptr<CardResourceServiceMetrics> mMetrics;
+
+    /**
+     * Wait state per card resource profile.
+     */
+    std::map<std::string, std::shared_ptr<ProfileState>> mProfileStates;
+
+    /**
+     * Guards mProfileStates only.
+     */
+    std::mutex mMutex;
+};
@@ -0,0 +1,164 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "CardResourceLease.h"
+
+/* Keyple Core Util */
+#include "Exception.h"
+#include "IllegalArgumentException.h"
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+CardResourceLease::CardResourceLease(std::shared_ptr<CardResourceService> cardResourceService,
+                                     const std::string& cardResourceProfileName,
+                                     std::shared_ptr<CardResource> cardResource)
+: mCardResourceService(cardResourceService),
+  mCardResourceProfileName(cardResourceProfileName),
+  mCardResource(cardResource),
+  mIsInvalidated(false)
+{
+    observeReader();
+}
+
+CardResourceLease::CardResourceLease(std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                                     const std::string& cardResourceProfileName,
+                                     std::shared_ptr<CardResource> cardResource)
+: mCardResourceAllocator(cardResourceAllocator),
+  mCardResourceProfileName(cardResourceProfileName),
+  mCardResource(cardResource),
+  mIsInvalidated(false)
+{
+    observeReader();
+}
+
+void CardResourceLease::observeReader()
+{
+    if (mCardResource == nullptr) {
+        throw IllegalArgumentException("The leased card resource must not be null");
+    }
+
+    /* Watch the removal of the card, which would make the card resource stale */
+    mObservableReader = std::dynamic_pointer_cast<ObservableCardReader>(mCardResource->getReader());
+    if (mObservableReader != nullptr) {
+        mRemovalObserver = std::make_shared<RemovalObserver>(*this);
+        mObservableReader->addObserver(mRemovalObserver);
+    }
+}
+
+CardResourceLease::~CardResourceLease()
+{
+    try {
+        release();
+
+    } catch (const Exception& e) {
+        mLogger->error("Unable to release the card resource of profile '%'\n",
+                       mCardResourceProfileName,
+                       e);
+    }
+
+    if (mObservableReader != nullptr) {
+        mObservableReader->removeObserver(mRemovalObserver);
+    }
+}
+
+CardResourceLease::RemovalObserver::RemovalObserver(CardResourceLease& cardResourceLease)
+: mCardResourceLease(cardResourceLease) {}
+
+void CardResourceLease::RemovalObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> event)
+{
+    if (event->getType() == CardReaderEvent::Type::CARD_REMOVED ||
+        event->getType() == CardReaderEvent::Type::UNAVAILABLE) {
+        mCardResourceLease.invalidate(event->getType());
+    }
+}
+
+const std::string& CardResourceLease::getCardResourceProfileName() const
+{
+    return mCardResourceProfileName;
+}
+
+std::shared_ptr<CardResource> CardResourceLease::getCardResource()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mCardResource == nullptr) {
+        throw IllegalStateException("The lease of the card resource of profile '" +
+                                    mCardResourceProfileName +
+                                    (mIsInvalidated ? "' has been invalidated (card removed)" :
+                                                      "' has been released"));
+    }
+
+    return mCardResource;
+}
+
+bool CardResourceLease::isReleased()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mCardResource == nullptr;
+}
+
+bool CardResourceLease::isInvalidated()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mIsInvalidated;
+}
+
+void CardResourceLease::release()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    releaseCardResource();
+}
+
+void CardResourceLease::invalidate(const CardReaderEvent::Type eventType)
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mCardResource == nullptr) {
+        return;
+    }
+
+    mIsInvalidated = true;
+    mLogger->info("Lease of the card resource of profile '%' invalidated (%)\n",
+                  mCardResourceProfileName,
+                  eventType);
+
+    try {
+        releaseCardResource();
+
+    } catch (const Exception& e) {
+        mLogger->error("Unable to release the card resource of profile '%'\n",
+                       mCardResourceProfileName,
+                       e);
+        mCardResource = nullptr;
+    }
+}
+
+void CardResourceLease::releaseCardResource()
+{
+    if (mCardResource == nullptr) {
+        return;
+    }
+
+    if (mCardResourceAllocator != nullptr) {
+        mCardResourceAllocator->releaseCardResource(mCardResource);
+    } else {
+        mCardResourceService->releaseCardResource(mCardResource);
+    }
+    mCardResource = nullptr;
+
+    mLogger->debug("Lease of the card resource of profile '%' released\n",
+                   mCardResourceProfileName);
+}
@@ -0,0 +1,207 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+/* Calypsonet Terminal Reader */
+#include "CardReaderEvent.h"
+#include "CardReaderObserverSpi.h"
+#include "ObservableCardReader.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+#include "CardResourceService.h"
+
+/* Examples */
+#include "CardResourceAllocator.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::spi;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Lease of a card resource kept allocated (and its card kept selected) for a long period, e.g. a
+ * SAM reserved by an application from its startup to its shutdown.
+ *
+ * <p>Each allocation of a card resource by the card resource service runs the selection of the
+ * card. Holding a lease avoids paying this selection at each transaction: the card resource is
+ * used directly through getCardResource, without being released between two transactions.
+ *
+ * <p>The card resource is released to the card resource service by release or, at the latest, by
+ * the destructor of the lease.
+ *
+ * <p>When the reader of the card resource is observable, the lease is invalidated (and its card
+ * resource released) as soon as the card is removed or the reader becomes unavailable, so that a
+ * stale card is never handed out. The events are only notified while the reader is observed, e.g.
+ * by a card resource service configured with the monitoring of the plugin.
+ */
+class CardResourceLease final {
+public:
+    /**
+     * Constructor.
+     *
+     * @param cardResourceService The card resource service which allocated the card resource.
+     * @param cardResourceProfileName The card resource profile of the card resource.
+     * @param cardResource The allocated card resource.
+     * @throw IllegalArgumentException If the card resource is null.
+     */
+    CardResourceLease(std::shared_ptr<CardResourceService> cardResourceService,
+                      const std::string& cardResourceProfileName,
+                      std::shared_ptr<CardResource> cardResource);
+
+    /**
+     * Constructor of a lease whose card resource is released through an allocator, waking the
+     * callers waiting for a card resource of the profile.
+     *
+     * @param cardResourceAllocator The allocator which allocated the card resource.
+     * @param cardResourceProfileName The card resource profile of the card resource.
+     * @param cardResource The allocated card resource.
+     * @throw IllegalArgumentException If the card resource is null.
+     */
+    CardResourceLease(std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                      const std::string& cardResourceProfileName,
+                      std::shared_ptr<CardResource> cardResource);
+
+    /**
+     * Releases the card resource if not already done.
+     */
+    ~CardResourceLease();
+
+    /**
+     *
+     */
+    CardResourceLease(const CardResourceLease&) = delete;
+
+    /**
+     *
+     */
+    CardResourceLease& operator=(const CardResourceLease&) = delete;
+
+    /**
+     * @return The card resource profile of the leased card resource.
+     */
+    const std::string& getCardResourceProfileName() const;
+
+    /**
+     * @return The leased card resource.
+     * @throw IllegalStateException If the lease has been released or invalidated.
+     */
+    std::shared_ptr<CardResource> getCardResource();
+
+    /**
+     * @return True if the card resource has been released (including by an invalidation).
+     */
+    bool isReleased();
+
+    /**
+     * @return True if the lease has been invalidated by the removal of the card or of its reader.
+     */
+    bool isInvalidated();
+
+    /**
+     * Releases the card resource to the card resource service, through the allocator if any (no
+     * effect if already done).
+     */
+    void release();
+
+private:
+    /**
+     * Observer of the reader of the card resource, invalidating the lease on a card removal or when
+     * the reader becomes unavailable.
+     */
+    class RemovalObserver final : public CardReaderObserverSpi {
+    public:
+        /**
+         *
+         */
+        explicit RemovalObserver(CardResourceLease& cardResourceLease);
+
+        /**
+         * {@inheritDoc}
+         */
+        void onReaderEvent(const std::shared_ptr<CardReaderEvent> event) override;
+
+    private:
+        /**
+         *
+         */
+        CardResourceLease& mCardResourceLease;
+    };
+
+    /**
+     * Starts the observation of the reader of the card resource, if observable.
+     */
+    void observeReader();
+
+    /**
+     * Releases the card resource and marks the lease invalidated.
+     */
+    void invalidate(const CardReaderEvent::Type eventType);
+
+    /**
+     * Releases the card resource (mutex held).
+     */
+    void releaseCardResource();
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(CardResourceLease));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardResourceService> mCardResourceService;
+
+    /**
+     * Null if the card resource is released to the card resource service directly.
+     */
+    std::shared_ptr<CardResourceAllocator> mCardResourceAllocator;
+
+    /**
+     *
+     */
+    const std::string mCardResourceProfileName;
+
+    /**
+     * Null once released.
+     */
+    std::shared_ptr<CardResource> mCardResource;
+
+    /**
+     *
+     */
+    bool mIsInvalidated;
+
+    /**
+     * Null if the reader is not observable.
+     */
+    std::shared_ptr<ObservableCardReader> mObservableReader;
+
+    /**
+     *
+     */
+    std::shared_ptr<RemovalObserver> mRemovalObserver;
+
+    /**
+     *
+     */
+    std::mutex mMutex;
+};
@@ -0,0 +1,231 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "CardResourceLeaseManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+/* Keyple Core Util */
+#include "Exception.h"
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+const long CardResourceLeaseManager::PRESENCE_CHECK_INTERVAL_MS = 500;
+const long CardResourceLeaseManager::RECHECK_INTERVAL_MS = 100;
+
+CardResourceLeaseManager::CardResourceLeaseManager(
+  std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+  const std::string& cardResourceProfileName)
+: mCardResourceAllocator(cardResourceAllocator),
+  mCardResourceProfileName(cardResourceProfileName),
+  mRevocationCount(0),
+  mIsStopping(false)
+{
+    mPresenceCheckThread = std::thread(&CardResourceLeaseManager::checkPresence, this);
+}
+
+CardResourceLeaseManager::~CardResourceLeaseManager()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+
+    mCondition.notify_all();
+    mPresenceCheckThread.join();
+
+    /* The leases are released by their destructor */
+    mEntries.clear();
+}
+
+std::shared_ptr<CardResource> CardResourceLeaseManager::beginTransaction(const long timeoutMs,
+                                                                         const bool isPriority)
+{
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    Entry& entry = mEntries[std::this_thread::get_id()];
+
+    if (entry.isInTransaction) {
+        throw IllegalStateException("The calling thread is already in transaction");
+    }
+
+    /* Fast path: the lease of the thread is still valid */
+    if (entry.cardResourceLease != nullptr && !entry.cardResourceLease->isReleased()) {
+        entry.isInTransaction = true;
+        return entry.cardResourceLease->getCardResource();
+    }
+
+    entry.cardResourceLease = nullptr;
+
+    /* A priority caller tries at once, then revokes a lease before waiting */
+    long allocationTimeoutMs = isPriority ? 0 : timeoutMs;
+
+    while (true) {
+        lock.unlock();
+        std::shared_ptr<CardResource> cardResource =
+            mCardResourceAllocator->getCardResource(mCardResourceProfileName,
+                                                    allocationTimeoutMs);
+        lock.lock();
+
+        /* The entry reference remains valid, only the owner thread erases its entry */
+        if (cardResource != nullptr) {
+            entry.cardResourceLease =
+                std::make_shared<CardResourceLease>(mCardResourceAllocator,
+                                                    mCardResourceProfileName,
+                                                    cardResource);
+            entry.isInTransaction = true;
+            return cardResource;
+        }
+
+        const bool isRevoked = isPriority && revokeLeaseForPriorityCaller();
+
+        const long remainingMs = static_cast<long>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count());
+        if (remainingMs <= 0 && !isRevoked) {
+            mLogger->debug("No card resource of profile '%' available within % ms\n",
+                           mCardResourceProfileName,
+                           timeoutMs);
+            return nullptr;
+        }
+
+        /* The waiting is done by the allocator, woken by the releases of the card resources */
+        allocationTimeoutMs =
+            isPriority ? std::min(std::max(remainingMs, 0L), RECHECK_INTERVAL_MS) : remainingMs;
+    }
+}
+
+bool CardResourceLeaseManager::revokeLeaseForPriorityCaller()
+{
+    Entry* entryInTransaction = nullptr;
+
+    for (auto& element : mEntries) {
+        Entry& entry = element.second;
+        if (entry.cardResourceLease == nullptr || entry.cardResourceLease->isReleased()) {
+            continue;
+        }
+
+        if (!entry.isInTransaction) {
+            entry.cardResourceLease->release();
+            mRevocationCount++;
+            mLogger->debug("Idle lease of profile '%' revoked for a priority caller\n",
+                           mCardResourceProfileName);
+            return true;
+        }
+
+        if (entry.isRevocationRequested) {
+            /* A card resource will be released at the end of a transaction in progress */
+            return false;
+        }
+
+        if (entryInTransaction == nullptr) {
+            entryInTransaction = &entry;
+        }
+    }
+
+    if (entryInTransaction != nullptr) {
+        entryInTransaction->isRevocationRequested = true;
+    }
+
+    return false;
+}
+
+void CardResourceLeaseManager::endTransaction()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        const auto it = mEntries.find(std::this_thread::get_id());
+        if (it == mEntries.end() || !it->second.isInTransaction) {
+            return;
+        }
+
+        Entry& entry = it->second;
+        entry.isInTransaction = false;
+
+        if (!entry.isRevocationRequested) {
+            return;
+        }
+
+        entry.cardResourceLease->release();
+        entry.cardResourceLease = nullptr;
+        entry.isRevocationRequested = false;
+        mRevocationCount++;
+    }
+}
+
+void CardResourceLeaseManager::releaseLease()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    /* Destroying the lease releases its card resource, waking the callers of the allocator */
+    mEntries.erase(std::this_thread::get_id());
+}
+
+uint64_t CardResourceLeaseManager::getRevocationCount()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mRevocationCount;
+}
+
+void CardResourceLeaseManager::checkPresence()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mCondition.wait_for(lock,
+                                std::chrono::milliseconds(PRESENCE_CHECK_INTERVAL_MS),
+                                [this]() { return mIsStopping; })) {
+        /* Collect the idle leases, checked without holding the mutex */
+        std::vector<std::shared_ptr<CardResourceLease>> idleLeases;
+        for (const auto& element : mEntries) {
+            const Entry& entry = element.second;
+            if (entry.cardResourceLease != nullptr && !entry.isInTransaction) {
+                idleLeases.push_back(entry.cardResourceLease);
+            }
+        }
+
+        lock.unlock();
+
+        std::vector<std::shared_ptr<CardResourceLease>> removedLeases;
+        for (const auto& cardResourceLease : idleLeases) {
+            try {
+                if (!cardResourceLease->isReleased() &&
+                    !cardResourceLease->getCardResource()->getReader()->isCardPresent()) {
+                    removedLeases.push_back(cardResourceLease);
+                }
+
+            } catch (const Exception& e) {
+                mLogger->debug("Unable to check the card presence\n", e);
+            }
+        }
+
+        lock.lock();
+
+        for (const auto& cardResourceLease : removedLeases) {
+            for (auto& element : mEntries) {
+                Entry& entry = element.second;
+                if (entry.cardResourceLease == cardResourceLease && !entry.isInTransaction) {
+                    entry.cardResourceLease->release();
+                    mRevocationCount++;
+                    mLogger->info("Lease of profile '%' revoked, the card has been removed\n",
+                                  mCardResourceProfileName);
+                }
+            }
+        }
+    }
+}
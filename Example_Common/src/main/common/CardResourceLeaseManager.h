@@ -0,0 +1,181 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+
+/* Examples */
+#include "CardResourceAllocator.h"
+#include "CardResourceLease.h"
+
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Card resources of a profile leased to the threads running transactions at a high rate (e.g. a
+ * validation loop), each thread keeping its card resource from one transaction to the next
+ * instead of getting and releasing it around each transaction.
+ *
+ * <p>The card resources are allocated and released through a CardResourceAllocator, so that the
+ * leases share the waiting queue of the profile with its other callers and wake them on release.
+ *
+ * <p>A transaction is delimited by beginTransaction and endTransaction. Out of a transaction, the
+ * lease of a thread is revoked (its card resource being released) only when:
+ *
+ * <ul>
+ *   <li>its card has been removed from the reader, checked periodically in the background,
+ *   <li>a priority caller needs a card resource while none is available.
+ * </ul>
+ *
+ * <p>A lease revoked is replaced transparently at the next transaction of the thread.
+ */
+class CardResourceLeaseManager final {
+public:
+    /**
+     * Period of the check of the presence of the cards of the leases not in transaction, in
+     * milliseconds.
+     */
+    static const long PRESENCE_CHECK_INTERVAL_MS;
+
+    /**
+     * Maximum waiting time of a priority caller in the allocator between two revocation attempts,
+     * in milliseconds.
+     */
+    static const long RECHECK_INTERVAL_MS;
+
+    /**
+     * Constructor.
+     *
+     * @param cardResourceAllocator The allocator of the card resources, shared with the other
+     *        callers of the profile.
+     * @param cardResourceProfileName The card resource profile of the leases.
+     */
+    CardResourceLeaseManager(std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                             const std::string& cardResourceProfileName);
+
+    /**
+     * Stops the presence check and releases all the leases.
+     */
+    ~CardResourceLeaseManager();
+
+    /**
+     * Begins a transaction of the calling thread, with the card resource it leases, a lease being
+     * taken if the thread has none.
+     *
+     * @param timeoutMs The maximum waiting time for a lease, in milliseconds.
+     * @param isPriority True if the lease of an idle thread may be revoked when no card resource
+     *        is available.
+     * @return The card resource to use for the transaction, null if no lease could be taken within
+     *         the timeout.
+     * @throw IllegalStateException If the calling thread is already in transaction.
+     */
+    std::shared_ptr<CardResource> beginTransaction(const long timeoutMs,
+                                                   const bool isPriority = false);
+
+    /**
+     * Ends the transaction of the calling thread, which keeps its lease for the next one unless its
+     * revocation has been requested meanwhile.
+     */
+    void endTransaction();
+
+    /**
+     * Releases the lease of the calling thread, if any (e.g. before the end of the thread).
+     */
+    void releaseLease();
+
+    /**
+     * @return The number of leases revoked since the creation of the manager.
+     */
+    uint64_t getRevocationCount();
+
+private:
+    /**
+     * Lease of a thread.
+     */
+    struct Entry {
+        std::shared_ptr<CardResourceLease> cardResourceLease;
+        bool isInTransaction = false;
+        bool isRevocationRequested = false;
+    };
+
+    /**
+     * Takes the card resource of an idle lease for a priority caller, or requests the revocation
+     * of a lease in transaction (mutex held).
+     *
+     * @return True if a card resource has been released.
+     */
+    bool revokeLeaseForPriorityCaller();
+
+    /**
+     * Releases the leases whose card has been removed (run in a dedicated thread).
+     */
+    void checkPresence();
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger =
+        LoggerFactory::getLogger(typeid(CardResourceLeaseManager));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardResourceAllocator> mCardResourceAllocator;
+
+    /**
+     *
+     */
+    const std::string mCardResourceProfileName;
+
+    /**
+     *
+     */
+    std::map<std::thread::id, Entry> mEntries;
+
+    /**
+     *
+     */
+    uint64_t mRevocationCount;
+
+    /**
+     *
+     */
+    bool mIsStopping;
+
+    /**
+     *
+     */
+    std::mutex mMutex;
+
+    /**
+     *
+     */
+    std::condition_variable mCondition;
+
+    /**
+     *
+     */
+    std::thread mPresenceCheckThread;
+};
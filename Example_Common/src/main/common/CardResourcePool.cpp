@@ -0,0 +1,337 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "CardResourcePool.h"
+
+#include <algorithm>
+
+/* Keyple Core Util */
+#include "Exception.h"
+#include "IllegalArgumentException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+const long CardResourcePool::RECHECK_INTERVAL_MS = 500;
+
+CardResourcePool::CardResourcePool(std::shared_ptr<CardResourceService> cardResourceService,
+                                   const std::vector<std::string>& cardResourceProfileNames,
+                                   const AllocationPolicy allocationPolicy)
+: mCardResourceService(cardResourceService),
+  mAllocationPolicy(allocationPolicy),
+  mNextIndex(0),
+  mReleaseCount(0),
+  mCreationTime(std::chrono::steady_clock::now())
+{
+    if (cardResourceProfileNames.empty()) {
+        throw IllegalArgumentException("The pool must contain at least one card resource profile");
+    }
+
+    for (const auto& cardResourceProfileName : cardResourceProfileNames) {
+        Member member;
+        member.cardResourceProfileName = cardResourceProfileName;
+        mMembers.push_back(member);
+    }
+}
+
+CardResourcePool::CardResourcePool(
+  const std::vector<std::shared_ptr<CardResourceLease>>& cardResourceLeases,
+  const AllocationPolicy allocationPolicy)
+: mCardResourceService(nullptr),
+  mAllocationPolicy(allocationPolicy),
+  mNextIndex(0),
+  mReleaseCount(0),
+  mCreationTime(std::chrono::steady_clock::now())
+{
+    if (cardResourceLeases.empty()) {
+        throw IllegalArgumentException("The pool must contain at least one card resource lease");
+    }
+
+    for (const auto& cardResourceLease : cardResourceLeases) {
+        Member member;
+        member.cardResourceProfileName = cardResourceLease->getCardResourceProfileName();
+        member.cardResourceLease = cardResourceLease;
+        mMembers.push_back(member);
+    }
+}
+
+bool CardResourcePool::isUsable(const size_t index) const
+{
+    const std::shared_ptr<CardResourceLease>& cardResourceLease = mMembers[index].cardResourceLease;
+
+    return cardResourceLease == nullptr || !cardResourceLease->isReleased();
+}
+
+size_t CardResourcePool::getLeastOutstandingWorkIndex() const
+{
+    size_t leastIndex = mMembers.size();
+
+    for (size_t i = 0; i < mMembers.size(); i++) {
+        if (!isUsable(i)) {
+            continue;
+        }
+
+        if (leastIndex == mMembers.size()) {
+            leastIndex = i;
+            continue;
+        }
+
+        const Member& member = mMembers[i];
+        const Member& least = mMembers[leastIndex];
+        if (member.outstandingWorkUnits < least.outstandingWorkUnits ||
+            (member.outstandingWorkUnits == least.outstandingWorkUnits &&
+             member.lastReleaseTime < least.lastReleaseTime)) {
+            leastIndex = i;
+        }
+    }
+
+    return leastIndex;
+}
+
+std::vector<size_t> CardResourcePool::getCandidates()
+{
+    std::vector<size_t> candidates;
+
+    /* Available members, in round-robin order */
+    for (size_t i = 0; i < mMembers.size(); i++) {
+        const size_t index = (mNextIndex + i) % mMembers.size();
+        if (!mMembers[index].isAllocated && !mMembers[index].isAllocating && isUsable(index)) {
+            candidates.push_back(index);
+        }
+    }
+
+    switch (mAllocationPolicy) {
+    case AllocationPolicy::LEAST_RECENTLY_USED:
+        std::stable_sort(candidates.begin(),
+                         candidates.end(),
+                         [this](const size_t a, const size_t b) {
+                             return mMembers[a].lastReleaseTime < mMembers[b].lastReleaseTime;
+                         });
+        break;
+
+    case AllocationPolicy::STICKY_PER_THREAD:
+        {
+        const auto it = mStickyIndexes.find(std::this_thread::get_id());
+        if (it != mStickyIndexes.end()) {
+            const auto preferred = std::find(candidates.begin(), candidates.end(), it->second);
+            if (preferred != candidates.end()) {
+                std::rotate(candidates.begin(), preferred, preferred + 1);
+            }
+        }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return candidates;
+}
+
+std::shared_ptr<CardResource> CardResourcePool::tryAllocate(const size_t index,
+                                                            const int workUnits,
+                                                            std::unique_lock<std::mutex>& lock)
+{
+    Member& member = mMembers[index];
+
+    /*
+     * The member is reserved while the lock is released, so that the card resource service is
+     * never called with the lock held.
+     */
+    member.isAllocating = true;
+    const std::shared_ptr<CardResourceLease> cardResourceLease = member.cardResourceLease;
+    const std::string cardResourceProfileName = member.cardResourceProfileName;
+    lock.unlock();
+
+    std::shared_ptr<CardResource> cardResource = nullptr;
+    try {
+        /*
+         * A leased card resource is already allocated, with its card selected, unless the lease
+         * has been invalidated by the removal of the card.
+         */
+        if (cardResourceLease == nullptr) {
+            cardResource = mCardResourceService->getCardResource(cardResourceProfileName);
+        } else if (!cardResourceLease->isReleased()) {
+            cardResource = cardResourceLease->getCardResource();
+        }
+    } catch (...) {
+        lock.lock();
+        member.isAllocating = false;
+        throw;
+    }
+
+    lock.lock();
+    member.isAllocating = false;
+
+    if (cardResource == nullptr) {
+        return nullptr;
+    }
+
+    member.isAllocated = true;
+    member.allocationTime = std::chrono::steady_clock::now();
+    member.allocatedWorkUnits = workUnits;
+    member.allocationCount++;
+    mAllocatedIndexes[cardResource.get()] = index;
+    mNextIndex = (index + 1) % mMembers.size();
+
+    if (mAllocationPolicy == AllocationPolicy::STICKY_PER_THREAD) {
+        /* The first member obtained by a thread becomes its preferred one */
+        mStickyIndexes.insert(std::make_pair(std::this_thread::get_id(), index));
+    }
+
+    return cardResource;
+}
+
+std::shared_ptr<CardResource> CardResourcePool::getCardResource(const long timeoutMs,
+                                                                const int workUnits)
+{
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    /*
+     * LEAST_OUTSTANDING_WORK: the caller is assigned a usable member at once and waits for it, the
+     * least recently used member being preferred in case of equality.
+     */
+    const bool isAssigned = mAllocationPolicy == AllocationPolicy::LEAST_OUTSTANDING_WORK;
+    size_t assignedIndex = mMembers.size();
+
+    std::shared_ptr<CardResource> cardResource = nullptr;
+
+    while (true) {
+        const uint64_t releaseCount = mReleaseCount;
+
+        if (isAssigned) {
+            /* Assign another member if the assigned one became unusable meanwhile */
+            if (assignedIndex == mMembers.size() || !isUsable(assignedIndex)) {
+                if (assignedIndex != mMembers.size()) {
+                    mMembers[assignedIndex].outstandingWorkUnits -= workUnits;
+                }
+                assignedIndex = getLeastOutstandingWorkIndex();
+                if (assignedIndex == mMembers.size()) {
+                    mLogger->error("No usable card resource left in the pool\n");
+                    break;
+                }
+                mMembers[assignedIndex].outstandingWorkUnits += workUnits;
+            }
+
+            if (!mMembers[assignedIndex].isAllocated && !mMembers[assignedIndex].isAllocating) {
+                cardResource = tryAllocate(assignedIndex, workUnits, lock);
+            }
+        } else {
+            for (const size_t index : getCandidates()) {
+                /* The member may have been taken while the lock was released */
+                if (mMembers[index].isAllocated || mMembers[index].isAllocating) {
+                    continue;
+                }
+                cardResource = tryAllocate(index, workUnits, lock);
+                if (cardResource != nullptr) {
+                    mMembers[index].outstandingWorkUnits += workUnits;
+                    break;
+                }
+            }
+        }
+
+        if (cardResource != nullptr) {
+            break;
+        }
+
+        /* A member was released during the attempts, retry at once */
+        if (mReleaseCount != releaseCount) {
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            if (isAssigned) {
+                mMembers[assignedIndex].outstandingWorkUnits -= workUnits;
+            }
+            mLogger->debug("No card resource available in the pool within % ms\n", timeoutMs);
+            break;
+        }
+
+        mCondition.wait_until(
+            lock, std::min(deadline, now + std::chrono::milliseconds(RECHECK_INTERVAL_MS)));
+    }
+
+    return cardResource;
+}
+
+void CardResourcePool::releaseCardResource(std::shared_ptr<CardResource> cardResource)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    const auto it = mAllocatedIndexes.find(cardResource.get());
+    if (it == mAllocatedIndexes.end()) {
+        mLogger->error("The card resource does not belong to the pool, not released\n");
+        return;
+    }
+
+    /* The member stays allocated until the card resource service has released it */
+    const size_t index = it->second;
+    mAllocatedIndexes.erase(it);
+
+    /* A leased card resource stays allocated with the card resource service */
+    if (mCardResourceService != nullptr) {
+        lock.unlock();
+        try {
+            mCardResourceService->releaseCardResource(cardResource);
+        } catch (const Exception& e) {
+            mLogger->error("Unable to release the card resource: '%'\n", e.getMessage());
+        }
+        lock.lock();
+    }
+
+    Member& member = mMembers[index];
+    const auto now = std::chrono::steady_clock::now();
+    member.isAllocated = false;
+    member.lastReleaseTime = now;
+    member.busyTime += now - member.allocationTime;
+    member.outstandingWorkUnits -= member.allocatedWorkUnits;
+    mReleaseCount++;
+    lock.unlock();
+
+    mCondition.notify_all();
+}
+
+uint64_t CardResourcePool::getAllocationCount(const std::string& cardResourceProfileName)
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    for (const auto& member : mMembers) {
+        if (member.cardResourceProfileName == cardResourceProfileName) {
+            return member.allocationCount;
+        }
+    }
+
+    return 0;
+}
+
+void CardResourcePool::logUtilisation()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto elapsed = std::chrono::steady_clock::now() - mCreationTime;
+
+    for (const auto& member : mMembers) {
+        const long long busyMs =
+            std::chrono::duration_cast<std::chrono::milliseconds>(member.busyTime).count();
+        const long long elapsedMs =
+            std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+
+        mLogger->info("Card resource profile '%': % allocations, busy % ms, " \
+                      "utilisation % per cent\n",
+                      member.cardResourceProfileName,
+                      member.allocationCount,
+                      busyMs,
+                      elapsedMs == 0 ? 0 : busyMs * 100 / elapsedMs);
+    }
+}
@@ -0,0 +1,226 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+#include "CardResourceService.h"
+
+/* Examples */
+#include "CardResourceLease.h"
+
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Pool of equivalent card resources (e.g. several SAM C1 readers of a ticket office server)
+ * spreading the allocations according to a selectable policy.
+ *
+ * <p>The card resource service allocates the first available card resource of a profile. To let
+ * the pool choose, each member of the pool is a card resource profile matching a single reader
+ * (see ConfigurationUtil::setupCardResourceServiceForEachReader), the card resource service being
+ * configured in non-blocking allocation mode.
+ *
+ * <p>The members can also be leased card resources (see CardResourceLease), kept allocated with
+ * the card resource service for the lifetime of the pool: the pool then hands them out without
+ * involving the card resource service, hence without selecting the card again. A member whose
+ * lease has been invalidated (card removed) is no longer handed out.
+ *
+ * <p>The allocation and busy time of each member are counted to check the load spreading.
+ */
+class CardResourcePool final {
+public:
+    /**
+     * Allocation policy.
+     */
+    enum class AllocationPolicy {
+        /** The available members are taken in turn. */
+        ROUND_ROBIN,
+        /** The available member released for the longest time is taken. */
+        LEAST_RECENTLY_USED,
+        /**
+         * The caller is assigned, and waits for, the usable member having the least work in
+         * progress or waiting (as declared by the callers), and is assigned another one if its
+         * member becomes unusable (lease invalidated).
+         */
+        LEAST_OUTSTANDING_WORK,
+        /** A thread always takes the same member when available, another one otherwise. */
+        STICKY_PER_THREAD
+    };
+
+    /**
+     * Period of the re-check of the members becoming available without a release through the
+     * pool, in milliseconds.
+     */
+    static const long RECHECK_INTERVAL_MS;
+
+    /**
+     * Constructor.
+     *
+     * @param cardResourceService The card resource service, configured in non-blocking allocation
+     *        mode.
+     * @param cardResourceProfileNames The card resource profiles of the members of the pool.
+     * @param allocationPolicy The allocation policy.
+     */
+    CardResourcePool(std::shared_ptr<CardResourceService> cardResourceService,
+                     const std::vector<std::string>& cardResourceProfileNames,
+                     const AllocationPolicy allocationPolicy);
+
+    /**
+     * Constructor of a pool of leased card resources.
+     *
+     * @param cardResourceLeases The leases of the card resources of the members of the pool.
+     * @param allocationPolicy The allocation policy.
+     */
+    CardResourcePool(const std::vector<std::shared_ptr<CardResourceLease>>& cardResourceLeases,
+                     const AllocationPolicy allocationPolicy);
+
+    /**
+     * Gets a card resource from the pool, waiting for it if none is available.
+     *
+     * @param timeoutMs The maximum waiting time in milliseconds.
+     * @param workUnits The amount of work planned with the card resource (used by the
+     *        LEAST_OUTSTANDING_WORK policy).
+     * @return Null if no card resource became available within the timeout, or if no member is
+     *         usable any more.
+     */
+    std::shared_ptr<CardResource> getCardResource(const long timeoutMs, const int workUnits = 1);
+
+    /**
+     * Releases a card resource obtained from the pool.
+     *
+     * @param cardResource The card resource.
+     */
+    void releaseCardResource(std::shared_ptr<CardResource> cardResource);
+
+    /**
+     * @param cardResourceProfileName The card resource profile of a member.
+     * @return The number of allocations of the member.
+     */
+    uint64_t getAllocationCount(const std::string& cardResourceProfileName);
+
+    /**
+     * Logs the number of allocations, the busy time and the utilisation rate of each member.
+     */
+    void logUtilisation();
+
+private:
+    /**
+     * Member of the pool.
+     */
+    struct Member {
+        std::string cardResourceProfileName;
+        std::shared_ptr<CardResourceLease> cardResourceLease;
+        bool isAllocated = false;
+        bool isAllocating = false;
+        int outstandingWorkUnits = 0;
+        std::chrono::steady_clock::time_point lastReleaseTime;
+        std::chrono::steady_clock::time_point allocationTime;
+        int allocatedWorkUnits = 0;
+        uint64_t allocationCount = 0;
+        std::chrono::steady_clock::duration busyTime = std::chrono::steady_clock::duration::zero();
+    };
+
+    /**
+     * Returns false if the member is a lease which has been invalidated (mutex held).
+     */
+    bool isUsable(const size_t index) const;
+
+    /**
+     * Returns the index of the usable member having the least outstanding work, the least
+     * recently used one in case of equality, or the number of members if none is usable (mutex
+     * held).
+     */
+    size_t getLeastOutstandingWorkIndex() const;
+
+    /**
+     * Returns the indexes of the members to try, in order of preference (mutex held).
+     */
+    std::vector<size_t> getCandidates();
+
+    /**
+     * Tries to allocate the card resource of a member, the lock being released during the call to
+     * the card resource service (or to the lease).
+     */
+    std::shared_ptr<CardResource> tryAllocate(const size_t index,
+                                              const int workUnits,
+                                              std::unique_lock<std::mutex>& lock);
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(CardResourcePool));
+
+    /**
+     * Null for a pool of leased card resources.
+     */
+    std::shared_ptr<CardResourceService> mCardResourceService;
+
+    /**
+     *
+     */
+    const AllocationPolicy mAllocationPolicy;
+
+    /**
+     *
+     */
+    std::vector<Member> mMembers;
+
+    /**
+     * Next member for the ROUND_ROBIN policy (and the fallback of STICKY_PER_THREAD).
+     */
+    size_t mNextIndex;
+
+    /**
+     * Preferred member of each thread for the STICKY_PER_THREAD policy.
+     */
+    std::map<std::thread::id, size_t> mStickyIndexes;
+
+    /**
+     * Member of each allocated card resource.
+     */
+    std::map<CardResource*, size_t> mAllocatedIndexes;
+
+    /**
+     * Incremented on each release, to detect the releases happening during an allocation attempt.
+     */
+    uint64_t mReleaseCount;
+
+    /**
+     *
+     */
+    const std::chrono::steady_clock::time_point mCreationTime;
+
+    /**
+     *
+     */
+    std::mutex mMutex;
+
+    /**
+     *
+     */
+    std::condition_variable mCondition;
+};
@@ -0,0 +1,250 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "CardResourceServiceMetrics.h"
+
+#include <algorithm>
+
+/* Keyple Core Util */
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+/* HISTOGRAM ------------------------------------------------------------------------------------ */
+
+const std::vector<long long> CardResourceServiceMetrics::Histogram::BUCKET_UPPER_BOUNDS_US = {
+    100, 1000, 5000, 10000, 50000, 100000, 500000, 1000000, 5000000, 10000000};
+
+CardResourceServiceMetrics::Histogram::Histogram()
+: mBucketCounts(BUCKET_UPPER_BOUNDS_US.size() + 1, 0), mCount(0), mTotalUs(0), mMaxUs(0) {}
+
+void CardResourceServiceMetrics::Histogram::record(const long long durationUs)
+{
+    const size_t bucket =
+        std::lower_bound(BUCKET_UPPER_BOUNDS_US.begin(), BUCKET_UPPER_BOUNDS_US.end(), durationUs) -
+        BUCKET_UPPER_BOUNDS_US.begin();
+
+    mBucketCounts[bucket]++;
+    mCount++;
+    mTotalUs += durationUs;
+    mMaxUs = std::max(mMaxUs, durationUs);
+}
+
+uint64_t CardResourceServiceMetrics::Histogram::getCount() const
+{
+    return mCount;
+}
+
+long long CardResourceServiceMetrics::Histogram::getMeanUs() const
+{
+    return mCount == 0 ? 0 : mTotalUs / static_cast<long long>(mCount);
+}
+
+long long CardResourceServiceMetrics::Histogram::getMaxUs() const
+{
+    return mMaxUs;
+}
+
+long long CardResourceServiceMetrics::Histogram::getPercentileUs(const int p) const
+{
+    if (mCount == 0) {
+        return 0;
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, (p * mCount + 99) / 100);
+    uint64_t cumulatedCount = 0;
+
+    for (size_t i = 0; i < BUCKET_UPPER_BOUNDS_US.size(); i++) {
+        cumulatedCount += mBucketCounts[i];
+        if (cumulatedCount >= rank) {
+            return std::min(BUCKET_UPPER_BOUNDS_US[i], mMaxUs);
+        }
+    }
+
+    return mMaxUs;
+}
+
+const std::vector<uint64_t>& CardResourceServiceMetrics::Histogram::getBucketCounts() const
+{
+    return mBucketCounts;
+}
+
+/* CARD RESOURCE SERVICE METRICS ---------------------------------------------------------------- */
+
+CardResourceServiceMetrics::CardResourceServiceMetrics()
+: mCreationTime(std::chrono::steady_clock::now()), mIsDumpRunning(false) {}
+
+CardResourceServiceMetrics::~CardResourceServiceMetrics()
+{
+    stopPeriodicDump();
+}
+
+void CardResourceServiceMetrics::onAllocation(const std::string& cardResourceProfileName,
+                                              std::shared_ptr<CardResource> cardResource,
+                                              const long long waitTimeUs)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const std::string readerName = cardResource->getReader()->getName();
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    ProfileMetrics& profile = mProfiles[cardResourceProfileName];
+    profile.allocationCount++;
+    profile.waitTime.record(waitTimeUs);
+
+    /* Still held by a previous caller: the service took it back after the usage timeout */
+    const auto it = mAllocations.find(cardResource.get());
+    if (it != mAllocations.end()) {
+        ProfileMetrics& evictedProfile = mProfiles[it->second.cardResourceProfileName];
+        evictedProfile.usageTimeoutEvictionCount++;
+        evictedProfile.holdTime.record(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                now - it->second.allocationTime).count());
+        evictedProfile.allocatedCount--;
+        mAllocations.erase(it);
+    }
+
+    Allocation allocation;
+    allocation.cardResourceProfileName = cardResourceProfileName;
+    allocation.allocationTime = now;
+    mAllocations[cardResource.get()] = allocation;
+    profile.allocatedCount++;
+
+    /* A new card resource provided by a known reader means a new selection of a card */
+    std::set<std::string>& readerNames = mReaderNames[cardResourceProfileName];
+    if (readerNames.insert(readerName).second) {
+        profile.knownResourceCount++;
+    }
+
+    const auto readerIt = mReaderCardResources.find(readerName);
+    if (readerIt == mReaderCardResources.end()) {
+        mReaderCardResources[readerName] = cardResource;
+    } else if (readerIt->second.lock() != cardResource) {
+        profile.reselectionCount++;
+        readerIt->second = cardResource;
+    }
+}
+
+void CardResourceServiceMetrics::onAllocationFailure(const std::string& cardResourceProfileName,
+                                                     const long long waitTimeUs)
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    ProfileMetrics& profile = mProfiles[cardResourceProfileName];
+    profile.allocationFailureCount++;
+    profile.waitTime.record(waitTimeUs);
+}
+
+void CardResourceServiceMetrics::onRelease(std::shared_ptr<CardResource> cardResource)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    /* Unknown when already evicted and allocated to another caller */
+    const auto it = mAllocations.find(cardResource.get());
+    if (it == mAllocations.end()) {
+        return;
+    }
+
+    ProfileMetrics& profile = mProfiles[it->second.cardResourceProfileName];
+    profile.holdTime.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            now - it->second.allocationTime).count());
+    profile.allocatedCount--;
+    mAllocations.erase(it);
+}
+
+CardResourceServiceMetrics::Snapshot CardResourceServiceMetrics::getSnapshot()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    Snapshot snapshot;
+    snapshot.uptimeMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - mCreationTime).count();
+    snapshot.profiles = mProfiles;
+
+    return snapshot;
+}
+
+void CardResourceServiceMetrics::logSnapshot()
+{
+    const Snapshot snapshot = getSnapshot();
+
+    mLogger->info("Card resource service metrics (uptime % ms)\n", snapshot.uptimeMs);
+
+    for (const auto& entry : snapshot.profiles) {
+        const ProfileMetrics& profile = entry.second;
+
+        mLogger->info("Profile '%': allocations %, failures %, allocated %, available %, " \
+                      "usage timeout evictions %, re-selections %\n",
+                      entry.first,
+                      profile.allocationCount,
+                      profile.allocationFailureCount,
+                      profile.allocatedCount,
+                      std::max(0, profile.knownResourceCount - profile.allocatedCount),
+                      profile.usageTimeoutEvictionCount,
+                      profile.reselectionCount);
+        mLogger->info("Profile '%': wait time mean % us, p50 % us, p99 % us, max % us\n",
+                      entry.first,
+                      profile.waitTime.getMeanUs(),
+                      profile.waitTime.getPercentileUs(50),
+                      profile.waitTime.getPercentileUs(99),
+                      profile.waitTime.getMaxUs());
+        mLogger->info("Profile '%': hold time mean % us, p50 % us, p99 % us, max % us\n",
+                      entry.first,
+                      profile.holdTime.getMeanUs(),
+                      profile.holdTime.getPercentileUs(50),
+                      profile.holdTime.getPercentileUs(99),
+                      profile.holdTime.getMaxUs());
+    }
+}
+
+void CardResourceServiceMetrics::startPeriodicDump(const long periodMs)
+{
+    std::unique_lock<std::mutex> lock(mDumpMutex);
+
+    if (mIsDumpRunning) {
+        throw IllegalStateException("The periodic dump of the metrics is already started");
+    }
+
+    mIsDumpRunning = true;
+
+    mDumpThread = std::thread([this, periodMs]() {
+        std::unique_lock<std::mutex> dumpLock(mDumpMutex);
+
+        while (!mDumpCondition.wait_for(dumpLock,
+                                        std::chrono::milliseconds(periodMs),
+                                        [this]() { return !mIsDumpRunning; })) {
+            dumpLock.unlock();
+            logSnapshot();
+            dumpLock.lock();
+        }
+    });
+}
+
+void CardResourceServiceMetrics::stopPeriodicDump()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mDumpMutex);
+
+        if (!mIsDumpRunning) {
+            return;
+        }
+
+        mIsDumpRunning = false;
+    }
+
+    mDumpCondition.notify_all();
+    mDumpThread.join();
+}
@@ -0,0 +1,272 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+
+using namespace keyple::core::service::resource;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Metrics of the allocations of card resources, fed by the application layer calling the card
+ * resource service (see CardResourceAllocator), the service itself not exposing any.
+ *
+ * <p>For each card resource profile are measured:
+ *
+ * <ul>
+ *   <li>the time waited for a card resource and the time it was held until its release
+ *       (histograms),
+ *   <li>the evictions of a card resource by the usage timeout of the service, detected when a card
+ *       resource is allocated while its previous holder has not released it,
+ *   <li>the re-selections of a card, detected when a reader provides a new card resource (the card
+ *       having been removed and inserted again, or replaced),
+ *   <li>the card resources allocated and available, among the ones seen so far.
+ * </ul>
+ *
+ * <p>The metrics are exposed as a snapshot and can be dumped periodically to the log.
+ */
+class CardResourceServiceMetrics final {
+public:
+    /**
+     * Histogram of durations, with fixed buckets.
+     */
+    class Histogram final {
+    public:
+        /**
+         * Upper bounds of the buckets in microseconds, a last bucket holding the longer durations.
+         */
+        static const std::vector<long long> BUCKET_UPPER_BOUNDS_US;
+
+        /**
+         * Constructor.
+         */
+        Histogram();
+
+        /**
+         * Records a duration.
+         *
+         * @param durationUs The duration in microseconds.
+         */
+        void record(const long long durationUs);
+
+        /**
+         * @return The number of durations recorded.
+         */
+        uint64_t getCount() const;
+
+        /**
+         * @return The mean duration in microseconds, 0 if none recorded.
+         */
+        long long getMeanUs() const;
+
+        /**
+         * @return The maximum duration in microseconds.
+         */
+        long long getMaxUs() const;
+
+        /**
+         * @param p The percentile (0 to 100).
+         * @return The upper bound of the bucket holding the p-th percentile (the maximum for the last
+         *         bucket), in microseconds.
+         */
+        long long getPercentileUs(const int p) const;
+
+        /**
+         * @return The number of durations of each bucket.
+         */
+        const std::vector<uint64_t>& getBucketCounts() const;
+
+    private:
+        /**
+         *
+         */
+        std::vector<uint64_t> mBucketCounts;
+
+        /**
+         *
+         */
+        uint64_t mCount;
+
+        /**
+         *
+         */
+        long long mTotalUs;
+
+        /**
+         *
+         */
+        long long mMaxUs;
+    };
+
+    /**
+     * Metrics of a card resource profile.
+     */
+    struct ProfileMetrics {
+        uint64_t allocationCount = 0;
+        uint64_t allocationFailureCount = 0;
+        Histogram waitTime;
+        Histogram holdTime;
+        uint64_t usageTimeoutEvictionCount = 0;
+        uint64_t reselectionCount = 0;
+        int allocatedCount = 0;
+        int knownResourceCount = 0;
+    };
+
+    /**
+     * Snapshot of the metrics.
+     */
+    struct Snapshot {
+        long long uptimeMs = 0;
+        std::map<std::string, ProfileMetrics> profiles;
+    };
+
+    /**
+     * Constructor.
+     */
+    CardResourceServiceMetrics();
+
+    /**
+     * Stops the periodic dump if started.
+     */
+    ~CardResourceServiceMetrics();
+
+    /**
+     * Records the allocation of a card resource.
+     *
+     * @param cardResourceProfileName The card resource profile.
+     * @param cardResource The card resource allocated.
+     * @param waitTimeUs The time waited for the card resource, in microseconds.
+     */
+    void onAllocation(const std::string& cardResourceProfileName,
+                      std::shared_ptr<CardResource> cardResource,
+                      const long long waitTimeUs);
+
+    /**
+     * Records an allocation failed (no card resource available in time).
+     *
+     * @param cardResourceProfileName The card resource profile.
+     * @param waitTimeUs The time waited, in microseconds.
+     */
+    void onAllocationFailure(const std::string& cardResourceProfileName,
+                             const long long waitTimeUs);
+
+    /**
+     * Records the release of a card resource.
+     *
+     * @param cardResource The card resource released.
+     */
+    void onRelease(std::shared_ptr<CardResource> cardResource);
+
+    /**
+     * @return A snapshot of the metrics.
+     */
+    Snapshot getSnapshot();
+
+    /**
+     * Logs a snapshot of the metrics.
+     */
+    void logSnapshot();
+
+    /**
+     * Starts logging a snapshot of the metrics periodically, in a dedicated thread.
+     *
+     * @param periodMs The period in milliseconds.
+     * @throw IllegalStateException If the periodic dump is already started.
+     */
+    void startPeriodicDump(const long periodMs);
+
+    /**
+     * Stops the periodic dump (no effect if not started).
+     */
+    void stopPeriodicDump();
+
+private:
+    /**
+     * Card resource allocated.
+     */
+    struct Allocation {
+        std::string cardResourceProfileName;
+        std::chrono::steady_clock::time_point allocationTime;
+    };
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger =
+        LoggerFactory::getLogger(typeid(CardResourceServiceMetrics));
+
+    /**
+     *
+     */
+    const std::chrono::steady_clock::time_point mCreationTime;
+
+    /**
+     *
+     */
+    std::map<std::string, ProfileMetrics> mProfiles;
+
+    /**
+     * Readers seen for each profile.
+     */
+    std::map<std::string, std::set<std::string>> mReaderNames;
+
+    /**
+     * Last card resource provided by each reader.
+     */
+    std::map<std::string, std::weak_ptr<CardResource>> mReaderCardResources;
+
+    /**
+     *
+     */
+    std::map<CardResource*, Allocation> mAllocations;
+
+    /**
+     *
+     */
+    std::mutex mMutex;
+
+    /**
+     *
+     */
+    std::thread mDumpThread;
+
+    /**
+     *
+     */
+    bool mIsDumpRunning;
+
+    /**
+     *
+     */
+    std::mutex mDumpMutex;
+
+    /**
+     *
+     */
+    std::condition_variable mDumpCondition;
+};
@@ -0,0 +1,373 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "CardResourceServiceStarter.h"
+
+#include <algorithm>
+
+/* Calypsonet Terminal Reader */
+#include "ObservableCardReader.h"
+
+/* Keyple Core Service */
+#include "ObservablePlugin.h"
+
+/* Keyple Core Util */
+#include "Exception.h"
+#include "IllegalArgumentException.h"
+#include "IllegalStateException.h"
+
+using namespace keyple::core::util::cpp::exception;
+
+const int CardResourceServiceStarter::EVENT_CHECK_COUNT = 5;
+const long CardResourceServiceStarter::EVENT_CHECK_INTERVAL_MS = 100;
+
+/* EVENT OBSERVER ------------------------------------------------------------------------------- */
+
+CardResourceServiceStarter::EventObserver::EventObserver(CardResourceServiceStarter& starter)
+: mStarter(starter) {}
+
+void CardResourceServiceStarter::EventObserver::onPluginEvent(
+    const std::shared_ptr<PluginEvent> pluginEvent)
+{
+    if (pluginEvent->getType() != PluginEvent::Type::READER_CONNECTED) {
+        return;
+    }
+
+    for (const auto& plugin : mStarter.mPlugins) {
+        if (plugin->getName() != pluginEvent->getPluginName()) {
+            continue;
+        }
+
+        /* The card of a new reader is reported by the reader itself */
+        for (const auto& readerName : pluginEvent->getReaderNames()) {
+            mStarter.observeReader(plugin->getReader(readerName));
+        }
+    }
+
+    mStarter.requestCheck();
+}
+
+void CardResourceServiceStarter::EventObserver::onReaderEvent(
+    const std::shared_ptr<CardReaderEvent> event)
+{
+    if (event->getType() == CardReaderEvent::Type::CARD_INSERTED ||
+        event->getType() == CardReaderEvent::Type::CARD_MATCHED) {
+        mStarter.requestCheck();
+    }
+}
+
+/* CARD RESOURCE SERVICE STARTER ---------------------------------------------------------------- */
+
+CardResourceServiceStarter::CardResourceServiceStarter(
+  std::shared_ptr<CardResourceService> cardResourceService,
+  std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+  const std::vector<std::shared_ptr<Plugin>>& plugins,
+  const std::vector<std::string>& cardResourceProfileNames)
+: mCardResourceService(cardResourceService),
+  mCardResourceAllocator(cardResourceAllocator),
+  mPlugins(plugins),
+  mCardResourceProfileNames(cardResourceProfileNames),
+  mIsStartRequested(false),
+  mIsStarted(false),
+  mPendingCheckCount(0),
+  mIsStopping(false)
+{
+    mEventObserver = std::make_shared<EventObserver>(*this);
+}
+
+CardResourceServiceStarter::~CardResourceServiceStarter()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+
+    mCondition.notify_all();
+
+    if (mStartThread.joinable()) {
+        mStartThread.join();
+    }
+}
+
+void CardResourceServiceStarter::startAsync()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mIsStartRequested) {
+        throw IllegalStateException("The start of the card resource service is already requested");
+    }
+
+    mIsStartRequested = true;
+    mStartRequestTime = std::chrono::steady_clock::now();
+
+    mStartThread = std::thread([this]() {
+        try {
+            mCardResourceService->start();
+
+        } catch (const Exception& e) {
+            mLogger->error("Unable to start the card resource service\n", e);
+            return;
+        }
+
+        {
+            const std::lock_guard<std::mutex> startLock(mMutex);
+
+            mIsStarted = true;
+            mStartTime = std::chrono::steady_clock::now();
+            mLogger->info("Card resource service started in % ms\n", getElapsedMs(mStartTime));
+
+            /* The start has selected the cards present, a single check is enough */
+            mPendingCheckCount = 1;
+        }
+
+        mCondition.notify_all();
+
+        /* The monitoring of the plugins and readers is set up by the start of the service */
+        observePlugins();
+        checkReadiness();
+        stopObservation();
+    });
+}
+
+void CardResourceServiceStarter::observePlugins()
+{
+    for (const auto& plugin : mPlugins) {
+        auto observablePlugin = std::dynamic_pointer_cast<ObservablePlugin>(plugin);
+        if (observablePlugin != nullptr) {
+            try {
+                observablePlugin->addObserver(mEventObserver);
+
+            } catch (const Exception& e) {
+                mLogger->debug("Plugin '%' not observed\n", plugin->getName(), e);
+            }
+        }
+
+        for (const auto& reader : plugin->getReaders()) {
+            observeReader(reader);
+        }
+    }
+}
+
+void CardResourceServiceStarter::observeReader(std::shared_ptr<CardReader> reader)
+{
+    auto observableReader = std::dynamic_pointer_cast<ObservableCardReader>(reader);
+    if (observableReader == nullptr) {
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mIsStopping || mObservedReaders.count(reader->getName()) != 0) {
+            return;
+        }
+        mObservedReaders[reader->getName()] = reader;
+    }
+
+    try {
+        observableReader->addObserver(mEventObserver);
+
+    } catch (const Exception& e) {
+        mLogger->debug("Reader '%' not observed\n", reader->getName(), e);
+    }
+}
+
+void CardResourceServiceStarter::stopObservation()
+{
+    std::map<std::string, std::shared_ptr<CardReader>> observedReaders;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        /* No reader is observed anymore from now */
+        mIsStopping = true;
+        observedReaders.swap(mObservedReaders);
+    }
+
+    for (const auto& entry : observedReaders) {
+        try {
+            std::dynamic_pointer_cast<ObservableCardReader>(entry.second)
+                ->removeObserver(mEventObserver);
+
+        } catch (const Exception& e) {
+            mLogger->debug("Unable to remove the observer of reader '%'\n", entry.first, e);
+        }
+    }
+
+    for (const auto& plugin : mPlugins) {
+        auto observablePlugin = std::dynamic_pointer_cast<ObservablePlugin>(plugin);
+        if (observablePlugin != nullptr) {
+            try {
+                observablePlugin->removeObserver(mEventObserver);
+
+            } catch (const Exception& e) {
+                mLogger->debug("Unable to remove the observer of plugin '%'\n",
+                               plugin->getName(),
+                               e);
+            }
+        }
+    }
+}
+
+void CardResourceServiceStarter::requestCheck()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mPendingCheckCount = EVENT_CHECK_COUNT;
+    }
+
+    mCondition.notify_all();
+}
+
+void CardResourceServiceStarter::checkReadiness()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mIsStopping && mReadinessTimes.size() < mCardResourceProfileNames.size()) {
+        /* Nothing to do until a reader is connected or a card is inserted */
+        if (mPendingCheckCount == 0) {
+            mCondition.wait(lock, [this]() { return mIsStopping || mPendingCheckCount > 0; });
+            continue;
+        }
+
+        mPendingCheckCount--;
+
+        std::vector<std::string> notReadyProfileNames;
+        for (const auto& cardResourceProfileName : mCardResourceProfileNames) {
+            if (mReadinessTimes.count(cardResourceProfileName) == 0) {
+                notReadyProfileNames.push_back(cardResourceProfileName);
+            }
+        }
+
+        lock.unlock();
+        std::vector<std::string> readyProfileNames;
+        for (const auto& cardResourceProfileName : notReadyProfileNames) {
+            try {
+                /* No waiting, the next check is triggered by an event */
+                std::shared_ptr<CardResource> cardResource =
+                    mCardResourceAllocator->getCardResource(cardResourceProfileName, 0);
+                if (cardResource != nullptr) {
+                    mCardResourceAllocator->releaseCardResource(cardResource);
+                    readyProfileNames.push_back(cardResourceProfileName);
+                }
+
+            } catch (const Exception& e) {
+                mLogger->debug("Card resource profile '%' not ready yet\n",
+                               cardResourceProfileName,
+                               e);
+            }
+        }
+        lock.lock();
+
+        for (const auto& cardResourceProfileName : readyProfileNames) {
+            mReadinessTimes[cardResourceProfileName] = std::chrono::steady_clock::now();
+            mLogger->info("Card resource profile '%' ready in % ms\n",
+                          cardResourceProfileName,
+                          getElapsedMs(mReadinessTimes[cardResourceProfileName]));
+        }
+
+        if (!readyProfileNames.empty()) {
+            lock.unlock();
+            mCondition.notify_all();
+            lock.lock();
+        }
+
+        /* Give the card resource service the time to process the event before the next check */
+        if (mPendingCheckCount > 0) {
+            mCondition.wait_for(lock,
+                                std::chrono::milliseconds(EVENT_CHECK_INTERVAL_MS),
+                                [this]() { return mIsStopping; });
+        }
+    }
+}
+
+bool CardResourceServiceStarter::waitForProfileReadiness(const std::string& cardResourceProfileName,
+                                                         const long timeoutMs)
+{
+    if (std::find(mCardResourceProfileNames.begin(),
+                  mCardResourceProfileNames.end(),
+                  cardResourceProfileName) == mCardResourceProfileNames.end()) {
+        throw IllegalArgumentException("Unknown card resource profile: " + cardResourceProfileName);
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    return mCondition.wait_for(lock,
+                               std::chrono::milliseconds(timeoutMs),
+                               [this, &cardResourceProfileName]() {
+                                   return mReadinessTimes.count(cardResourceProfileName) != 0;
+                               });
+}
+
+long long CardResourceServiceStarter::getElapsedMs(
+    const std::chrono::steady_clock::time_point timePoint) const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               timePoint - mStartRequestTime).count();
+}
+
+long long CardResourceServiceStarter::getTimeToStartMs()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mIsStarted ? getElapsedMs(mStartTime) : -1;
+}
+
+long long CardResourceServiceStarter::getTimeToFirstResourceMs()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mReadinessTimes.empty()) {
+        return -1;
+    }
+
+    auto firstReadinessTime = mReadinessTimes.begin()->second;
+    for (const auto& entry : mReadinessTimes) {
+        firstReadinessTime = std::min(firstReadinessTime, entry.second);
+    }
+
+    return getElapsedMs(firstReadinessTime);
+}
+
+long long CardResourceServiceStarter::getTimeToAllResourcesMs()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mCardResourceProfileNames.empty() ||
+        mReadinessTimes.size() < mCardResourceProfileNames.size()) {
+        return -1;
+    }
+
+    auto lastReadinessTime = mReadinessTimes.begin()->second;
+    for (const auto& entry : mReadinessTimes) {
+        lastReadinessTime = std::max(lastReadinessTime, entry.second);
+    }
+
+    return getElapsedMs(lastReadinessTime);
+}
+
+void CardResourceServiceStarter::logStartupTimes()
+{
+    mLogger->info("Card resource service startup: started in % ms, first resource in % ms, " \
+                  "all resources in % ms (-1: not reached yet)\n",
+                  getTimeToStartMs(),
+                  getTimeToFirstResourceMs(),
+                  getTimeToAllResourcesMs());
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    for (const auto& cardResourceProfileName : mCardResourceProfileNames) {
+        const auto it = mReadinessTimes.find(cardResourceProfileName);
+        mLogger->info("Card resource profile '%': % ms\n",
+                      cardResourceProfileName,
+                      it != mReadinessTimes.end() ? getElapsedMs(it->second) : -1);
+    }
+}
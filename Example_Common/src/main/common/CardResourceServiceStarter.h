@@ -0,0 +1,289 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "CardReaderEvent.h"
+#include "CardReaderObserverSpi.h"
+
+/* Keyple Core Service */
+#include "Plugin.h"
+#include "PluginEvent.h"
+#include "PluginObserverSpi.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResourceService.h"
+
+/* Examples */
+#include "CardResourceAllocator.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::spi;
+using namespace keyple::core::service;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::service::spi;
+using namespace keyple::core::util::cpp;
+
+/**
+ * Asynchronous start of a configured card resource service.
+ *
+ * <p>The start of the card resource service enumerates the readers and selects their cards
+ * synchronously. The starter runs it in the background, so that the application can go on with
+ * its own initialization, then checks, for each card resource profile, when a first card resource
+ * is available. A check is a non-waiting allocation through the CardResourceAllocator of the
+ * application, the card resource being released through it at once, so that the check is queued
+ * with the other callers of the profile and wakes them on release.
+ *
+ * <p>The availability is checked once at the end of the start, then only when the plugins or the
+ * readers notify a change (reader connection, card insertion), when they are monitored by the
+ * card resource service. As the card resource service processes the same event in its own
+ * observer, a check triggered by an event is repeated a few times before waiting for the next
+ * event. No check is done while nothing happens.
+ *
+ * <p>The readers are expected to be connected before startAsync, or to be notified by the
+ * monitoring of their plugin.
+ *
+ * <p>The callers needing a card resource wait for the readiness of its profile with
+ * waitForProfileReadiness before requesting it.
+ */
+class CardResourceServiceStarter final {
+public:
+    /**
+     * Number of checks triggered by an event.
+     */
+    static const int EVENT_CHECK_COUNT;
+
+    /**
+     * Delay between the checks triggered by an event, in milliseconds.
+     */
+    static const long EVENT_CHECK_INTERVAL_MS;
+
+    /**
+     * Constructor.
+     *
+     * @param cardResourceService The card resource service, configured but not started.
+     * @param cardResourceAllocator The allocator of the application, used by the readiness checks.
+     * @param plugins The plugins configured in the card resource service, observed when they are
+     *        observable.
+     * @param cardResourceProfileNames The card resource profiles whose readiness is checked.
+     */
+    CardResourceServiceStarter(std::shared_ptr<CardResourceService> cardResourceService,
+                               std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                               const std::vector<std::shared_ptr<Plugin>>& plugins,
+                               const std::vector<std::string>& cardResourceProfileNames);
+
+    /**
+     * Stops the readiness checks in progress and waits for the end of the start.
+     */
+    ~CardResourceServiceStarter();
+
+    /**
+     * Starts the card resource service in the background and returns immediately.
+     *
+     * @throw IllegalStateException If already called.
+     */
+    void startAsync();
+
+    /**
+     * Waits for a card resource profile to be ready, i.e. to have provided a first card resource.
+     *
+     * @param cardResourceProfileName The card resource profile.
+     * @param timeoutMs The maximum waiting time in milliseconds.
+     * @return False if the profile did not become ready within the timeout.
+     * @throw IllegalArgumentException If the profile is not known by the starter.
+     */
+    bool waitForProfileReadiness(const std::string& cardResourceProfileName, const long timeoutMs);
+
+    /**
+     * @return The time from startAsync to the end of the start of the service, in milliseconds, -1
+     *         if not reached yet.
+     */
+    long long getTimeToStartMs();
+
+    /**
+     * @return The time from startAsync to the readiness of the first profile, in milliseconds, -1
+     *         if not reached yet.
+     */
+    long long getTimeToFirstResourceMs();
+
+    /**
+     * @return The time from startAsync to the readiness of all the profiles, in milliseconds, -1
+     *         if not reached yet.
+     */
+    long long getTimeToAllResourcesMs();
+
+    /**
+     * Logs the startup times, and the readiness time of each profile.
+     */
+    void logStartupTimes();
+
+private:
+    /**
+     * Observer of the plugins and of the readers, requesting a check of the readiness on a reader
+     * connection or a card insertion.
+     */
+    class EventObserver final : public PluginObserverSpi, public CardReaderObserverSpi {
+    public:
+        /**
+         *
+         */
+        explicit EventObserver(CardResourceServiceStarter& starter);
+
+        /**
+         * {@inheritDoc}
+         */
+        void onPluginEvent(const std::shared_ptr<PluginEvent> pluginEvent) override;
+
+        /**
+         * {@inheritDoc}
+         */
+        void onReaderEvent(const std::shared_ptr<CardReaderEvent> event) override;
+
+    private:
+        /**
+         *
+         */
+        CardResourceServiceStarter& mStarter;
+    };
+
+    /**
+     * Adds the event observer to the observable plugins and to their observable readers.
+     */
+    void observePlugins();
+
+    /**
+     * Adds the event observer to a reader if observable.
+     */
+    void observeReader(std::shared_ptr<CardReader> reader);
+
+    /**
+     * Removes the event observer from the plugins and the readers observed.
+     */
+    void stopObservation();
+
+    /**
+     * Requests a series of readiness checks.
+     */
+    void requestCheck();
+
+    /**
+     * Checks the availability of a card resource of the profiles not ready yet, on request, until
+     * all of them are ready (run in a dedicated thread).
+     */
+    void checkReadiness();
+
+    /**
+     * Returns the time from startAsync to a time point in milliseconds (mutex held).
+     */
+    long long getElapsedMs(const std::chrono::steady_clock::time_point timePoint) const;
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger =
+        LoggerFactory::getLogger(typeid(CardResourceServiceStarter));
+
+    /**
+     *
+     */
+    std::shared_ptr<CardResourceService> mCardResourceService;
+
+    /**
+     *
+     */
+    std::shared_ptr<CardResourceAllocator> mCardResourceAllocator;
+
+    /**
+     *
+     */
+    const std::vector<std::shared_ptr<Plugin>> mPlugins;
+
+    /**
+     *
+     */
+    const std::vector<std::string> mCardResourceProfileNames;
+
+    /**
+     *
+     */
+    std::shared_ptr<EventObserver> mEventObserver;
+
+    /**
+     * Readers observed, by name.
+     */
+    std::map<std::string, std::shared_ptr<CardReader>> mObservedReaders;
+
+    /**
+     *
+     */
+    std::chrono::steady_clock::time_point mStartRequestTime;
+
+    /**
+     *
+     */
+    bool mIsStartRequested;
+
+    /**
+     *
+     */
+    bool mIsStarted;
+
+    /**
+     *
+     */
+    std::chrono::steady_clock::time_point mStartTime;
+
+    /**
+     * Readiness time of the ready profiles.
+     */
+    std::map<std::string, std::chrono::steady_clock::time_point> mReadinessTimes;
+
+    /**
+     * Number of checks still to do.
+     */
+    int mPendingCheckCount;
+
+    /**
+     *
+     */
+    bool mIsStopping;
+
+    /**
+     *
+     */
+    std::thread mStartThread;
+
+    /**
+     *
+     */
+    std::mutex mMutex;
+
+    /**
+     *
+     */
+    std::condition_variable mCondition;
+};
@@ -0,0 +1,355 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Card Generic */
+#include "GenericExtensionService.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "IllegalStateException.h"
+#include "LoggerFactory.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Plugin Stub */
+#include "StubSmartCard.h"
+
+/* Keyple Cpp Example */
+#include "ConfigurationUtil.h"
+#include "InstrumentedStubPluginFactory.h"
+#include "InstrumentedStubReader.h"
+#include "MultiSelectionHelper.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::generic;
+using namespace keyple::core::service;
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp;
+using namespace keyple::core::util::cpp::exception;
+using namespace keyple::plugin::stub;
+
+/**
+ * <h1>Use Case Generic 6 – Sequential vs grouped selections benchmark (Stub)</h1>
+ *
+ * <p>We compare here the sequential selections of UseCase Generic #5 and the grouped selections of
+ * UseCase Generic #6, for cards having from 1 to MAX_APPLICATION_COUNT applications whose DF Names
+ * share the AID prefix, and calibrate the MultiSelectionHelper choosing between both.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a plugin of instrumented stub readers, counting the APDUs exchanged, with a card
+ *       having several applications and a card having a single one (the stub cards answer the
+ *       same way to each NEXT occurrence selection, so the first card has as many applications as
+ *       selected).
+ *   <li>For each number of applications, select them all sequentially then grouped, the number of
+ *       applications being known.
+ *   <li>Output a table of the scenarios, the APDUs and the durations of both strategies, the
+ *       processing time of the stub being increased by a modelled contactless reader latency. The
+ *       APDUs are those counted by the readers, checked against the counts of the helper.
+ *   <li>Derive the cost of a scenario and of an APDU, and output the strategy chosen by the helper
+ *       for each expected number of applications, the number of applications being unknown (the
+ *       sequential selections stop at the first occurrence not found, the grouped selections are
+ *       as many as the maximum number of applications).
+ *   <li>Check these estimates, and the APDU counts of the helper, against the selections of the
+ *       card having a single application.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ */
+class Main_MultiSelection_Benchmark_Stub {};
+const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_MultiSelection_Benchmark_Stub));
+
+static const std::string PLUGIN_NAME = "Instrumented stub plugin";
+static const std::string MULTIPLE_APPLICATIONS_READER_NAME = "Stub reader multiple applications";
+static const std::string SINGLE_APPLICATION_READER_NAME = "Stub reader single application";
+static const std::string CARD_POWER_ON_DATA = "3B888001000000009171710098";
+
+static const int MAX_APPLICATION_COUNT = 8;
+static const int ITERATION_COUNT = 200;
+
+/* Contactless reader: selection APDU with its FCI, and card presence check of each scenario */
+static const uint64_t APDU_LATENCY_US = 3000;
+static const uint64_t SCENARIO_LATENCY_US = 1500;
+
+/**
+ * Creates a stub card answering the selections of the applications prefixed by the AID.
+ */
+static std::shared_ptr<StubSmartCard> createStubCard(const bool hasNextApplication)
+{
+    const std::string aidLength =
+        HexUtil::toHex(static_cast<uint8_t>(ConfigurationUtil::AID_KEYPLE_PREFIX.size() / 2));
+    const std::string fci = "6F" +
+                            HexUtil::toHex(static_cast<uint8_t>(
+                                ConfigurationUtil::AID_KEYPLE_PREFIX.size() / 2 + 2)) +
+                            "84" +
+                            aidLength +
+                            ConfigurationUtil::AID_KEYPLE_PREFIX;
+
+    return StubSmartCard::builder()
+               ->withPowerOnData(HexUtil::toByteArray(CARD_POWER_ON_DATA))
+               .withProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL)
+               /* Select application, first occurrence */
+               .withSimulatedCommand("00A40400" + aidLength + ConfigurationUtil::AID_KEYPLE_PREFIX +
+                                     "00",
+                                     fci + "9000")
+               /* Select application, next occurrence */
+               .withSimulatedCommand("00A40402" + aidLength + ConfigurationUtil::AID_KEYPLE_PREFIX +
+                                     "00",
+                                     hasNextApplication ? fci + "9000" : "6A82")
+               .build();
+}
+
+/**
+ * Selects the applications with a strategy and returns the average duration of the stub, in
+ * nanoseconds.
+ *
+ * @param apduCount Set to the number of APDUs exchanged by the stub reader per selection.
+ * @throw IllegalStateException If the APDUs exchanged differ from the count of the helper.
+ */
+static uint64_t measure(std::shared_ptr<CardReader> cardReader,
+                        std::shared_ptr<InstrumentedStubReader> stubReader,
+                        const MultiSelectionHelper& multiSelectionHelper,
+                        const MultiSelectionHelper::Strategy strategy,
+                        const size_t expectedApplicationCount,
+                        uint64_t& apduCount)
+{
+    const uint64_t startApduCount = stubReader->getApduCount();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < ITERATION_COUNT; i++) {
+        const size_t applicationCount =
+            multiSelectionHelper.selectApplications(cardReader, strategy).size();
+        if (applicationCount != expectedApplicationCount) {
+            throw IllegalStateException("Unexpected number of applications selected: " +
+                                        std::to_string(applicationCount));
+        }
+    }
+
+    const uint64_t durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - start).count();
+
+    /* The helper counts the APDUs of a selection from its strategy, without any exchange */
+    const uint64_t helperApduCount = static_cast<uint64_t>(
+        multiSelectionHelper.getApduCount(strategy, static_cast<int>(expectedApplicationCount)));
+
+    apduCount = (stubReader->getApduCount() - startApduCount) / ITERATION_COUNT;
+    if (apduCount != helperApduCount) {
+        throw IllegalStateException("APDUs exchanged per selection: " +
+                                    std::to_string(apduCount) +
+                                    ", counted by the helper: " +
+                                    std::to_string(helperApduCount));
+    }
+
+    return durationNs / ITERATION_COUNT;
+}
+
+/**
+ * Returns the latency of the contactless reader for the selections of a strategy and the APDUs
+ * exchanged, in microseconds.
+ */
+static uint64_t getModelledLatencyUs(const MultiSelectionHelper& multiSelectionHelper,
+                                     const MultiSelectionHelper::Strategy strategy,
+                                     const int expectedApplicationCount,
+                                     const uint64_t apduCount)
+{
+    return multiSelectionHelper.getScenarioCount(strategy, expectedApplicationCount) *
+               SCENARIO_LATENCY_US +
+           apduCount * APDU_LATENCY_US;
+}
+
+/**
+ * Returns the name of a strategy.
+ */
+static std::string getName(const MultiSelectionHelper::Strategy strategy)
+{
+    return strategy == MultiSelectionHelper::Strategy::SEQUENTIAL ? "sequential" : "grouped";
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register a plugin with the card readers, counting the APDUs exchanged */
+    std::shared_ptr<InstrumentedStubReader> multipleApplicationsStubReader =
+        std::make_shared<InstrumentedStubReader>(MULTIPLE_APPLICATIONS_READER_NAME,
+                                                 true,
+                                                 createStubCard(true));
+    std::shared_ptr<InstrumentedStubReader> singleApplicationStubReader =
+        std::make_shared<InstrumentedStubReader>(SINGLE_APPLICATION_READER_NAME,
+                                                 true,
+                                                 createStubCard(false));
+    std::shared_ptr<Plugin> plugin =
+        smartCardService->registerPlugin(
+            std::make_shared<InstrumentedStubPluginFactory>(
+                PLUGIN_NAME,
+                std::vector<std::shared_ptr<InstrumentedStubReader>>{
+                    multipleApplicationsStubReader, singleApplicationStubReader}));
+
+    std::shared_ptr<CardReader> multipleApplicationsReader =
+        plugin->getReader(MULTIPLE_APPLICATIONS_READER_NAME);
+    std::shared_ptr<CardReader> singleApplicationReader =
+        plugin->getReader(SINGLE_APPLICATION_READER_NAME);
+    for (const auto& cardReader : {multipleApplicationsReader, singleApplicationReader}) {
+        std::dynamic_pointer_cast<ConfigurableCardReader>(cardReader)
+            ->activateProtocol(ConfigurationUtil::ISO_CARD_PROTOCOL,
+                               ConfigurationUtil::ISO_CARD_PROTOCOL);
+    }
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(GenericExtensionService::getInstance());
+
+    logger->info("=============== " \
+                 "UseCase Generic #6: sequential vs grouped selections benchmark " \
+                 "===============\n");
+    logger->info("= #### AID prefix '%', % iterations, latency % us per APDU and % us per " \
+                 "scenario\n",
+                 ConfigurationUtil::AID_KEYPLE_PREFIX,
+                 ITERATION_COUNT,
+                 APDU_LATENCY_US,
+                 SCENARIO_LATENCY_US);
+
+    /* Number of applications known: as many selections as applications */
+    logger->info("| apps | seq. scenarios | seq. APDUs | seq. stub us | seq. us | " \
+                 "grp. APDUs | grp. stub us | grp. us | fastest    |\n");
+
+    uint64_t firstGroupedNs = 0;
+    uint64_t lastGroupedNs = 0;
+    for (int applicationCount = 1; applicationCount <= MAX_APPLICATION_COUNT; applicationCount++) {
+        const MultiSelectionHelper multiSelectionHelper(
+            ConfigurationUtil::AID_KEYPLE_PREFIX, applicationCount, 0, 0);
+
+        uint64_t sequentialApduCount;
+        const uint64_t sequentialNs = measure(multipleApplicationsReader,
+                                              multipleApplicationsStubReader,
+                                              multiSelectionHelper,
+                                              MultiSelectionHelper::Strategy::SEQUENTIAL,
+                                              applicationCount,
+                                              sequentialApduCount);
+        uint64_t groupedApduCount;
+        const uint64_t groupedNs = measure(multipleApplicationsReader,
+                                           multipleApplicationsStubReader,
+                                           multiSelectionHelper,
+                                           MultiSelectionHelper::Strategy::GROUPED,
+                                           applicationCount,
+                                           groupedApduCount);
+
+        if (applicationCount == 1) {
+            firstGroupedNs = groupedNs;
+        }
+        lastGroupedNs = groupedNs;
+
+        const uint64_t sequentialUs =
+            sequentialNs / 1000 +
+            getModelledLatencyUs(multiSelectionHelper,
+                                 MultiSelectionHelper::Strategy::SEQUENTIAL,
+                                 applicationCount,
+                                 sequentialApduCount);
+        const uint64_t groupedUs =
+            groupedNs / 1000 +
+            getModelledLatencyUs(multiSelectionHelper,
+                                 MultiSelectionHelper::Strategy::GROUPED,
+                                 applicationCount,
+                                 groupedApduCount);
+
+        logger->info("| % | % | % | % | % | % | % | % | % |\n",
+                     applicationCount,
+                     multiSelectionHelper.getScenarioCount(
+                         MultiSelectionHelper::Strategy::SEQUENTIAL, applicationCount),
+                     sequentialApduCount,
+                     sequentialNs / 1000,
+                     sequentialUs,
+                     groupedApduCount,
+                     groupedNs / 1000,
+                     groupedUs,
+                     sequentialUs < groupedUs ? "sequential" : "grouped");
+    }
+
+    /*
+     * Cost of a selection APDU and of a scenario for the stub, from the grouped selections of 1
+     * and MAX_APPLICATION_COUNT applications
+     */
+    const uint64_t stubApduNs =
+        lastGroupedNs > firstGroupedNs ?
+            (lastGroupedNs - firstGroupedNs) / (MAX_APPLICATION_COUNT - 1) : 0;
+    const uint64_t stubScenarioNs =
+        firstGroupedNs > stubApduNs ? firstGroupedNs - stubApduNs : 0;
+
+    const MultiSelectionHelper multiSelectionHelper(ConfigurationUtil::AID_KEYPLE_PREFIX,
+                                                    MAX_APPLICATION_COUNT,
+                                                    stubScenarioNs / 1000 + SCENARIO_LATENCY_US,
+                                                    stubApduNs / 1000 + APDU_LATENCY_US);
+
+    logger->info("= #### Stub cost: % ns per scenario, % ns per APDU\n",
+                 stubScenarioNs,
+                 stubApduNs);
+
+    /* Number of applications unknown: up to MAX_APPLICATION_COUNT selections */
+    logger->info("| expected apps | seq. APDUs | grp. APDUs | seq. est. us | grp. est. us | " \
+                 "chosen     |\n");
+
+    for (int expectedApplicationCount = 1;
+         expectedApplicationCount <= MAX_APPLICATION_COUNT;
+         expectedApplicationCount++) {
+        logger->info("| % | % | % | % | % | % |\n",
+                     expectedApplicationCount,
+                     multiSelectionHelper.getApduCount(MultiSelectionHelper::Strategy::SEQUENTIAL,
+                                                       expectedApplicationCount),
+                     multiSelectionHelper.getApduCount(MultiSelectionHelper::Strategy::GROUPED,
+                                                       expectedApplicationCount),
+                     multiSelectionHelper.getEstimatedDurationUs(
+                         MultiSelectionHelper::Strategy::SEQUENTIAL, expectedApplicationCount),
+                     multiSelectionHelper.getEstimatedDurationUs(
+                         MultiSelectionHelper::Strategy::GROUPED, expectedApplicationCount),
+                     getName(multiSelectionHelper.chooseStrategy(expectedApplicationCount)));
+    }
+
+    /* Check of the estimates with the card having a single application */
+    for (const auto strategy : {MultiSelectionHelper::Strategy::SEQUENTIAL,
+                                MultiSelectionHelper::Strategy::GROUPED}) {
+        uint64_t apduCount;
+        const uint64_t stubNs = measure(singleApplicationReader,
+                                        singleApplicationStubReader,
+                                        multiSelectionHelper,
+                                        strategy,
+                                        1,
+                                        apduCount);
+
+        logger->info("= #### Single application, %: % APDUs, % us measured, % us estimated\n",
+                     getName(strategy),
+                     apduCount,
+                     stubNs / 1000 +
+                         getModelledLatencyUs(multiSelectionHelper, strategy, 1, apduCount),
+                     multiSelectionHelper.getEstimatedDurationUs(strategy, 1));
+    }
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
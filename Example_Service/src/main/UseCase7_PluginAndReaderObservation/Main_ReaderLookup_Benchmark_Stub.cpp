@@ -0,0 +1,133 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "ObservableCardReader.h"
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Plugin Stub */
+#include "StubPluginFactoryBuilder.h"
+
+/* Examples */
+#include "ReaderObserver.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::core::service;
+using namespace keyple::core::util::cpp;
+using namespace keyple::plugin::stub;
+
+/**
+ * <h1>Use Case Generic 7 – reader lookup cost in the reader observer (Stub)</h1>
+ *
+ * <p>We measure here the cost of retrieving the plugin and the observable reader associated with a
+ * reader event, as done by the ReaderObserver of the plugin and reader observation use case.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a Stub plugin with a large number of readers.
+ *   <li>Resolve the plugin and the observable reader for a sequence of reader names using the
+ *       smart card service (lookup by name, then dynamic cast), as done before the reader handles
+ *       were cached.
+ *   <li>Resolve the same sequence using the reader handles cached by the ReaderObserver.
+ *   <li>Output the average cost per event of both methods.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ *
+ * @since 2.1.0
+ */
+class Main_ReaderLookup_Benchmark_Stub {};
+const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_ReaderLookup_Benchmark_Stub));
+
+static const int READER_COUNT = 64;
+static const int EVENT_COUNT = 100000;
+static const std::string READER_NAME_PREFIX = "Stub reader ";
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register the StubPlugin with many contactless readers, without card */
+    auto pluginFactoryBuilder = StubPluginFactoryBuilder::builder();
+    std::vector<std::string> readerNames;
+    for (int i = 0; i < READER_COUNT; i++) {
+        readerNames.push_back(READER_NAME_PREFIX + std::to_string(i));
+        pluginFactoryBuilder->withStubReader(readerNames.back(), true, nullptr);
+    }
+    std::shared_ptr<Plugin> plugin = smartCardService->registerPlugin(pluginFactoryBuilder->build());
+
+    /* Provide the reader observer with the reader handles, as done by the plugin observer */
+    auto readerObserver = std::make_shared<ReaderObserver>();
+    for (const auto& readerName : readerNames) {
+        readerObserver->addReader(
+            plugin, std::dynamic_pointer_cast<ObservableCardReader>(plugin->getReader(readerName)));
+    }
+
+    logger->info("=============== " \
+                 "UseCase Generic #7: reader lookup cost per reader event " \
+                 "===============\n");
+    logger->info("= #### % readers, % events\n", READER_COUNT, EVENT_COUNT);
+
+    /* Lookup through the smart card service (names and RTTI resolved for each event) */
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        const std::string& readerName = readerNames[i % READER_COUNT];
+        const std::string pluginName =
+            smartCardService->getPlugin(smartCardService->getReader(readerName))->getName();
+        std::shared_ptr<ObservableCardReader> reader =
+            std::dynamic_pointer_cast<ObservableCardReader>(
+                smartCardService->getPlugin(pluginName)->getReader(readerName));
+        found += reader != nullptr ? 1 : 0;
+    }
+    const long long serviceLookupNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    /* Lookup through the handles cached by the reader observer */
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        const std::string& readerName = readerNames[i % READER_COUNT];
+        std::pair<std::shared_ptr<Plugin>, std::shared_ptr<ObservableCardReader>> entry =
+            readerObserver->getReader(readerName);
+        found += entry.second != nullptr ? 1 : 0;
+    }
+    const long long cachedLookupNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    logger->info("Readers resolved: % (expected %)\n", found, 2 * EVENT_COUNT);
+    logger->info("Smart card service lookup: % ns/event\n", serviceLookupNs / EVENT_COUNT);
+    logger->info("Cached reader handles:     % ns/event\n", cachedLookupNs / EVENT_COUNT);
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
@@ -12,6 +12,12 @@
 
 #include "PluginObserver.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
 /* Keyple Core Service */
 #include "ConfigurableReader.h"
 #include "ObservableReader.h"
@@ -27,7 +33,9 @@
 using namespace keyple::core::service;
 using namespace keyple::plugin::pcsc;
 
-PluginObserver::PluginObserver(const std::vector<std::shared_ptr<CardReader>>& initialReaders)
+PluginObserver::PluginObserver(const std::vector<std::shared_ptr<CardReader>>& initialReaders,
+                               const size_t maxSetupThreads)
+: mMaxSetupThreads(std::max<size_t>(maxSetupThreads, 1))
 {
     mReaderObserver = std::make_shared<ReaderObserver>();
     for (const auto& reader : initialReaders) {
@@ -39,11 +47,13 @@ PluginObserver::PluginObserver(const std::vector<std::shared_ptr<CardReader>>& i
 
 void PluginObserver::onPluginEvent(const std::shared_ptr<PluginEvent> event)
 {
+    std::shared_ptr<Plugin> plugin =
+        SmartCardServiceProvider::getService()->getPlugin(event->getPluginName());
+    std::vector<std::shared_ptr<CardReader>> connectedReaders;
+
     for (const auto& readerName : event->getReaderNames()) {
         /* We retrieve the reader object from its name */
-        std::shared_ptr<CardReader> reader =
-            SmartCardServiceProvider::getService()->getPlugin(event->getPluginName())
-                                                  ->getReader(readerName);
+        std::shared_ptr<CardReader> reader = plugin->getReader(readerName);
 
         mLogger->info("PluginEvent: PLUGINNAME = %, READERNAME = %, Type = %\n",
                       event->getPluginName(),
@@ -58,12 +68,8 @@ void PluginObserver::onPluginEvent(const std::shared_ptr<PluginEvent> event)
              */
             mLogger->info("New reader! READERNAME = %\n", readerName);
 
-            /* Configure the reader with parameters suitable for contactless operations */
-            setupReader(reader);
-
-            if (std::dynamic_pointer_cast<ObservableCardReader>(reader) != nullptr) {
-                addObserver(reader);
-            }
+            /* The readers connected at once are set up together once the event is parsed */
+            connectedReaders.push_back(reader);
             break;
 
         case PluginEvent::Type::READER_DISCONNECTED:
@@ -74,6 +80,9 @@ void PluginObserver::onPluginEvent(const std::shared_ptr<PluginEvent> event)
              */
             mLogger->info("Reader removed. READERNAME = %\n", readerName);
 
+            /* Forget the reader handles kept by the reader observer */
+            mReaderObserver->removeReader(readerName);
+
             if (std::dynamic_pointer_cast<ObservableCardReader>(reader) != nullptr) {
                 mLogger->info("Clear observers of READERNAME = %\n", readerName);
                 std::dynamic_pointer_cast<ObservableCardReader>(reader)->clearObservers();
@@ -85,6 +94,10 @@ void PluginObserver::onPluginEvent(const std::shared_ptr<PluginEvent> event)
             break;
         }
     }
+
+    if (!connectedReaders.empty()) {
+        setupReaders(connectedReaders);
+    }
 }
 
 void PluginObserver::onPluginObservationError(const std::string& pluginName,
@@ -93,6 +106,52 @@ void PluginObserver::onPluginObservationError(const std::string& pluginName,
     mLogger->error("An exception occurred in plugin '%': %\n", pluginName, e);
 }
 
+void PluginObserver::setupReaders(const std::vector<std::shared_ptr<CardReader>>& readers)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const size_t threadCount = std::min(readers.size(), mMaxSetupThreads);
+    std::atomic<size_t> nextReader(0);
+
+    /* Each worker takes the next reader to set up until all readers are processed */
+    auto worker = [&]() {
+        for (size_t i = nextReader++; i < readers.size(); i = nextReader++) {
+            try {
+                /* Configure the reader with parameters suitable for contactless operations */
+                setupReader(readers[i]);
+
+                if (std::dynamic_pointer_cast<ObservableCardReader>(readers[i]) != nullptr) {
+                    addObserver(readers[i]);
+                }
+            } catch (const Exception& e) {
+                mLogger->error("Unable to set up the reader %\n", readers[i]->getName(), e);
+            } catch (const std::exception& e) {
+                /* An exception escaping a worker would terminate the program */
+                mLogger->error("Unable to set up the reader %: %\n",
+                               readers[i]->getName(),
+                               e.what());
+            }
+        }
+    };
+
+    /* The calling thread takes part in the setup */
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadCount; i++) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    const long long elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    mLogger->info("% reader(s) ready in % ms (% setup thread(s))\n",
+                  readers.size(),
+                  elapsedMs,
+                  threadCount);
+}
+
 void PluginObserver::setupReader(std::shared_ptr<CardReader> cardReader)
 {
     try {
@@ -123,6 +182,13 @@ void PluginObserver::addObserver(std::shared_ptr<CardReader> reader)
     mLogger->info("Add observer READERNAME = %\n", reader->getName());
 
     auto observer = std::dynamic_pointer_cast<ObservableCardReader>(reader);
+
+    /*
+     * Provide the reader observer with the reader handles, so that it does not have to look them up
+     * for each card event.
+     */
+    mReaderObserver->addReader(SmartCardServiceProvider::getService()->getPlugin(reader), observer);
+
     observer->setReaderObservationExceptionHandler(mReaderObserver);
     observer->addObserver(mReaderObserver);
     observer->startCardDetection(ObservableCardReader::DetectionMode::REPEATING);
@@ -41,6 +41,11 @@ using namespace keyple::core::util::cpp;
  */
 class PluginObserver : public PluginObserverSpi, public PluginObservationExceptionHandlerSpi {
 public:
+    /**
+     * Default maximum number of threads used to set up the readers connected at once.
+     */
+    static const size_t DEFAULT_MAX_SETUP_THREADS = 4;
+
     /**
      *
      */
@@ -53,9 +58,12 @@ public:
      * <p>Add an observer to all provided readers that are observable.
      *
      * @param initialReaders The readers connected before the plugin is observed.
+     * @param maxSetupThreads The maximum number of threads used to set up the readers connected
+     *        at once (at least 1).
      * @since 2.0.0
      */
-    PluginObserver(const std::vector<std::shared_ptr<CardReader>>& initialReaders);
+    PluginObserver(const std::vector<std::shared_ptr<CardReader>>& initialReaders,
+                   const size_t maxSetupThreads = DEFAULT_MAX_SETUP_THREADS);
 
     /**
      * {@inheritDoc}
@@ -83,6 +91,19 @@ private:
      */
     std::shared_ptr<ReaderObserver> mReaderObserver;
 
+    /**
+     *
+     */
+    const size_t mMaxSetupThreads;
+
+    /**
+     * Configures and observes the provided readers in parallel, using at most mMaxSetupThreads
+     * threads, then logs the time taken for all of them to be ready.
+     *
+     * @param readers The readers connected at once.
+     */
+    void setupReaders(const std::vector<std::shared_ptr<CardReader>>& readers);
+
     /**
      * Configure the reader to handle ISO14443-4 contactless cards
      *
@@ -19,19 +19,26 @@ using namespace keyple::core::service;
 
 void ReaderObserver::onReaderEvent(const std::shared_ptr<CardReaderEvent> event)
 {
+    /* Retrieve the plugin and the reader registered by the plugin observer */
+    std::pair<std::shared_ptr<Plugin>, std::shared_ptr<ObservableCardReader>> entry =
+        getReader(event->getReaderName());
+
+    if (entry.first == nullptr) {
+        /* Unknown reader (not notified by the plugin observer): ask the smart card service */
+        entry.first =
+            smartCardService->getPlugin(smartCardService->getReader(event->getReaderName()));
+        entry.second = std::dynamic_pointer_cast<ObservableCardReader>(
+                           entry.first->getReader(event->getReaderName()));
+    }
+
     /* Just log the event */
-    const std::string pluginName =
-        smartCardService->getPlugin(smartCardService->getReader(event->getReaderName()))
-            ->getName();
     mLogger->info("Event: PLUGINNAME = %, READERNAME = %, EVENT = %\n",
-                  pluginName,
+                  entry.first->getName(),
                   event->getReaderName(),
                   event->getType());
 
     if (event->getType() != CardReaderEvent::Type::CARD_REMOVED) {
-        std::dynamic_pointer_cast<ObservableCardReader>(
-            smartCardService->getPlugin(pluginName)->getReader(event->getReaderName()))
-                ->finalizeCardProcessing();
+        entry.second->finalizeCardProcessing();
     }
 }
 
@@ -44,3 +51,39 @@ void ReaderObserver::onReaderObservationError(const std::string& pluginName,
                    readerName,
                    e);
 }
+
+void ReaderObserver::addReader(std::shared_ptr<Plugin> plugin,
+                               std::shared_ptr<ObservableCardReader> reader)
+{
+    const std::lock_guard<std::mutex> lock(mReadersMutex);
+
+    mReaders[reader->getName()] = std::make_pair(plugin, reader);
+}
+
+void ReaderObserver::removeReader(const std::string& readerName)
+{
+    const std::lock_guard<std::mutex> lock(mReadersMutex);
+
+    mReaders.erase(readerName);
+}
+
+std::pair<std::shared_ptr<Plugin>, std::shared_ptr<ObservableCardReader>>
+    ReaderObserver::getReader(const std::string& readerName)
+{
+    const std::lock_guard<std::mutex> lock(mReadersMutex);
+
+    const auto it = mReaders.find(readerName);
+    if (it == mReaders.end()) {
+        return std::make_pair(nullptr, nullptr);
+    }
+
+    std::shared_ptr<Plugin> plugin = it->second.first.lock();
+    std::shared_ptr<ObservableCardReader> reader = it->second.second.lock();
+    if (plugin == nullptr || reader == nullptr) {
+        /* The reader has been destroyed without being unregistered */
+        mReaders.erase(it);
+        return std::make_pair(nullptr, nullptr);
+    }
+
+    return std::make_pair(plugin, reader);
+}
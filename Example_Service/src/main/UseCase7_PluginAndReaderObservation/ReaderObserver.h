@@ -12,6 +12,12 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
 /* Calypsonet Terminal Reader */
 #include "CardReaderEvent.h"
 #include "CardReaderObservationExceptionHandlerSpi.h"
@@ -19,6 +25,7 @@
 #include "ObservableCardReader.h"
 
 /* Keyple Core Service */
+#include "Plugin.h"
 #include "SmartCardService.h"
 #include "SmartCardServiceProvider.h"
 
@@ -58,6 +65,40 @@ public:
                                   const std::string& readerName,
                                   const std::shared_ptr<Exception> e) override;
 
+    /**
+     * Registers an observable reader and the plugin it belongs to, so that the reader events
+     * received for this reader are handled without querying the smart card service.
+     *
+     * <p>Called by the plugin observer when a reader is connected. Only weak references are kept,
+     * the reader holding this observer.
+     *
+     * @param plugin The plugin to which the reader belongs.
+     * @param reader The observable reader.
+     * @since 2.1.0
+     */
+    void addReader(std::shared_ptr<Plugin> plugin, std::shared_ptr<ObservableCardReader> reader);
+
+    /**
+     * Unregisters a reader previously registered with addReader.
+     *
+     * <p>Called by the plugin observer when a reader is disconnected.
+     *
+     * @param readerName The name of the reader.
+     * @since 2.1.0
+     */
+    void removeReader(const std::string& readerName);
+
+    /**
+     * Retrieves the plugin and the observable reader registered for the provided reader name.
+     *
+     * @param readerName The name of the reader.
+     * @return A pair (plugin, reader) whose members are null if the reader is not registered or no
+     *         longer exists.
+     * @since 2.1.0
+     */
+    std::pair<std::shared_ptr<Plugin>, std::shared_ptr<ObservableCardReader>> getReader(
+        const std::string& readerName);
+
 private:
     /**
      *
@@ -69,4 +110,16 @@ private:
      */
     const std::shared_ptr<SmartCardService> smartCardService =
         SmartCardServiceProvider::getService();
+
+    /**
+     * Readers known from the plugin observation, indexed by name. The references are weak, an
+     * observed reader owning its observers.
+     */
+    std::map<std::string, std::pair<std::weak_ptr<Plugin>, std::weak_ptr<ObservableCardReader>>>
+        mReaders;
+
+    /**
+     *
+     */
+    std::mutex mReadersMutex;
 };
@@ -12,7 +12,6 @@
 
 #include "ConfigurationUtil.h"
 
-#include <regex>
 #include <sstream>
 
 /* Keyple Core Util */
@@ -33,14 +32,21 @@ const std::string ConfigurationUtil::CONTACT_READER_NAME_REGEX =
 const std::unique_ptr<Logger> ConfigurationUtil::mLogger =
     LoggerFactory::getLogger(typeid(ConfigurationUtil));
 
+const std::regex ConfigurationUtil::mContactlessReaderNameRegex(CONTACTLESS_READER_NAME_REGEX);
+const std::regex ConfigurationUtil::mContactReaderNameRegex(CONTACT_READER_NAME_REGEX);
+const size_t ConfigurationUtil::MAX_COMPILED_REGEX_COUNT = 16;
+const size_t ConfigurationUtil::MAX_READER_NAME_MATCH_COUNT = 256;
+std::map<std::string, std::regex> ConfigurationUtil::mCompiledRegexes;
+std::map<std::pair<std::string, std::string>, bool> ConfigurationUtil::mReaderNameMatches;
+std::mutex ConfigurationUtil::mReaderNameMatchingMutex;
+
 const std::string ConfigurationUtil::getCardReaderName(std::shared_ptr<Plugin> plugin,
                                                        const std::string& readerNameRegex)
 {
     std::string name = "";
-    const std::regex nameRegex(readerNameRegex);
 
     for (const auto& readerName : plugin->getReaderNames()) {
-        if (std::regex_match(readerName, nameRegex)) {
+        if (isReaderNameMatching(readerName, readerNameRegex)) {
             mLogger->info("Card reader, plugin; %, name: %\n", plugin->getName(), readerName);
             name = readerName;
             return name;
@@ -51,3 +57,48 @@ const std::string ConfigurationUtil::getCardReaderName(std::shared_ptr<Plugin> p
     ss << "Reader '" << readerNameRegex << "' not found in plugin '" << plugin->getName() << "'";
     throw IllegalStateException(ss.str());
 }
+
+const std::regex& ConfigurationUtil::getCompiledRegex(const std::string& readerNameRegex)
+{
+    if (readerNameRegex == CONTACTLESS_READER_NAME_REGEX) {
+        return mContactlessReaderNameRegex;
+    }
+
+    if (readerNameRegex == CONTACT_READER_NAME_REGEX) {
+        return mContactReaderNameRegex;
+    }
+
+    const auto it = mCompiledRegexes.find(readerNameRegex);
+    if (it != mCompiledRegexes.end()) {
+        return it->second;
+    }
+
+    /* Compiled before any eviction, an invalid pattern leaving the cache unchanged */
+    std::regex compiledRegex(readerNameRegex);
+    if (mCompiledRegexes.size() >= MAX_COMPILED_REGEX_COUNT) {
+        mCompiledRegexes.clear();
+    }
+
+    return mCompiledRegexes.emplace(readerNameRegex, std::move(compiledRegex)).first->second;
+}
+
+bool ConfigurationUtil::isReaderNameMatching(const std::string& readerName,
+                                             const std::string& readerNameRegex)
+{
+    const std::pair<std::string, std::string> key(readerNameRegex, readerName);
+    const std::lock_guard<std::mutex> lock(mReaderNameMatchingMutex);
+
+    const auto it = mReaderNameMatches.find(key);
+    if (it != mReaderNameMatches.end()) {
+        return it->second;
+    }
+
+    const bool isMatching = std::regex_match(readerName, getCompiledRegex(readerNameRegex));
+    if (mReaderNameMatches.size() >= MAX_READER_NAME_MATCH_COUNT) {
+        mReaderNameMatches.clear();
+    }
+
+    mReaderNameMatches[key] = isMatching;
+
+    return isMatching;
+}
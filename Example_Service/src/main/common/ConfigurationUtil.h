@@ -12,7 +12,12 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <utility>
 
 /* Keyple Core Util */
 #include "LoggerFactory.h"
@@ -66,12 +71,65 @@ public:
     static const std::string getCardReaderName(std::shared_ptr<Plugin> plugin,
                                                const std::string& readerNameRegex);
 
+    /**
+     * Indicates whether a reader name matches a regular expression, the patterns compiled and the
+     * results being kept in bounded caches (see the Example_Card_Calypso ConfigurationUtil).
+     *
+     * @param readerName The reader name.
+     * @param readerNameRegex A regular expression matching the targeted readers.
+     * @return True if the name matches.
+     * @throw std::regex_error If the regular expression is invalid.
+     */
+    static bool isReaderNameMatching(const std::string& readerName,
+                                     const std::string& readerNameRegex);
+
 private:
     /**
      *
      */
     static const std::unique_ptr<Logger> mLogger;
 
+    /**
+     * Compiled CONTACTLESS_READER_NAME_REGEX.
+     */
+    static const std::regex mContactlessReaderNameRegex;
+
+    /**
+     * Compiled CONTACT_READER_NAME_REGEX.
+     */
+    static const std::regex mContactReaderNameRegex;
+
+    /**
+     * Maximum number of patterns compiled on their first use.
+     */
+    static const size_t MAX_COMPILED_REGEX_COUNT;
+
+    /**
+     * Maximum number of matching results kept.
+     */
+    static const size_t MAX_READER_NAME_MATCH_COUNT;
+
+    /**
+     * Patterns compiled on their first use, by pattern.
+     */
+    static std::map<std::string, std::regex> mCompiledRegexes;
+
+    /**
+     * Matching results, by pattern and reader name.
+     */
+    static std::map<std::pair<std::string, std::string>, bool> mReaderNameMatches;
+
+    /**
+     * Protects the caches.
+     */
+    static std::mutex mReaderNameMatchingMutex;
+
+    /**
+     * Returns the compiled pattern, compiling it if not known, the caller holding
+     * mReaderNameMatchingMutex.
+     */
+    static const std::regex& getCompiledRegex(const std::string& readerNameRegex);
+
     /**
      * (private)<br>
      * Constructor.
@@ -0,0 +1,164 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* Keyple Core Common */
+#include "KeypleReaderExtension.h"
+
+/* Keyple Core Plugin */
+#include "ConfigurableReaderSpi.h"
+
+/* Keyple Plugin Stub */
+#include "StubSmartCard.h"
+
+using namespace keyple::core::common;
+using namespace keyple::core::plugin::spi::reader;
+using namespace keyple::plugin::stub;
+
+/**
+ * Reader of the InstrumentedStubPluginFactory plugin: a stub reader counting the APDUs exchanged
+ * with its card, so that the exchanges of a selection scenario can be checked.
+ *
+ * <p>The card is a StubSmartCard of the Keyple stub plugin. The reader is not observable: the
+ * cards are inserted and removed by the application.
+ */
+class InstrumentedStubReader final : public ConfigurableReaderSpi, public KeypleReaderExtension {
+public:
+    /**
+     * Constructor.
+     *
+     * @param name The name of the reader.
+     * @param isContactless True if the reader is contactless.
+     * @param smartCard The inserted card, null if none.
+     */
+    InstrumentedStubReader(const std::string& name,
+                           const bool isContactless,
+                           std::shared_ptr<StubSmartCard> smartCard);
+
+    /**
+     * Inserts a card, replacing the current one if any.
+     *
+     * @param smartCard The card.
+     */
+    void insertCard(std::shared_ptr<StubSmartCard> smartCard);
+
+    /**
+     * Removes the current card, if any.
+     */
+    void removeCard();
+
+    /**
+     * @return The number of APDUs exchanged with the cards since the reader was created.
+     */
+    uint64_t getApduCount() const;
+
+    /**
+     * {@inheritDoc}
+     */
+    const std::string& getName() const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    void openPhysicalChannel() override;
+
+    /**
+     * {@inheritDoc}
+     */
+    void closePhysicalChannel() override;
+
+    /**
+     * {@inheritDoc}
+     */
+    bool isPhysicalChannelOpen() const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    bool checkCardPresence() override;
+
+    /**
+     * {@inheritDoc}
+     */
+    const std::string getPowerOnData() const override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * <p>Counts the APDU.
+     */
+    const std::vector<uint8_t> transmitApdu(const std::vector<uint8_t>& apduIn) override;
+
+    /**
+     * {@inheritDoc}
+     */
+    bool isContactless() override;
+
+    /**
+     * {@inheritDoc}
+     */
+    void onUnregister() override;
+
+    /**
+     * {@inheritDoc}
+     */
+    bool isProtocolSupported(const std::string& readerProtocol) const override;
+
+    /**
+     * {@inheritDoc}
+     */
+    void activateProtocol(const std::string& readerProtocol) override;
+
+    /**
+     * {@inheritDoc}
+     */
+    void deactivateProtocol(const std::string& readerProtocol) override;
+
+    /**
+     * {@inheritDoc}
+     */
+    bool isCurrentProtocol(const std::string& readerProtocol) const override;
+
+private:
+    /**
+     *
+     */
+    const std::string mName;
+
+    /**
+     *
+     */
+    const bool mIsContactless;
+
+    /**
+     *
+     */
+    std::shared_ptr<StubSmartCard> mSmartCard;
+
+    /**
+     *
+     */
+    std::atomic<uint64_t> mApduCount;
+
+    /**
+     * Protects the card, inserted and removed by the application while the reader is in use.
+     */
+    mutable std::mutex mMutex;
+};
@@ -0,0 +1,145 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include "MultiSelectionHelper.h"
+
+#include <algorithm>
+
+/* Calypsonet Terminal Reader */
+#include "CardSelectionManager.h"
+
+/* Keyple Card Generic */
+#include "GenericCardSelectionAdapter.h"
+#include "GenericExtensionService.h"
+
+/* Keyple Core Util */
+#include "IllegalArgumentException.h"
+
+/* Keyple Core Service */
+#include "SmartCardServiceProvider.h"
+
+using namespace calypsonet::terminal::reader::selection;
+using namespace keyple::card::generic;
+using namespace keyple::core::service;
+using namespace keyple::core::util::cpp::exception;
+
+MultiSelectionHelper::MultiSelectionHelper(const std::string& aid,
+                                           const int maxApplicationCount,
+                                           const uint64_t scenarioCostUs,
+                                           const uint64_t apduCostUs)
+: mAid(aid),
+  mMaxApplicationCount(maxApplicationCount),
+  mScenarioCostUs(scenarioCostUs),
+  mApduCostUs(apduCostUs)
+{
+    if (maxApplicationCount <= 0) {
+        throw IllegalArgumentException("The maximum number of applications must be strictly " \
+                                       "positive");
+    }
+}
+
+int MultiSelectionHelper::getScenarioCount(const Strategy strategy,
+                                           const int expectedApplicationCount) const
+{
+    if (strategy == Strategy::GROUPED) {
+        return 1;
+    }
+
+    /* One scenario per application, plus the one not finding the next occurrence */
+    return std::min(std::max(expectedApplicationCount, 0) + 1, mMaxApplicationCount);
+}
+
+int MultiSelectionHelper::getApduCount(const Strategy strategy,
+                                       const int expectedApplicationCount) const
+{
+    if (strategy == Strategy::GROUPED) {
+        return mMaxApplicationCount;
+    }
+
+    return getScenarioCount(strategy, expectedApplicationCount);
+}
+
+uint64_t MultiSelectionHelper::getEstimatedDurationUs(const Strategy strategy,
+                                                      const int expectedApplicationCount) const
+{
+    return getScenarioCount(strategy, expectedApplicationCount) * mScenarioCostUs +
+           getApduCount(strategy, expectedApplicationCount) * mApduCostUs;
+}
+
+MultiSelectionHelper::Strategy MultiSelectionHelper::chooseStrategy(
+    const int expectedApplicationCount) const
+{
+    return getEstimatedDurationUs(Strategy::SEQUENTIAL, expectedApplicationCount) <
+           getEstimatedDurationUs(Strategy::GROUPED, expectedApplicationCount) ?
+               Strategy::SEQUENTIAL : Strategy::GROUPED;
+}
+
+std::vector<std::shared_ptr<SmartCard>> MultiSelectionHelper::selectApplications(
+    std::shared_ptr<CardReader> cardReader, const int expectedApplicationCount) const
+{
+    return selectApplications(cardReader, chooseStrategy(expectedApplicationCount));
+}
+
+std::vector<std::shared_ptr<SmartCard>> MultiSelectionHelper::selectApplications(
+    std::shared_ptr<CardReader> cardReader, const Strategy strategy) const
+{
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+    std::shared_ptr<GenericExtensionService> genericCardService =
+        GenericExtensionService::getInstance();
+
+    std::vector<std::shared_ptr<SmartCard>> smartCards;
+
+    if (strategy == Strategy::GROUPED) {
+        std::shared_ptr<CardSelectionManager> cardSelectionManager =
+            smartCardService->createCardSelectionManager();
+        cardSelectionManager->setMultipleSelectionMode();
+
+        for (int i = 0; i < mMaxApplicationCount; i++) {
+            std::shared_ptr<GenericCardSelection> cardSelection =
+                genericCardService->createCardSelection();
+            cardSelection->filterByDfName(mAid);
+            cardSelection->setFileOccurrence(i == 0 ? GenericCardSelection::FileOccurrence::FIRST :
+                                                      GenericCardSelection::FileOccurrence::NEXT);
+            cardSelectionManager->prepareSelection(cardSelection);
+        }
+
+        /* The smart cards are indexed by selection, hence by occurrence */
+        for (const auto& entry :
+                cardSelectionManager->processCardSelectionScenario(cardReader)->getSmartCards()) {
+            smartCards.push_back(entry.second);
+        }
+
+        return smartCards;
+    }
+
+    for (int i = 0; i < mMaxApplicationCount; i++) {
+        std::shared_ptr<CardSelectionManager> cardSelectionManager =
+            smartCardService->createCardSelectionManager();
+
+        std::shared_ptr<GenericCardSelection> cardSelection =
+            genericCardService->createCardSelection();
+        cardSelection->filterByDfName(mAid);
+        cardSelection->setFileOccurrence(i == 0 ? GenericCardSelection::FileOccurrence::FIRST :
+                                                  GenericCardSelection::FileOccurrence::NEXT);
+        cardSelectionManager->prepareSelection(cardSelection);
+
+        std::shared_ptr<SmartCard> smartCard =
+            cardSelectionManager->processCardSelectionScenario(cardReader)->getActiveSmartCard();
+        if (smartCard == nullptr) {
+            break;
+        }
+
+        smartCards.push_back(smartCard);
+    }
+
+    return smartCards;
+}
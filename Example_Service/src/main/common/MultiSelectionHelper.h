@@ -0,0 +1,140 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "SmartCard.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace calypsonet::terminal::reader::selection::spi;
+
+/**
+ * Selection of all the applications of a card whose DF Names share an AID prefix, either
+ * sequentially (UseCase Generic #5) or grouped in a single selection scenario (UseCase Generic #6),
+ * whichever is estimated to be the cheaper.
+ *
+ * <p>The sequential strategy runs one scenario per occurrence (FIRST, then NEXT) and stops at the
+ * first occurrence not found, or once the maximum number of applications is reached. The grouped
+ * strategy runs a single scenario in multiple selection mode, with as many selections as the
+ * maximum number of applications, whatever the number of applications actually present.
+ *
+ * <p>The estimates are based on the cost of a selection scenario and of a selection APDU, as
+ * measured by the multiple selection benchmark (Stub) for the reader in use: the sequential
+ * strategy pays the scenario cost for each application, the grouped strategy pays the APDU cost
+ * for each missing one.
+ *
+ * <p>The physical channel is left open after the selections.
+ */
+class MultiSelectionHelper final {
+public:
+    /**
+     * Selection strategy.
+     */
+    enum class Strategy {
+        SEQUENTIAL,
+        GROUPED
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param aid The AID prefix of the applications.
+     * @param maxApplicationCount The maximum number of applications selected.
+     * @param scenarioCostUs The cost of a selection scenario, besides its APDUs, in microseconds.
+     * @param apduCostUs The cost of a selection APDU, in microseconds.
+     * @throw IllegalArgumentException If the maximum number of applications is not strictly
+     *        positive.
+     */
+    MultiSelectionHelper(const std::string& aid,
+                         const int maxApplicationCount,
+                         const uint64_t scenarioCostUs,
+                         const uint64_t apduCostUs);
+
+    /**
+     * @param strategy The strategy.
+     * @param expectedApplicationCount The number of applications expected in the card.
+     * @return The number of selection scenarios the strategy will run.
+     */
+    int getScenarioCount(const Strategy strategy, const int expectedApplicationCount) const;
+
+    /**
+     * @param strategy The strategy.
+     * @param expectedApplicationCount The number of applications expected in the card.
+     * @return The number of selection APDUs the strategy will send.
+     */
+    int getApduCount(const Strategy strategy, const int expectedApplicationCount) const;
+
+    /**
+     * @param strategy The strategy.
+     * @param expectedApplicationCount The number of applications expected in the card.
+     * @return The estimated duration of the selections, in microseconds.
+     */
+    uint64_t getEstimatedDurationUs(const Strategy strategy,
+                                    const int expectedApplicationCount) const;
+
+    /**
+     * Chooses the strategy of the lowest estimated duration, the grouped one if equal.
+     *
+     * @param expectedApplicationCount The number of applications expected in the card.
+     * @return The strategy.
+     */
+    Strategy chooseStrategy(const int expectedApplicationCount) const;
+
+    /**
+     * Selects the applications of the card with the strategy chosen for the expected number of
+     * applications.
+     *
+     * @param cardReader The reader.
+     * @param expectedApplicationCount The number of applications expected in the card.
+     * @return The applications selected, in the order of their occurrence.
+     */
+    std::vector<std::shared_ptr<SmartCard>> selectApplications(
+        std::shared_ptr<CardReader> cardReader, const int expectedApplicationCount) const;
+
+    /**
+     * Selects the applications of the card with a given strategy.
+     *
+     * @param cardReader The reader.
+     * @param strategy The strategy.
+     * @return The applications selected, in the order of their occurrence.
+     */
+    std::vector<std::shared_ptr<SmartCard>> selectApplications(
+        std::shared_ptr<CardReader> cardReader, const Strategy strategy) const;
+
+private:
+    /**
+     *
+     */
+    const std::string mAid;
+
+    /**
+     *
+     */
+    const int mMaxApplicationCount;
+
+    /**
+     *
+     */
+    const uint64_t mScenarioCostUs;
+
+    /**
+     *
+     */
+    const uint64_t mApduCostUs;
+};
@@ -17,7 +17,6 @@
 /* Keyple Core Util */
 #include "HexUtil.h"
 #include "LoggerFactory.h"
-#include "Thread.h"
 
 /* Keyple Core Service */
 #include "ConfigurableReader.h"
@@ -43,6 +42,11 @@
 #include "KeyplePluginExtension.h"
 #include "KeypleReaderExtension.h"
 
+/* Examples */
+#include "CardResourceAllocator.h"
+#include "CardResourceServiceMetrics.h"
+#include "CardResourceServiceStarter.h"
+
 using namespace calypsonet::terminal::reader;
 using namespace keyple::card::generic;
 using namespace keyple::core::common;
@@ -60,10 +64,13 @@ using namespace keyple::plugin::stub;
  * <h2>Scenario:</h2>
  *
  * <ul>
- *   <li>The card resource service is configured and started to observe the connection/disconnection
- *       of readers and the insertion/removal of cards.
+ *   <li>The card resource service is configured and started in the background to observe the
+ *       connection/disconnection of readers and the insertion/removal of cards, the requests for a
+ *       card resource waiting for the readiness of its profile.
  *   <li>A command line menu allows you to take and release the two defined types of card resources.
  *   <li>The log and console printouts show the operation of the card resource service.
+ *   <li>The metrics of the card resource service (waiting and holding times, evictions,
+ *       re-selections, available resources) are logged periodically and on exit.
  * </ul>
  *
  * All results are logged with slf4j.
@@ -87,6 +94,8 @@ static const std::string RESOURCE_B = "RESOURCE_B";
 static const std::string READER_NAME_REGEX_A = ".*_A";
 static const std::string READER_NAME_REGEX_B = ".*_B";
 static const std::string SAM_PROTOCOL = "ISO_7816_3_T0";
+static const long ALLOCATION_TIMEOUT_MS = 10000;
+static const long METRICS_DUMP_PERIOD_MS = 30000;
 
 /**
  * Reader configurator used by the card resource service to set up the SAM reader with the required
@@ -228,7 +237,8 @@ int main()
 
     /*
      * Configure the card resource service:
-     * - allocation mode is blocking with a 100 milliseconds cycle and a 10 seconds timeout.
+     * - allocation mode is non-blocking, the blocking allocation with a 10 seconds timeout is
+     * provided by a CardResourceAllocator waking the waiters as soon as a resource is released.
      * - the readers are searched in the Stub plugin, the observation of the plugin (for the
      * connection/disconnection of readers) and of the readers (for the insertion/removal of cards)
      * is activated.
@@ -236,8 +246,7 @@ int main()
      * characterized by its power-on data and placed in a specific reader.
      * - the timeout for using the card's resources is set at 5 seconds.
      */
-    cardResourceService->getConfigurator()->withBlockingAllocationMode(100, 10000)
-                                           .withPlugins(
+    cardResourceService->getConfigurator()->withPlugins(
                                                PluginsConfigurator::builder()
                                                    ->addPluginWithMonitoring(
                                                        plugin,
@@ -256,16 +265,30 @@ int main()
                                                     ->withReaderNameRegex(READER_NAME_REGEX_B)
                                                      .build()})
                                            .configure();
-    cardResourceService->start();
 
+    /* Collect the metrics of the allocations, logged periodically */
+    auto cardResourceServiceMetrics = std::make_shared<CardResourceServiceMetrics>();
+    cardResourceServiceMetrics->startPeriodicDump(METRICS_DUMP_PERIOD_MS);
+
+    auto cardResourceAllocator =
+        std::make_shared<CardResourceAllocator>(cardResourceService, cardResourceServiceMetrics);
+
+    /*
+     * Start the service in the background, the readiness of each profile being detected from the
+     * plugin and reader events.
+     */
+    CardResourceServiceStarter cardResourceServiceStarter(cardResourceService,
+                                                          cardResourceAllocator,
+                                                          {plugin},
+                                                          {RESOURCE_A, RESOURCE_B});
+    cardResourceServiceStarter.startAsync();
+
+    /* The connection of the readers is notified by the monitoring of the plugin */
     std::dynamic_pointer_cast<StubPlugin>(plugin->getExtension(typeid(StubPlugin)))
         ->plugReader(READER_A, true, nullptr);
     std::dynamic_pointer_cast<StubPlugin>(plugin->getExtension(typeid(StubPlugin)))
         ->plugReader(READER_B, true, nullptr);
 
-    /* Sleep for a moment to let the readers being detected */
-    Thread::sleep(2000);
-
     logger->info("= #### Connect/disconnect readers, insert/remove cards, watch the log\n");
 
     bool loop = true;
@@ -304,7 +327,13 @@ int main()
                     ->removeCard();
             break;
         case '5':
-            cardResourceA = cardResourceService->getCardResource(RESOURCE_A);
+            if (!cardResourceServiceStarter.waitForProfileReadiness(RESOURCE_A,
+                                                                    ALLOCATION_TIMEOUT_MS)) {
+                logger->info("Card resource A is not ready\n");
+                break;
+            }
+            cardResourceA =
+                cardResourceAllocator->getCardResource(RESOURCE_A, ALLOCATION_TIMEOUT_MS);
             if (cardResourceA != nullptr) {
                 logger->info("Card resource A is available: reader %, smart card %\n",
                              cardResourceA->getReader()->getName(),
@@ -316,13 +345,19 @@ int main()
         case '6':
             if (cardResourceA != nullptr) {
                 logger->info("Release card resource A\n");
-                cardResourceService->releaseCardResource(cardResourceA);
+                cardResourceAllocator->releaseCardResource(cardResourceA);
             } else {
                 logger->error("Card resource A is not available\n");
             }
             break;
         case '7':
-            cardResourceB = cardResourceService->getCardResource(RESOURCE_B);
+            if (!cardResourceServiceStarter.waitForProfileReadiness(RESOURCE_B,
+                                                                    ALLOCATION_TIMEOUT_MS)) {
+                logger->info("Card resource B is not ready\n");
+                break;
+            }
+            cardResourceB =
+                cardResourceAllocator->getCardResource(RESOURCE_B, ALLOCATION_TIMEOUT_MS);
             if (cardResourceB != nullptr) {
                 logger->info("Card resource B is available: reader %, smart card %\n",
                              cardResourceB->getReader()->getName(),
@@ -334,7 +369,7 @@ int main()
         case '8':
             if (cardResourceB != nullptr) {
                 logger->info("Release card resource B\n");
-                cardResourceService->releaseCardResource(cardResourceB);
+                cardResourceAllocator->releaseCardResource(cardResourceB);
             } else {
                 logger->error("Card resource B is not available\n");
             }
@@ -347,6 +382,10 @@ int main()
         }
     }
 
+    cardResourceServiceStarter.logStartupTimes();
+    cardResourceServiceMetrics->stopPeriodicDump();
+    cardResourceServiceMetrics->logSnapshot();
+
     /* Unregister plugin */
     smartCardService->unregisterPlugin(plugin->getName());
 
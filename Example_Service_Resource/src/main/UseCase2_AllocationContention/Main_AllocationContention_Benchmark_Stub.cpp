@@ -0,0 +1,279 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "LoggerFactory.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Service Resource */
+#include "CardResourceProfileConfigurator.h"
+#include "CardResourceService.h"
+#include "CardResourceServiceProvider.h"
+#include "PluginsConfigurator.h"
+
+/* Keyple Plugin Stub */
+#include "StubPluginFactoryBuilder.h"
+#include "StubSmartCard.h"
+
+/* Keyple Card Generic */
+#include "GenericExtensionService.h"
+
+/* Examples */
+#include "CardResourceAllocator.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::generic;
+using namespace keyple::core::service;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::service::resource::spi;
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp;
+using namespace keyple::plugin::stub;
+
+/**
+ * <h1>Use Case "resource service 2" – Allocation under contention (Stub)</h1>
+ *
+ * <p>We compare here the waiting time of the callers of a card resource under contention, with the
+ * blocking allocation mode of the card resource service (fixed-cycle polling) and with the
+ * event-driven allocation of the CardResourceAllocator (waiters woken by the releases).
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a Stub plugin with a few readers, each containing a card matching the profile.
+ *   <li>Configure the card resource service in blocking allocation mode, then start threads taking
+ *       a card resource, holding it for a while and releasing it, in a loop.
+ *   <li>Configure the card resource service in non-blocking allocation mode and run the same
+ *       threads through a CardResourceAllocator.
+ *   <li>Output the waiting time percentiles and the throughput of both modes.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ *
+ * @since 2.0.0
+ */
+class Main_AllocationContention_Benchmark_Stub {};
+const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_AllocationContention_Benchmark_Stub));
+
+static const std::string READER_NAME_PREFIX = "READER_A_";
+static const std::string READER_NAME_REGEX = "READER_A_.*";
+static const std::string ATR_CARD_A = "3B3F9600805A4880C120501711AABBCC829000";
+static const std::string ATR_REGEX_A = "^3B3F9600805A4880C120501711[0-9A-F]{6}829000$";
+static const std::string RESOURCE_A = "RESOURCE_A";
+static const std::string SAM_PROTOCOL = "ISO_7816_3_T0";
+
+static const int RESOURCE_COUNT = 2;
+static const int THREAD_COUNT = 8;
+static const int ALLOCATION_COUNT_PER_THREAD = 25;
+static const int HOLD_TIME_MS = 20;
+static const int CYCLE_DURATION_MS = 100;
+static const int TIMEOUT_MS = 10000;
+
+/**
+ * Reader configurator used by the card resource service to set up the readers.
+ */
+class ReaderConfigurator : public ReaderConfiguratorSpi {
+public:
+    /**
+     * {@inheritDoc}
+     */
+    void setupReader(std::shared_ptr<CardReader> reader) override
+    {
+        std::dynamic_pointer_cast<ConfigurableCardReader>(reader)
+            ->activateProtocol(SAM_PROTOCOL, SAM_PROTOCOL);
+    }
+};
+
+/**
+ * Returns the p-th percentile (nearest rank) of sorted values, 0 if empty.
+ */
+static long long percentile(const std::vector<long long>& sortedValues, const int p)
+{
+    if (sortedValues.empty()) {
+        return 0;
+    }
+
+    const size_t rank = (p * sortedValues.size() + 99) / 100;
+
+    return sortedValues[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Configures and starts the card resource service, in blocking allocation mode or not.
+ */
+static void configureCardResourceService(std::shared_ptr<Plugin> plugin, const bool isBlocking)
+{
+    std::shared_ptr<GenericCardSelection> cardSelection =
+        GenericExtensionService::getInstance()->createCardSelection();
+    cardSelection->filterByPowerOnData(ATR_REGEX_A);
+
+    std::shared_ptr<CardResourceProfileExtension> cardResourceExtension =
+        GenericExtensionService::getInstance()->createCardResourceProfileExtension(cardSelection);
+
+    std::shared_ptr<CardResourceService> cardResourceService =
+        CardResourceServiceProvider::getService();
+
+    auto configurator = cardResourceService->getConfigurator();
+    if (isBlocking) {
+        configurator->withBlockingAllocationMode(CYCLE_DURATION_MS, TIMEOUT_MS);
+    }
+    configurator->withPlugins(PluginsConfigurator::builder()
+                                  ->addPlugin(plugin, std::make_shared<ReaderConfigurator>())
+                                   .build())
+                 .withCardResourceProfiles(
+                     {CardResourceProfileConfigurator::builder(RESOURCE_A, cardResourceExtension)
+                          ->withReaderNameRegex(READER_NAME_REGEX)
+                           .build()})
+                 .configure();
+    cardResourceService->start();
+}
+
+/**
+ * Runs the contention scenario and logs its results.
+ */
+static void run(const std::string& modeName,
+                std::shared_ptr<CardResourceService> cardResourceService,
+                std::shared_ptr<CardResourceAllocator> allocator)
+{
+    std::vector<long long> waitingTimesUs;
+    int failureCount = 0;
+    std::mutex resultsMutex;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < ALLOCATION_COUNT_PER_THREAD; j++) {
+                const auto requestTime = std::chrono::steady_clock::now();
+                std::shared_ptr<CardResource> cardResource =
+                    allocator != nullptr ? allocator->getCardResource(RESOURCE_A, TIMEOUT_MS) :
+                                           cardResourceService->getCardResource(RESOURCE_A);
+                const long long waitingTimeUs =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - requestTime).count();
+
+                {
+                    const std::lock_guard<std::mutex> lock(resultsMutex);
+                    if (cardResource == nullptr) {
+                        failureCount++;
+                        continue;
+                    }
+                    waitingTimesUs.push_back(waitingTimeUs);
+                }
+
+                /* Use the card resource */
+                std::this_thread::sleep_for(std::chrono::milliseconds(HOLD_TIME_MS));
+
+                if (allocator != nullptr) {
+                    allocator->releaseCardResource(cardResource);
+                } else {
+                    cardResourceService->releaseCardResource(cardResource);
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const long long elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    std::sort(waitingTimesUs.begin(), waitingTimesUs.end());
+
+    logger->info("= #### %\n", modeName);
+    logger->info("Allocations: %, timeouts: %, duration: % ms, throughput: % allocations/s\n",
+                 waitingTimesUs.size(),
+                 failureCount,
+                 elapsedMs,
+                 elapsedMs == 0 ? 0 : static_cast<long long>(waitingTimesUs.size()) * 1000 /
+                                      elapsedMs);
+    logger->info("Waiting time p50: % us, p90: % us, p99: % us, max: % us\n",
+                 percentile(waitingTimesUs, 50),
+                 percentile(waitingTimesUs, 90),
+                 percentile(waitingTimesUs, 99),
+                 percentile(waitingTimesUs, 100));
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register the StubPlugin with readers containing a card matching the profile */
+    auto pluginFactoryBuilder = StubPluginFactoryBuilder::builder();
+    for (int i = 0; i < RESOURCE_COUNT; i++) {
+        pluginFactoryBuilder->withStubReader(READER_NAME_PREFIX + std::to_string(i),
+                                             false,
+                                             StubSmartCard::builder()
+                                                 ->withPowerOnData(HexUtil::toByteArray(ATR_CARD_A))
+                                                  .withProtocol(SAM_PROTOCOL)
+                                                  .build());
+    }
+    std::shared_ptr<Plugin> plugin = smartCardService->registerPlugin(pluginFactoryBuilder->build());
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(GenericExtensionService::getInstance());
+
+    logger->info("=============== " \
+                 "UseCase Resource Service #2: allocation under contention " \
+                 "==================\n");
+    logger->info("= % resources, % threads, % allocations per thread, hold time % ms\n",
+                 RESOURCE_COUNT,
+                 THREAD_COUNT,
+                 ALLOCATION_COUNT_PER_THREAD,
+                 HOLD_TIME_MS);
+
+    std::shared_ptr<CardResourceService> cardResourceService =
+        CardResourceServiceProvider::getService();
+
+    /* Blocking allocation mode of the service: the waiters retry at each cycle */
+    configureCardResourceService(plugin, true);
+    run("Blocking allocation mode (" + std::to_string(CYCLE_DURATION_MS) + " ms cycle)",
+        cardResourceService,
+        nullptr);
+    cardResourceService->stop();
+
+    /* Event-driven allocation: the waiters are woken by the releases, in FIFO order */
+    configureCardResourceService(plugin, false);
+    run("Event-driven allocation",
+        cardResourceService,
+        std::make_shared<CardResourceAllocator>(cardResourceService));
+    cardResourceService->stop();
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
@@ -0,0 +1,344 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "LoggerFactory.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Service Resource */
+#include "CardResourceProfileConfigurator.h"
+#include "CardResourceService.h"
+#include "CardResourceServiceProvider.h"
+#include "PluginsConfigurator.h"
+
+/* Keyple Plugin Stub */
+#include "StubPluginFactoryBuilder.h"
+#include "StubSmartCard.h"
+
+/* Keyple Card Generic */
+#include "GenericExtensionService.h"
+
+/* Examples */
+#include "CardResourceAllocator.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::generic;
+using namespace keyple::core::service;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::service::resource::spi;
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp;
+using namespace keyple::plugin::stub;
+
+/**
+ * <h1>Use Case "resource service 3" – Contention benchmark (Stub)</h1>
+ *
+ * <p>We measure here the scaling of the card resource service when several threads compete for
+ * the card resources of two profiles A and B, each profile being served by a pool of Stub readers.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a Stub plugin with readers containing cards A and cards B.
+ *   <li>For each allocation, number of resources per profile, number of threads and hold time:
+ *       <ul>
+ *         <li>Configure the card resource service with the profiles A and B restricted to the
+ *             requested number of readers.
+ *         <li>During a fixed time, let each thread take a card resource of its profile (A or B,
+ *             alternately), hold it for the hold time and release it, in a loop.
+ *         <li>Output the throughput, the acquisition latency percentiles and the fairness between
+ *             threads (Jain's index of the number of acquisitions per thread, 1 meaning equal
+ *             shares).
+ *       </ul>
+ * </ul>
+ *
+ * <p>Two allocations are compared:
+ *
+ * <ul>
+ *   <li>service: the baseline, the callers use getCardResource/releaseCardResource of the card
+ *       resource service directly, the service being configured in blocking allocation mode.
+ *   <li>allocator: the callers wait for the card resources through a CardResourceAllocator
+ *       (event-driven blocking allocation), so that the latencies measured are not quantized by a
+ *       polling cycle.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ *
+ * @since 2.0.0
+ */
+class Main_ResourceContention_Benchmark_Stub {};
+const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_ResourceContention_Benchmark_Stub));
+
+static const std::string READER_A_PREFIX = "READER_A_";
+static const std::string READER_B_PREFIX = "READER_B_";
+static const std::string ATR_CARD_A = "3B3F9600805A4880C120501711AABBCC829000";
+static const std::string ATR_CARD_B = "3B3F9600805A4880C120501722AABBCC829000";
+static const std::string ATR_REGEX_A = "^3B3F9600805A4880C120501711[0-9A-F]{6}829000$";
+static const std::string ATR_REGEX_B = "^3B3F9600805A4880C120501722[0-9A-F]{6}829000$";
+static const std::string RESOURCE_A = "RESOURCE_A";
+static const std::string RESOURCE_B = "RESOURCE_B";
+static const std::string SAM_PROTOCOL = "ISO_7816_3_T0";
+
+static const std::vector<int> RESOURCE_COUNTS = {1, 2, 4};
+static const std::vector<int> THREAD_COUNTS = {1, 4, 16};
+static const std::vector<int> HOLD_TIMES_MS = {0, 5};
+static const int RUN_DURATION_MS = 1000;
+static const long ALLOCATION_TIMEOUT_MS = 10000;
+static const int CYCLE_DURATION_MS = 10;
+
+/**
+ * Reader configurator used by the card resource service to set up the readers.
+ */
+class ReaderConfigurator : public ReaderConfiguratorSpi {
+public:
+    /**
+     * {@inheritDoc}
+     */
+    void setupReader(std::shared_ptr<CardReader> reader) override
+    {
+        std::dynamic_pointer_cast<ConfigurableCardReader>(reader)
+            ->activateProtocol(SAM_PROTOCOL, SAM_PROTOCOL);
+    }
+};
+
+/**
+ * Returns the p-th percentile (nearest rank) of sorted values, 0 if empty.
+ */
+static long long percentile(const std::vector<long long>& sortedValues, const int p)
+{
+    if (sortedValues.empty()) {
+        return 0;
+    }
+
+    const size_t rank = (p * sortedValues.size() + 99) / 100;
+
+    return sortedValues[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Returns Jain's fairness index of the provided shares: (sum x)^2 / (n * sum x^2).
+ */
+static double jainIndex(const std::vector<long long>& shares)
+{
+    double sum = 0;
+    double sumOfSquares = 0;
+    for (const long long share : shares) {
+        sum += static_cast<double>(share);
+        sumOfSquares += static_cast<double>(share) * static_cast<double>(share);
+    }
+
+    return sumOfSquares == 0 ? 0 : sum * sum / (shares.size() * sumOfSquares);
+}
+
+/**
+ * Returns a regex matching the first readers of a prefix.
+ */
+static std::string getReaderNameRegex(const std::string& prefix, const int resourceCount)
+{
+    return prefix + "[0-" + std::to_string(resourceCount - 1) + "]";
+}
+
+/**
+ * Creates a card resource profile expecting the provided power-on data in the provided readers.
+ */
+static std::shared_ptr<CardResourceProfileConfigurator> createProfile(
+    const std::string& name, const std::string& powerOnDataRegex, const std::string& readerNameRegex)
+{
+    std::shared_ptr<GenericCardSelection> cardSelection =
+        GenericExtensionService::getInstance()->createCardSelection();
+    cardSelection->filterByPowerOnData(powerOnDataRegex);
+
+    return CardResourceProfileConfigurator::builder(
+               name,
+               GenericExtensionService::getInstance()->createCardResourceProfileExtension(
+                   cardSelection))
+        ->withReaderNameRegex(readerNameRegex)
+         .build();
+}
+
+/**
+ * Runs one combination of the benchmark and logs its results.
+ *
+ * @param isDirect True to call the card resource service directly (baseline), false to go through
+ *        a CardResourceAllocator.
+ */
+static void run(std::shared_ptr<Plugin> plugin,
+                const bool isDirect,
+                const int resourceCount,
+                const int threadCount,
+                const int holdTimeMs)
+{
+    std::shared_ptr<CardResourceService> cardResourceService =
+        CardResourceServiceProvider::getService();
+
+    auto configurator = cardResourceService->getConfigurator();
+    if (isDirect) {
+        configurator->withBlockingAllocationMode(CYCLE_DURATION_MS,
+                                                 static_cast<int>(ALLOCATION_TIMEOUT_MS));
+    }
+    configurator->withPlugins(PluginsConfigurator::builder()
+                                  ->addPlugin(plugin, std::make_shared<ReaderConfigurator>())
+                                   .build())
+                 .withCardResourceProfiles(
+                     {createProfile(RESOURCE_A,
+                                    ATR_REGEX_A,
+                                    getReaderNameRegex(READER_A_PREFIX, resourceCount)),
+                      createProfile(RESOURCE_B,
+                                    ATR_REGEX_B,
+                                    getReaderNameRegex(READER_B_PREFIX, resourceCount))})
+                 .configure();
+    cardResourceService->start();
+
+    CardResourceAllocator allocator(cardResourceService);
+    std::atomic<bool> isRunning(true);
+    std::vector<long long> latenciesUs;
+    std::vector<long long> acquisitionCounts(threadCount, 0);
+    int timeoutCount = 0;
+    std::mutex resultsMutex;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([&, i]() {
+            const std::string& profileName = i % 2 == 0 ? RESOURCE_A : RESOURCE_B;
+            std::vector<long long> threadLatenciesUs;
+            int threadTimeoutCount = 0;
+
+            while (isRunning) {
+                const auto requestTime = std::chrono::steady_clock::now();
+                std::shared_ptr<CardResource> cardResource =
+                    isDirect ? cardResourceService->getCardResource(profileName) :
+                               allocator.getCardResource(profileName, ALLOCATION_TIMEOUT_MS);
+                if (cardResource == nullptr) {
+                    threadTimeoutCount++;
+                    continue;
+                }
+                threadLatenciesUs.push_back(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - requestTime).count());
+
+                /* Use the card resource */
+                if (holdTimeMs > 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(holdTimeMs));
+                }
+
+                if (isDirect) {
+                    cardResourceService->releaseCardResource(cardResource);
+                } else {
+                    allocator.releaseCardResource(cardResource);
+                }
+            }
+
+            const std::lock_guard<std::mutex> lock(resultsMutex);
+            latenciesUs.insert(
+                latenciesUs.end(), threadLatenciesUs.begin(), threadLatenciesUs.end());
+            acquisitionCounts[i] = static_cast<long long>(threadLatenciesUs.size());
+            timeoutCount += threadTimeoutCount;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_DURATION_MS));
+    isRunning = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    cardResourceService->stop();
+
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+
+    logger->info("% | % | % | % | % | % | % | % | % | %\n",
+                 isDirect ? "service" : "allocator",
+                 resourceCount,
+                 threadCount,
+                 holdTimeMs,
+                 static_cast<long long>(latenciesUs.size()) * 1000 / RUN_DURATION_MS,
+                 percentile(latenciesUs, 50),
+                 percentile(latenciesUs, 99),
+                 percentile(latenciesUs, 100),
+                 jainIndex(acquisitionCounts),
+                 timeoutCount);
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register the StubPlugin with readers containing cards A and cards B */
+    const int maxResourceCount = *std::max_element(RESOURCE_COUNTS.begin(), RESOURCE_COUNTS.end());
+    auto pluginFactoryBuilder = StubPluginFactoryBuilder::builder();
+    for (int i = 0; i < maxResourceCount; i++) {
+        pluginFactoryBuilder->withStubReader(READER_A_PREFIX + std::to_string(i),
+                                             false,
+                                             StubSmartCard::builder()
+                                                 ->withPowerOnData(HexUtil::toByteArray(ATR_CARD_A))
+                                                  .withProtocol(SAM_PROTOCOL)
+                                                  .build());
+        pluginFactoryBuilder->withStubReader(READER_B_PREFIX + std::to_string(i),
+                                             false,
+                                             StubSmartCard::builder()
+                                                 ->withPowerOnData(HexUtil::toByteArray(ATR_CARD_B))
+                                                  .withProtocol(SAM_PROTOCOL)
+                                                  .build());
+    }
+    std::shared_ptr<Plugin> plugin = smartCardService->registerPlugin(pluginFactoryBuilder->build());
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(GenericExtensionService::getInstance());
+
+    logger->info("=============== " \
+                 "UseCase Resource Service #3: contention benchmark " \
+                 "==================\n");
+    logger->info("= Two profiles (A and B), % ms per combination, service blocking allocation " \
+                 "cycle % ms\n",
+                 RUN_DURATION_MS,
+                 CYCLE_DURATION_MS);
+    logger->info("Allocation | resources per profile | threads | hold time (ms) | " \
+                 "acquisitions/s | latency p50 (us) | p99 (us) | max (us) | fairness | " \
+                 "timeouts\n");
+
+    /* The baseline calling the service directly first, then the allocator */
+    for (const bool isDirect : {true, false}) {
+        for (const int resourceCount : RESOURCE_COUNTS) {
+            for (const int threadCount : THREAD_COUNTS) {
+                for (const int holdTimeMs : HOLD_TIMES_MS) {
+                    run(plugin, isDirect, resourceCount, threadCount, holdTimeMs);
+                }
+            }
+        }
+    }
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}
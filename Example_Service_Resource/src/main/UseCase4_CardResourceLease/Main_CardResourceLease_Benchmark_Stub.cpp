@@ -0,0 +1,332 @@
+/**************************************************************************************************
+ * Copyright (c) 2023 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Calypsonet Terminal Reader */
+#include "CardReader.h"
+#include "ConfigurableCardReader.h"
+
+/* Keyple Core Util */
+#include "HexUtil.h"
+#include "LoggerFactory.h"
+
+/* Keyple Core Service */
+#include "SmartCardService.h"
+#include "SmartCardServiceProvider.h"
+
+/* Keyple Service Resource */
+#include "CardResourceProfileConfigurator.h"
+#include "CardResourceService.h"
+#include "CardResourceServiceProvider.h"
+#include "PluginsConfigurator.h"
+
+/* Keyple Plugin Stub */
+#include "StubPluginFactoryBuilder.h"
+#include "StubSmartCard.h"
+
+/* Keyple Card Generic */
+#include "GenericExtensionService.h"
+
+/* Examples */
+#include "CardResourceAllocator.h"
+#include "CardResourceLeaseManager.h"
+
+using namespace calypsonet::terminal::reader;
+using namespace keyple::card::generic;
+using namespace keyple::core::service;
+using namespace keyple::core::service::resource;
+using namespace keyple::core::service::resource::spi;
+using namespace keyple::core::util;
+using namespace keyple::core::util::cpp;
+using namespace keyple::plugin::stub;
+
+/**
+ * <h1>Use Case "resource service 4" – Card resource leases (Stub)</h1>
+ *
+ * <p>We compare here the cost per transaction of getting and releasing a card resource around
+ * each transaction with the one of a card resource leased by each thread through a
+ * CardResourceLeaseManager, both going through the same CardResourceAllocator.
+ *
+ * <h2>Scenario:</h2>
+ *
+ * <ul>
+ *   <li>Register a Stub plugin with a few readers, each containing a card matching the profile.
+ *   <li>Run empty transactions in one thread, then in as many threads as card resources, first
+ *       with getCardResource/releaseCardResource of the allocator around each transaction, then
+ *       with beginTransaction/endTransaction of a lease manager.
+ *   <li>Let the threads keep all the leases and run transactions of a priority caller, served by
+ *       the revocation of the leases of the idle threads.
+ *   <li>Output the cost per transaction and the revocations.
+ * </ul>
+ *
+ * All results are logged with slf4j.
+ *
+ * <p>Any unexpected behavior will result in runtime exceptions.
+ *
+ * @since 2.0.0
+ */
+class Main_CardResourceLease_Benchmark_Stub {};
+const std::unique_ptr<Logger> logger =
+    LoggerFactory::getLogger(typeid(Main_CardResourceLease_Benchmark_Stub));
+
+static const std::string READER_NAME_PREFIX = "READER_A_";
+static const std::string READER_NAME_REGEX = "READER_A_.*";
+static const std::string ATR_CARD_A = "3B3F9600805A4880C120501711AABBCC829000";
+static const std::string ATR_REGEX_A = "^3B3F9600805A4880C120501711[0-9A-F]{6}829000$";
+static const std::string RESOURCE_A = "RESOURCE_A";
+static const std::string SAM_PROTOCOL = "ISO_7816_3_T0";
+
+static const int RESOURCE_COUNT = 4;
+static const int TRANSACTION_COUNT_PER_THREAD = 2000;
+static const int PRIORITY_TRANSACTION_COUNT = 20;
+static const int IDLE_TIME_MS = 5;
+static const long TIMEOUT_MS = 10000;
+
+/**
+ * Reader configurator used by the card resource service to set up the readers.
+ */
+class ReaderConfigurator : public ReaderConfiguratorSpi {
+public:
+    /**
+     * {@inheritDoc}
+     */
+    void setupReader(std::shared_ptr<CardReader> reader) override
+    {
+        std::dynamic_pointer_cast<ConfigurableCardReader>(reader)
+            ->activateProtocol(SAM_PROTOCOL, SAM_PROTOCOL);
+    }
+};
+
+/**
+ * Returns the p-th percentile (nearest rank) of sorted values, 0 if empty.
+ */
+static long long percentile(const std::vector<long long>& sortedValues, const int p)
+{
+    if (sortedValues.empty()) {
+        return 0;
+    }
+
+    const size_t rank = (p * sortedValues.size() + 99) / 100;
+
+    return sortedValues[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Runs empty transactions in several threads, each transaction getting its card resource from the
+ * allocator or from the lease manager, and logs the cost per transaction.
+ */
+static void run(const std::string& modeName,
+                const int threadCount,
+                std::shared_ptr<CardResourceAllocator> cardResourceAllocator,
+                std::shared_ptr<CardResourceLeaseManager> leaseManager)
+{
+    std::vector<long long> costsNs;
+    int failureCount = 0;
+    std::mutex resultsMutex;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([&]() {
+            std::vector<long long> threadCostsNs;
+            int threadFailureCount = 0;
+
+            for (int j = 0; j < TRANSACTION_COUNT_PER_THREAD; j++) {
+                const auto start = std::chrono::steady_clock::now();
+
+                std::shared_ptr<CardResource> cardResource =
+                    leaseManager != nullptr ?
+                        leaseManager->beginTransaction(TIMEOUT_MS) :
+                        cardResourceAllocator->getCardResource(RESOURCE_A, TIMEOUT_MS);
+                if (cardResource == nullptr) {
+                    threadFailureCount++;
+                    continue;
+                }
+
+                /* The transaction itself would take place here */
+
+                if (leaseManager != nullptr) {
+                    leaseManager->endTransaction();
+                } else {
+                    cardResourceAllocator->releaseCardResource(cardResource);
+                }
+
+                threadCostsNs.push_back(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count());
+            }
+
+            if (leaseManager != nullptr) {
+                leaseManager->releaseLease();
+            }
+
+            const std::lock_guard<std::mutex> lock(resultsMutex);
+            costsNs.insert(costsNs.end(), threadCostsNs.begin(), threadCostsNs.end());
+            failureCount += threadFailureCount;
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::sort(costsNs.begin(), costsNs.end());
+
+    long long totalNs = 0;
+    for (const long long costNs : costsNs) {
+        totalNs += costNs;
+    }
+
+    logger->info("% | % | % | % | % | % | %\n",
+                 modeName,
+                 threadCount,
+                 costsNs.size(),
+                 costsNs.empty() ? 0 : totalNs / static_cast<long long>(costsNs.size()),
+                 percentile(costsNs, 50),
+                 percentile(costsNs, 99),
+                 failureCount);
+}
+
+/**
+ * Lets as many threads as card resources keep all the leases, idle between their transactions,
+ * and runs the transactions of a priority caller.
+ */
+static void runPriorityCaller(std::shared_ptr<CardResourceLeaseManager> leaseManager)
+{
+    std::atomic<bool> isRunning(true);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < RESOURCE_COUNT; i++) {
+        threads.emplace_back([&]() {
+            while (isRunning) {
+                if (leaseManager->beginTransaction(TIMEOUT_MS) != nullptr) {
+                    leaseManager->endTransaction();
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_TIME_MS));
+            }
+            leaseManager->releaseLease();
+        });
+    }
+
+    /* Let the threads take all the leases */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::vector<long long> waitingTimesUs;
+    for (int i = 0; i < PRIORITY_TRANSACTION_COUNT; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        if (leaseManager->beginTransaction(TIMEOUT_MS, true) != nullptr) {
+            waitingTimesUs.push_back(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+            leaseManager->endTransaction();
+        }
+
+        /* Release the lease so that the next transaction needs a card resource again */
+        leaseManager->releaseLease();
+        std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_TIME_MS));
+    }
+
+    isRunning = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::sort(waitingTimesUs.begin(), waitingTimesUs.end());
+
+    logger->info("Priority caller: % transactions out of %, waiting time p50: % us, max: % us, " \
+                 "leases revoked: %\n",
+                 waitingTimesUs.size(),
+                 PRIORITY_TRANSACTION_COUNT,
+                 percentile(waitingTimesUs, 50),
+                 percentile(waitingTimesUs, 100),
+                 leaseManager->getRevocationCount());
+}
+
+int main()
+{
+    /* Get the instance of the SmartCardService (singleton pattern) */
+    std::shared_ptr<SmartCardService> smartCardService = SmartCardServiceProvider::getService();
+
+    /* Register the StubPlugin with readers containing a card matching the profile */
+    auto pluginFactoryBuilder = StubPluginFactoryBuilder::builder();
+    for (int i = 0; i < RESOURCE_COUNT; i++) {
+        pluginFactoryBuilder->withStubReader(READER_NAME_PREFIX + std::to_string(i),
+                                             false,
+                                             StubSmartCard::builder()
+                                                 ->withPowerOnData(HexUtil::toByteArray(ATR_CARD_A))
+                                                  .withProtocol(SAM_PROTOCOL)
+                                                  .build());
+    }
+    std::shared_ptr<Plugin> plugin =
+        smartCardService->registerPlugin(pluginFactoryBuilder->build());
+
+    /* Verify that the extension's API level is consistent with the current service */
+    smartCardService->checkCardExtension(GenericExtensionService::getInstance());
+
+    /* Configure the card resource service in non-blocking allocation mode */
+    std::shared_ptr<GenericCardSelection> cardSelection =
+        GenericExtensionService::getInstance()->createCardSelection();
+    cardSelection->filterByPowerOnData(ATR_REGEX_A);
+
+    std::shared_ptr<CardResourceService> cardResourceService =
+        CardResourceServiceProvider::getService();
+
+    cardResourceService->getConfigurator()
+        ->withPlugins(PluginsConfigurator::builder()
+                          ->addPlugin(plugin, std::make_shared<ReaderConfigurator>())
+                           .build())
+         .withCardResourceProfiles(
+             {CardResourceProfileConfigurator::builder(
+                  RESOURCE_A,
+                  GenericExtensionService::getInstance()->createCardResourceProfileExtension(
+                      cardSelection))
+                  ->withReaderNameRegex(READER_NAME_REGEX)
+                   .build()})
+         .configure();
+    cardResourceService->start();
+
+    logger->info("=============== " \
+                 "UseCase Resource Service #4: card resource leases " \
+                 "==================\n");
+    logger->info("= % resources, % transactions per thread\n",
+                 RESOURCE_COUNT,
+                 TRANSACTION_COUNT_PER_THREAD);
+    logger->info("Mode | threads | transactions | cost mean (ns) | p50 (ns) | p99 (ns) | " \
+                 "failures\n");
+
+    auto cardResourceAllocator = std::make_shared<CardResourceAllocator>(cardResourceService);
+
+    for (const int threadCount : {1, RESOURCE_COUNT}) {
+        run("Get/release", threadCount, cardResourceAllocator, nullptr);
+        run("Lease",
+            threadCount,
+            cardResourceAllocator,
+            std::make_shared<CardResourceLeaseManager>(cardResourceAllocator, RESOURCE_A));
+    }
+
+    runPriorityCaller(
+        std::make_shared<CardResourceLeaseManager>(cardResourceAllocator, RESOURCE_A));
+
+    cardResourceService->stop();
+
+    /* Unregister plugin */
+    smartCardService->unregisterPlugin(plugin->getName());
+
+    logger->info("Exit program\n");
+
+    return 0;
+}